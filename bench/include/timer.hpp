@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+class Timer {
+public:
+	using clock = std::chrono::steady_clock;
+
+	Timer()
+		: start(clock::now()) {}
+
+	double elapsed_ms() const {
+		return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	}
+
+	void reset() { start = clock::now(); }
+private:
+	clock::time_point start;
+};
+
+template <class F>
+double time_ms(F&& f) {
+	Timer timer;
+	f();
+	return timer.elapsed_ms();
+}
+
+// Problem sizes come from the command line so that the same binary can be used to
+// sweep small and very large inputs, e.g. `bulk_insert_bench 1000000 10000000`
+inline std::vector<std::size_t> sizes_from_args(int argc, char** argv, std::vector<std::size_t> defaults) {
+	if (argc <= 1)
+		return defaults;
+	std::vector<std::size_t> sizes;
+	for (int i = 1; i < argc; ++i)
+		sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+	return sizes;
+}
+
+// Prevents the optimizer from discarding a computed value
+template <class T>
+void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r"(&value) : "memory");
+#else
+	static const volatile T* volatile sink;
+	sink = &value;
+#endif
+}
@@ -0,0 +1,60 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/augmented_flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using augmented_map_t = ancillary::augmented_flat_map<key_type, key_type>;
+
+const std::size_t queries = 100000;
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 10000, 100000, 1000000, 10000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(18) << "scan sum ns" << std::setw(22) << "aggregate ns"
+		<< std::setw(18) << "assign ns" << std::setw(18) << "reindex ms" << '\n';
+	for (auto n : sizes) {
+		// Time-bucketed style keys: one per second, queried over windows of a tenth of the map
+		std::vector<std::pair<key_type, key_type>> pairs(n);
+		for (std::size_t i = 0; i < n; ++i)
+			pairs[i] = { i, gen() % 1000 };
+		map_t map(ancillary::sorted_unique, pairs.begin(), pairs.end());
+		augmented_map_t augmented(map);
+		double reindex = time_ms([&] { augmented.reindex(); });
+
+		std::vector<std::pair<key_type, key_type>> windows(queries);
+		std::uniform_int_distribution<key_type> start(0, n - n / 10);
+		for (auto& window : windows) {
+			window.first = start(gen);
+			window.second = window.first + n / 10;
+		}
+
+		key_type sum = 0;
+		double scan = time_ms([&] {
+			for (const auto& [lo, hi] : windows)
+				for (auto it = map.lower_bound(lo), last = map.lower_bound(hi); it != last; ++it)
+					sum += it->second;
+		});
+		double aggregate = time_ms([&] {
+			for (const auto& [lo, hi] : windows)
+				sum -= augmented.aggregate(lo, hi);
+		});
+		if (sum != 0)
+			std::cerr << "Aggregates disagree with the scans!\n";
+
+		double assign = time_ms([&] {
+			for (const auto& window : windows)
+				augmented.insert_or_assign(window.first, window.second);
+		});
+
+		std::cout << std::setw(12) << n << std::setw(18) << scan * 1e6 / queries
+			<< std::setw(22) << aggregate * 1e6 / queries << std::setw(18) << assign * 1e6 / queries
+			<< std::setw(18) << reindex << '\n';
+	}
+}
@@ -0,0 +1,99 @@
+#include <map>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/btree_map.hpp>
+
+using key_type = std::uint64_t;
+using flat_map_t = ancillary::flat_map<key_type, key_type>;
+using btree_map_t = ancillary::btree_map<key_type, key_type>;
+using std_map_t = std::map<key_type, key_type>;
+
+// Inserting or erasing one element at a time in a flat_map is quadratic, so it is only measured up to this size
+const std::size_t element_wise_limit = 200000;
+const std::size_t lookups = 1000000;
+
+struct result {
+	double insert = -1, erase = -1, find = 0, scan = 0;
+};
+
+// Throughputs in millions of operations per second
+template <class Map>
+result measure(const std::vector<key_type>& keys, const std::vector<key_type>& probes, bool element_wise) {
+	result r;
+	Map map;
+	if (element_wise) {
+		double ms = time_ms([&] {
+			for (auto key : keys)
+				map.insert({ key, key });
+		});
+		r.insert = keys.size() / (ms * 1000);
+	}
+	else {
+		std::vector<std::pair<key_type, key_type>> pairs(keys.size());
+		std::transform(keys.begin(), keys.end(), pairs.begin(), [](key_type key) { return std::make_pair(key, key); });
+		map = Map(pairs.begin(), pairs.end());
+	}
+
+	std::size_t hits = 0;
+	double ms = time_ms([&] {
+		for (auto key : probes)
+			hits += map.find(key) != map.end();
+	});
+	do_not_optimize(hits);
+	r.find = probes.size() / (ms * 1000);
+
+	key_type sum = 0;
+	ms = time_ms([&] {
+		for (const auto& element : map)
+			sum += element.second;
+	});
+	do_not_optimize(sum);
+	r.scan = map.size() / (ms * 1000);
+
+	if (element_wise) {
+		ms = time_ms([&] {
+			for (auto key : keys)
+				map.erase(key);
+		});
+		r.erase = keys.size() / (ms * 1000);
+	}
+	return r;
+}
+
+void print(const char* name, const result& r) {
+	std::cout << std::setw(12) << name;
+	for (double value : { r.insert, r.erase, r.find, r.scan }) {
+		if (value < 0)
+			std::cout << std::setw(12) << "skipped";
+		else
+			std::cout << std::setw(12) << value;
+	}
+	std::cout << '\n';
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 10000, 100000, 1000000, 10000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(2) << "Throughput in millions of operations per second\n";
+	for (auto n : sizes) {
+		std::vector<key_type> keys(n);
+		for (auto& key : keys)
+			key = gen();
+		std::vector<key_type> probes(lookups);
+		std::uniform_int_distribution<std::size_t> index(0, n - 1);
+		for (auto& probe : probes)
+			probe = keys[index(gen)];
+
+		std::cout << "n = " << n << '\n' << std::setw(12) << "container" << std::setw(12) << "insert"
+			<< std::setw(12) << "erase" << std::setw(12) << "find" << std::setw(12) << "scan" << '\n';
+		print("flat_map", measure<flat_map_t>(keys, probes, n <= element_wise_limit));
+		print("btree_map", measure<btree_map_t>(keys, probes, true));
+		print("std::map", measure<std_map_t>(keys, probes, true));
+	}
+}
@@ -0,0 +1,73 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/buffered_flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using buffered_map_t = ancillary::buffered_flat_map<key_type, key_type>;
+
+// Inserting one element at a time into a flat_map is quadratic, so it is only measured up to this size
+const std::size_t element_wise_limit = 200000;
+const std::size_t lookups = 1000000;
+
+template <class Map>
+double ns_per_insert(const std::vector<key_type>& keys) {
+	Map map;
+	double ms = time_ms([&] {
+		for (auto key : keys)
+			map.insert({ key, key });
+	});
+	do_not_optimize(map.size());
+	return ms * 1e6 / keys.size();
+}
+
+template <class Map>
+double ns_per_lookup(const Map& map, const std::vector<key_type>& probes) {
+	std::size_t hits = 0;
+	double ms = time_ms([&] {
+		for (auto key : probes)
+			hits += map.contains(key);
+	});
+	do_not_optimize(hits);
+	return ms * 1e6 / probes.size();
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 10000, 100000, 1000000, 10000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(18) << "flat insert ns" << std::setw(20) << "buffered insert ns"
+		<< std::setw(18) << "flat lookup ns" << std::setw(20) << "buffered lookup ns" << '\n';
+	for (auto n : sizes) {
+		std::vector<key_type> keys(n);
+		for (auto& key : keys)
+			key = gen();
+
+		std::cout << std::setw(12) << n;
+		if (n <= element_wise_limit)
+			std::cout << std::setw(18) << ns_per_insert<map_t>(keys);
+		else
+			std::cout << std::setw(18) << "skipped";
+		std::cout << std::setw(20) << ns_per_insert<buffered_map_t>(keys);
+
+		// The buffered map is left with whatever is still pending after the inserts
+		std::vector<std::pair<key_type, key_type>> pairs(n);
+		std::transform(keys.begin(), keys.end(), pairs.begin(), [](key_type key) { return std::make_pair(key, key); });
+		map_t map(pairs.begin(), pairs.end());
+		buffered_map_t buffered;
+		for (const auto& pair : pairs)
+			buffered.insert(pair);
+		std::vector<key_type> probes(lookups);
+		std::uniform_int_distribution<std::size_t> index(0, n - 1);
+		for (auto& probe : probes)
+			probe = keys[index(gen)];
+		std::cout << std::setw(18) << ns_per_lookup(map, probes)
+			<< std::setw(20) << ns_per_lookup(buffered, probes) << '\n';
+	}
+}
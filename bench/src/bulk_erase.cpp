@@ -0,0 +1,55 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+
+// Erasing one key at a time is quadratic, so it is only measured up to this many keys
+const std::size_t element_wise_limit = 100000;
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 100000, 1000000, 10000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(12) << "erased" << std::setw(16) << "erase(key) ms"
+		<< std::setw(20) << "erase(sorted) ms" << std::setw(16) << "erase_if ms" << '\n';
+	for (auto n : sizes) {
+		std::vector<std::pair<key_type, key_type>> pairs(n);
+		for (std::size_t i = 0; i < n; ++i)
+			pairs[i] = { gen(), i };
+		const map_t map(pairs.begin(), pairs.end());
+
+		// Expire a tenth of the entries
+		std::vector<key_type> expired;
+		for (const auto& pair : map)
+			if (pair.second % 10 == 0)
+				expired.push_back(pair.first);
+
+		std::cout << std::setw(12) << n << std::setw(12) << expired.size();
+		if (expired.size() <= element_wise_limit) {
+			map_t copy(map);
+			std::cout << std::setw(16) << time_ms([&] {
+				for (auto key : expired)
+					copy.erase(key);
+			});
+		}
+		else
+			std::cout << std::setw(16) << "skipped";
+
+		map_t sorted(map);
+		std::cout << std::setw(20) << time_ms([&] {
+			sorted.erase(ancillary::sorted_unique, expired.begin(), expired.end());
+		});
+		map_t filtered(map);
+		std::cout << std::setw(16) << time_ms([&] {
+			ancillary::erase_if(filtered, [](const auto& pair) { return pair.second % 10 == 0; });
+		}) << '\n';
+		do_not_optimize(sorted.size() + filtered.size());
+	}
+}
@@ -0,0 +1,78 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <numeric>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/flat_multimap.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using multimap_t = ancillary::flat_multimap<key_type, key_type>;
+using pair_t = std::pair<key_type, key_type>;
+
+// The element at a time path is quadratic, so it is only measured up to this size
+const std::size_t element_wise_limit = 100000;
+
+std::vector<pair_t> shuffled_pairs(std::size_t n, std::mt19937_64& gen) {
+	std::vector<pair_t> pairs(n);
+	for (std::size_t i = 0; i < n; ++i)
+		pairs[i] = { i, i };
+	std::shuffle(pairs.begin(), pairs.end(), gen);
+	return pairs;
+}
+
+template <class Map>
+double element_wise(const std::vector<pair_t>& pairs) {
+	return time_ms([&] {
+		Map map;
+		for (const auto& pair : pairs)
+			map.insert(map.cend(), pair);
+		do_not_optimize(map.size());
+	});
+}
+
+template <class Map>
+double bulk(const std::vector<pair_t>& pairs) {
+	return time_ms([&] {
+		Map map(pairs.begin(), pairs.end());
+		do_not_optimize(map.size());
+	});
+}
+
+template <class Map>
+double bulk_into_half(const std::vector<pair_t>& pairs) {
+	Map map(pairs.begin(), pairs.begin() + pairs.size() / 2);
+	return time_ms([&] {
+		map.insert(pairs.begin() + pairs.size() / 2, pairs.end());
+		do_not_optimize(map.size());
+	});
+}
+
+template <class Map>
+void run(const char* name, const std::vector<pair_t>& pairs) {
+	std::cout << std::setw(14) << name << std::setw(12) << pairs.size();
+	if (pairs.size() <= element_wise_limit)
+		std::cout << std::setw(16) << element_wise<Map>(pairs);
+	else
+		std::cout << std::setw(16) << "skipped";
+	std::cout << std::setw(16) << bulk<Map>(pairs)
+		<< std::setw(16) << bulk_into_half<Map>(pairs) << '\n';
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1000000, 10000000, 100000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(14) << "container" << std::setw(12) << "n"
+		<< std::setw(16) << "one-by-one ms" << std::setw(16) << "bulk ms"
+		<< std::setw(16) << "merge half ms" << '\n';
+	for (auto n : sizes) {
+		auto pairs = shuffled_pairs(n, gen);
+		run<map_t>("flat_map", pairs);
+		run<multimap_t>("flat_multimap", pairs);
+	}
+}
@@ -0,0 +1,53 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_multimap.hpp>
+
+using key_type = std::uint64_t;
+using multimap_t = ancillary::flat_multimap<key_type, key_type>;
+
+const std::size_t lookups = 4000000;
+
+template <class F>
+double ns_per_lookup(const std::vector<key_type>& probes, F f) {
+	std::size_t total = 0;
+	double ms = time_ms([&] {
+		for (auto key : probes)
+			total += f(key);
+	});
+	do_not_optimize(total);
+	return ms * 1e6 / probes.size();
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1 << 10, 1 << 16, 1 << 20, 1 << 24 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(22) << "lower+upper ns"
+		<< std::setw(18) << "equal_range ns" << std::setw(10) << "speedup" << '\n';
+	for (auto n : sizes) {
+		// Between zero and three values per key
+		std::vector<std::pair<key_type, key_type>> pairs;
+		std::uniform_int_distribution<key_type> keys(0, n / 2);
+		for (std::size_t i = 0; i < n; ++i)
+			pairs.emplace_back(keys(gen), i);
+		multimap_t multimap(pairs.begin(), pairs.end());
+
+		std::vector<key_type> probes(lookups);
+		for (auto& probe : probes)
+			probe = keys(gen);
+
+		double separate = ns_per_lookup(probes, [&](key_type key) {
+			return multimap.upper_bound(key) - multimap.lower_bound(key);
+		});
+		double fused = ns_per_lookup(probes, [&](key_type key) {
+			auto range = multimap.equal_range(key);
+			return range.second - range.first;
+		});
+		std::cout << std::setw(12) << n << std::setw(22) << separate
+			<< std::setw(18) << fused << std::setw(10) << separate / fused << '\n';
+	}
+}
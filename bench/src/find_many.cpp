@@ -0,0 +1,71 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+
+const std::size_t map_size = 1 << 22;
+const std::size_t total_probes = 4000000;
+
+// Resolves every batch with one find per key
+double ns_per_find(const map_t& map, const std::vector<key_type>& probes, std::size_t batch) {
+	std::vector<map_t::const_iterator> found(batch);
+	std::size_t hits = 0;
+	double ms = time_ms([&] {
+		for (std::size_t i = 0; i + batch <= probes.size(); i += batch) {
+			for (std::size_t j = 0; j < batch; ++j)
+				found[j] = map.find(probes[i + j]);
+			hits += found[batch - 1] != map.end();
+		}
+	});
+	do_not_optimize(hits);
+	return ms * 1e6 / (probes.size() / batch * batch);
+}
+
+double ns_per_find_many(const map_t& map, const std::vector<key_type>& probes, std::size_t batch) {
+	std::vector<map_t::const_iterator> found(batch);
+	std::size_t hits = 0;
+	double ms = time_ms([&] {
+		for (std::size_t i = 0; i + batch <= probes.size(); i += batch) {
+			map.find_many(probes.begin() + i, probes.begin() + i + batch, found.begin());
+			hits += found[batch - 1] != map.end();
+		}
+	});
+	do_not_optimize(hits);
+	return ms * 1e6 / (probes.size() / batch * batch);
+}
+
+int main(int argc, char** argv) {
+	auto batches = sizes_from_args(argc, argv, { 1000, 10000, 100000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::vector<std::pair<key_type, key_type>> pairs(map_size);
+	for (std::size_t i = 0; i < map_size; ++i)
+		pairs[i] = { gen(), i };
+	map_t map(pairs.begin(), pairs.end());
+
+	std::vector<key_type> probes(total_probes);
+	std::uniform_int_distribution<std::size_t> index(0, map_size - 1);
+	for (auto& probe : probes)
+		probe = pairs[index(gen)].first;
+
+	std::cout << "map of " << map.size() << " keys\n" << std::fixed << std::setprecision(1)
+		<< std::setw(10) << "batch" << std::setw(14) << "find ns" << std::setw(16) << "find_many ns"
+		<< std::setw(18) << "sorted find ns" << std::setw(20) << "sorted find_many ns" << '\n';
+	for (auto batch : batches) {
+		double single = ns_per_find(map, probes, batch);
+		double many = ns_per_find_many(map, probes, batch);
+		auto sorted = probes;
+		for (std::size_t i = 0; i + batch <= sorted.size(); i += batch)
+			std::sort(sorted.begin() + i, sorted.begin() + i + batch);
+		double sorted_single = ns_per_find(map, sorted, batch);
+		double sorted_many = ns_per_find_many(map, sorted, batch);
+		std::cout << std::setw(10) << batch << std::setw(14) << single << std::setw(16) << many
+			<< std::setw(18) << sorted_single << std::setw(20) << sorted_many << '\n';
+	}
+}
@@ -0,0 +1,67 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/front_coded_flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<std::string, key_type>;
+using front_coded_map_t = ancillary::front_coded_flat_map<key_type>;
+
+const std::size_t lookups = 1000000;
+
+template <class Map>
+double ns_per_find(const Map& map, const std::vector<std::string>& probes) {
+	std::size_t sum = 0;
+	double ms = time_ms([&] {
+		for (const auto& key : probes)
+			sum += map.find(key)->second;
+	});
+	do_not_optimize(sum);
+	return ms * 1e6 / probes.size();
+}
+
+// URL-like keys with long shared prefixes
+std::string make_url(std::mt19937_64& gen) {
+	static const char* hosts[] = { "https://www.example.com", "https://cdn.example.net", "https://api.example.org" };
+	std::string url = hosts[gen() % 3];
+	url += "/catalog/" + std::to_string(gen() % 64);
+	url += "/products/" + std::to_string(gen() % 4096);
+	url += "/item-" + std::to_string(gen() % 1000000);
+	return url;
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1 << 12, 1 << 16, 1 << 20 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(16) << "flat_map MB" << std::setw(16) << "coded MB"
+		<< std::setw(16) << "flat_map ns" << std::setw(16) << "coded ns" << '\n';
+	for (auto n : sizes) {
+		std::vector<std::pair<std::string, key_type>> pairs(n);
+		for (auto& pair : pairs)
+			pair = { make_url(gen), gen() };
+		map_t map(pairs.begin(), pairs.end());
+		front_coded_map_t coded(map);
+		coded.shrink_to_fit();
+
+		std::size_t map_bytes = map.capacity() * sizeof(map_t::value_type);
+		for (const auto& pair : map)
+			if (pair.first.capacity() > std::string().capacity())
+				map_bytes += pair.first.capacity() + 1;
+		std::size_t coded_bytes = coded.key_bytes() + coded.size() * sizeof(key_type);
+
+		std::vector<std::string> probes(lookups);
+		std::uniform_int_distribution<std::size_t> index(0, n - 1);
+		for (auto& probe : probes)
+			probe = pairs[index(gen)].first;
+
+		std::cout << std::setw(12) << n
+			<< std::setw(16) << map_bytes / 1e6 << std::setw(16) << coded_bytes / 1e6
+			<< std::setw(16) << ns_per_find(map, probes) << std::setw(16) << ns_per_find(coded, probes) << '\n';
+	}
+}
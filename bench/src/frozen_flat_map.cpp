@@ -0,0 +1,56 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/frozen_flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using frozen_map_t = ancillary::frozen_flat_map<key_type, key_type>;
+
+const std::size_t lookups = 4000000;
+
+template <class Map>
+double ns_per_find(const Map& map, const std::vector<key_type>& probes) {
+	key_type sum = 0;
+	double ms = time_ms([&] {
+		for (auto key : probes)
+			sum += map.find(key)->second;
+	});
+	do_not_optimize(sum);
+	return ms * 1e6 / probes.size();
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1 << 10, 1 << 16, 1 << 20, 1 << 24, 50000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(16) << "flat_map ns"
+		<< std::setw(16) << "frozen ns" << std::setw(10) << "speedup" << '\n';
+	for (auto n : sizes) {
+		std::vector<key_type> keys(n);
+		for (auto& key : keys)
+			key = gen();
+		map_t map;
+		{
+			std::vector<std::pair<key_type, key_type>> pairs(n);
+			for (std::size_t i = 0; i < n; ++i)
+				pairs[i] = { keys[i], i };
+			map.insert(pairs.begin(), pairs.end());
+		}
+		frozen_map_t frozen(map);
+
+		std::vector<key_type> probes(lookups);
+		std::uniform_int_distribution<std::size_t> index(0, n - 1);
+		for (auto& probe : probes)
+			probe = keys[index(gen)];
+
+		double flat = ns_per_find(map, probes);
+		double eytzinger = ns_per_find(frozen, probes);
+		std::cout << std::setw(12) << n << std::setw(16) << flat
+			<< std::setw(16) << eytzinger << std::setw(10) << flat / eytzinger << '\n';
+	}
+}
@@ -0,0 +1,84 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/gapped_flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using gapped_map_t = ancillary::gapped_flat_map<key_type, key_type>;
+
+// Inserting one element at a time into a flat_map is quadratic, so it is only measured up to this size
+const std::size_t element_wise_limit = 200000;
+const std::size_t lookups = 1000000;
+
+template <class Map>
+double ns_per_insert(Map& map, const std::vector<key_type>& keys) {
+	double ms = time_ms([&] {
+		for (auto key : keys)
+			map.insert({ key, key });
+	});
+	return ms * 1e6 / keys.size();
+}
+
+template <class Map>
+double ns_per_lookup(const Map& map, const std::vector<key_type>& probes) {
+	std::size_t hits = 0;
+	double ms = time_ms([&] {
+		for (auto key : probes)
+			hits += map.contains(key);
+	});
+	do_not_optimize(hits);
+	return ms * 1e6 / probes.size();
+}
+
+template <class Map>
+double ns_per_scanned(const Map& map) {
+	key_type sum = 0;
+	double ms = time_ms([&] {
+		for (const auto& element : map)
+			sum += element.second;
+	});
+	do_not_optimize(sum);
+	return ms * 1e6 / map.size();
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 10000, 100000, 1000000, 10000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(16) << "flat insert" << std::setw(16) << "gapped insert"
+		<< std::setw(16) << "flat lookup" << std::setw(16) << "gapped lookup"
+		<< std::setw(14) << "flat scan" << std::setw(14) << "gapped scan" << "   (ns per element)\n";
+	for (auto n : sizes) {
+		std::vector<key_type> keys(n);
+		for (auto& key : keys)
+			key = gen();
+		std::vector<key_type> probes(lookups);
+		std::uniform_int_distribution<std::size_t> index(0, n - 1);
+		for (auto& probe : probes)
+			probe = keys[index(gen)];
+
+		std::cout << std::setw(12) << n;
+		map_t map;
+		if (n <= element_wise_limit) {
+			std::cout << std::setw(16) << ns_per_insert(map, keys);
+		}
+		else {
+			std::vector<std::pair<key_type, key_type>> pairs(n);
+			for (std::size_t i = 0; i < n; ++i)
+				pairs[i] = { keys[i], keys[i] };
+			map = map_t(pairs.begin(), pairs.end());
+			std::cout << std::setw(16) << "skipped";
+		}
+		gapped_map_t gapped;
+		std::cout << std::setw(16) << ns_per_insert(gapped, keys)
+			<< std::setw(16) << ns_per_lookup(map, probes)
+			<< std::setw(16) << ns_per_lookup(gapped, probes)
+			<< std::setw(14) << ns_per_scanned(map)
+			<< std::setw(14) << ns_per_scanned(gapped) << '\n';
+	}
+}
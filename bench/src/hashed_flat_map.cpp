@@ -0,0 +1,64 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/hashed_flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using hashed_map_t = ancillary::hashed_flat_map<key_type, key_type>;
+
+const std::size_t queries = 1000000;
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 10000, 1000000, 30000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(18) << "flat find ns" << std::setw(20) << "hashed find ns"
+		<< std::setw(18) << "range ns" << std::setw(18) << "reindex ms" << '\n';
+	for (auto n : sizes) {
+		// Sparse random keys, so neither the search nor the hash sees a dense pattern
+		std::vector<std::pair<key_type, key_type>> pairs(n);
+		for (auto& pair : pairs)
+			pair = { gen(), gen() };
+		map_t map(pairs.begin(), pairs.end());
+		hashed_map_t hashed(map);
+		double reindex = time_ms([&] { hashed.reindex(); });
+
+		// Half the lookups hit
+		std::vector<key_type> keys(queries);
+		for (auto& key : keys)
+			key = gen() % 2 ? map.begin()[gen() % map.size()].first : gen();
+
+		key_type sum = 0;
+		double flat = time_ms([&] {
+			for (auto key : keys) {
+				auto it = map.find(key);
+				sum += it == map.end() ? 0 : it->second;
+			}
+		});
+		double hashed_find = time_ms([&] {
+			for (auto key : keys) {
+				auto it = hashed.find(key);
+				sum -= it == hashed.end() ? 0 : it->second;
+			}
+		});
+		if (sum != 0)
+			std::cerr << "Lookups disagree!\n";
+
+		// Range queries still walk the sorted storage
+		double range = time_ms([&] {
+			for (auto key : keys)
+				for (auto it = hashed.lower_bound(key), last = std::next(it, std::min<std::ptrdiff_t>(8, hashed.end() - it)); it != last; ++it)
+					sum += it->second;
+		});
+		do_not_optimize(sum);
+
+		std::cout << std::setw(12) << n << std::setw(18) << flat * 1e6 / queries
+			<< std::setw(20) << hashed_find * 1e6 / queries << std::setw(18) << range * 1e6 / queries
+			<< std::setw(18) << reindex << '\n';
+	}
+}
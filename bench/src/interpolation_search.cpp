@@ -0,0 +1,103 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_set.hpp>
+#include <ancillary/container/flat_map.hpp>
+
+using key_type = std::uint64_t;
+
+template <class Search>
+using set_t = ancillary::flat_set<key_type, std::less<key_type>, std::allocator<key_type>, Search>;
+
+template <class Search>
+using map_t = ancillary::flat_map<key_type, key_type, std::less<key_type>,
+	std::allocator<std::pair<key_type, key_type>>, Search>;
+
+const std::size_t lookups = 4000000;
+
+// Keys spread evenly over the whole 64 bit range
+key_type uniform_key(std::mt19937_64& gen) {
+	return gen();
+}
+
+// Keys whose logarithm is uniform, so small keys are far denser than large ones
+key_type zipfian_key(std::mt19937_64& gen) {
+	std::uniform_real_distribution<double> exponent(0.0, 63.0);
+	return static_cast<key_type>(std::exp2(exponent(gen)));
+}
+
+// Keys packed tightly around a thousand random centres
+key_type clustered_key(std::mt19937_64& gen) {
+	static const std::vector<key_type> centres = [] {
+		std::mt19937_64 seed{ 7 };
+		std::vector<key_type> c(1000);
+		for (auto& centre : c)
+			centre = seed() >> 1;
+		return c;
+	}();
+	std::normal_distribution<double> offset(0.0, 1e6);
+	return centres[gen() % centres.size()] + static_cast<key_type>(std::abs(offset(gen)));
+}
+
+template <class Container, class Elements>
+double ns_per_lookup(const Elements& elements, const std::vector<key_type>& probes) {
+	Container container(ancillary::sorted_unique, elements.begin(), elements.end());
+	std::size_t hits = 0;
+	double ms = time_ms([&] {
+		for (auto key : probes)
+			hits += container.contains(key);
+	});
+	do_not_optimize(hits);
+	return ms * 1e6 / probes.size();
+}
+
+template <template <class> class Container, class Elements>
+void run(const char* name, const char* distribution, const Elements& elements, const std::vector<key_type>& probes) {
+	double binary = ns_per_lookup<Container<ancillary::binary_search_policy>>(elements, probes);
+	double branchless = ns_per_lookup<Container<ancillary::branchless_search_policy>>(elements, probes);
+	double interpolation = ns_per_lookup<Container<ancillary::interpolation_search_policy>>(elements, probes);
+	std::cout << std::setw(10) << name << std::setw(12) << distribution << std::setw(12) << elements.size()
+		<< std::setw(12) << binary << std::setw(16) << branchless << std::setw(18) << interpolation
+		<< std::setw(10) << binary / interpolation << '\n';
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1 << 12, 1 << 16, 1 << 20, 1 << 24 });
+	std::mt19937_64 gen{ 42 };
+	std::pair<const char*, std::function<key_type(std::mt19937_64&)>> distributions[] = {
+		{ "uniform", uniform_key },
+		{ "zipfian", zipfian_key },
+		{ "clustered", clustered_key }
+	};
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(10) << "container" << std::setw(12) << "keys" << std::setw(12) << "n"
+		<< std::setw(12) << "binary ns" << std::setw(16) << "branchless ns" << std::setw(18) << "interpolation ns" << std::setw(10) << "speedup" << '\n';
+	for (auto n : sizes) {
+		for (const auto& [name, draw] : distributions) {
+			std::vector<key_type> keys(n);
+			for (auto& key : keys)
+				key = draw(gen);
+			std::sort(keys.begin(), keys.end());
+			keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+			// Half of the probes hit, half are drawn from the same distribution
+			std::vector<key_type> probes(lookups);
+			std::uniform_int_distribution<std::size_t> index(0, keys.size() - 1);
+			for (std::size_t i = 0; i < probes.size(); ++i)
+				probes[i] = i % 2 ? keys[index(gen)] : draw(gen);
+
+			std::vector<std::pair<key_type, key_type>> pairs(keys.size());
+			for (std::size_t i = 0; i < keys.size(); ++i)
+				pairs[i] = { keys[i], i };
+
+			run<set_t>("flat_set", name, keys, probes);
+			run<map_t>("flat_map", name, pairs, probes);
+		}
+	}
+}
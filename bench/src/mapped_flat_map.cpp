@@ -0,0 +1,60 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <filesystem>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/mapped_flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using mapped_map_t = ancillary::mapped_flat_map<key_type, key_type>;
+
+const std::size_t lookups = 1000000;
+
+template <class Map>
+double ns_per_find(const Map& map, const std::vector<key_type>& probes) {
+	std::size_t sum = 0;
+	double ms = time_ms([&] {
+		for (auto key : probes)
+			sum += (*map.find(key)).second;
+	});
+	do_not_optimize(sum);
+	return ms * 1e6 / probes.size();
+}
+
+// Compares building a table from unsorted records at startup with opening a table
+// written ahead of time. The first lookups of the mapped table pay for the page faults.
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1 << 14, 1 << 18, 1 << 22 });
+	std::mt19937_64 gen{ 42 };
+	auto path = (std::filesystem::temp_directory_path() / "ancillary_mapped_flat_map_bench.bin").string();
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< std::setw(12) << "n" << std::setw(14) << "build ms" << std::setw(14) << "open ms"
+		<< std::setw(16) << "flat_map ns" << std::setw(16) << "mapped ns" << '\n';
+	for (auto n : sizes) {
+		std::vector<std::pair<key_type, key_type>> pairs(n);
+		for (auto& pair : pairs)
+			pair = { gen(), gen() };
+
+		map_t map;
+		double build = time_ms([&] { map = map_t(pairs.begin(), pairs.end()); });
+		ancillary::write_mapped(map, path);
+
+		mapped_map_t mapped;
+		double open = time_ms([&] { mapped = mapped_map_t(path); });
+
+		std::vector<key_type> probes(lookups);
+		std::uniform_int_distribution<std::size_t> index(0, n - 1);
+		for (auto& probe : probes)
+			probe = pairs[index(gen)].first;
+
+		double mapped_ns = ns_per_find(mapped, probes);
+		double flat_ns = ns_per_find(map, probes);
+		std::cout << std::setw(12) << n << std::setw(14) << build << std::setw(14) << open
+			<< std::setw(16) << flat_ns << std::setw(16) << mapped_ns << '\n';
+	}
+	std::filesystem::remove(path);
+}
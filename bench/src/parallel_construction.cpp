@@ -0,0 +1,71 @@
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/flat_multimap.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using multimap_t = ancillary::flat_multimap<key_type, key_type>;
+using pair_t = std::pair<key_type, key_type>;
+
+// Random keys, so that the unique containers also have some duplicates to drop
+std::vector<pair_t> random_pairs(std::size_t n, std::mt19937_64& gen) {
+	std::uniform_int_distribution<key_type> dist(0, 4 * n);
+	std::vector<pair_t> pairs(n);
+	for (std::size_t i = 0; i < n; ++i)
+		pairs[i] = { dist(gen), i };
+	return pairs;
+}
+
+template <class Map>
+double sequential(const std::vector<pair_t>& pairs) {
+	return time_ms([&] {
+		Map map(pairs.begin(), pairs.end());
+		do_not_optimize(map.size());
+	});
+}
+
+template <class Map>
+double parallel(const std::vector<pair_t>& pairs, std::size_t threads) {
+	return time_ms([&] {
+		Map map(ancillary::execution::parallel_policy{ threads }, pairs.begin(), pairs.end());
+		do_not_optimize(map.size());
+	});
+}
+
+template <class Map>
+void run(const char* name, const std::vector<pair_t>& pairs, const std::vector<std::size_t>& threads) {
+	double base = sequential<Map>(pairs);
+	std::cout << std::setw(14) << name << std::setw(12) << pairs.size()
+		<< std::setw(10) << "seq" << std::setw(14) << base << std::setw(10) << 1.0 << '\n';
+	for (auto t : threads) {
+		double ms = parallel<Map>(pairs, t);
+		std::cout << std::setw(14) << name << std::setw(12) << pairs.size()
+			<< std::setw(10) << t << std::setw(14) << ms << std::setw(10) << base / ms << '\n';
+	}
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1000000, 10000000, 100000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::vector<std::size_t> threads;
+	for (std::size_t t = 1, hardware = ancillary::execution::par.concurrency(); t < hardware; t *= 2)
+		threads.push_back(t);
+	threads.push_back(ancillary::execution::par.concurrency());
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(14) << "container" << std::setw(12) << "n"
+		<< std::setw(10) << "threads" << std::setw(14) << "build ms"
+		<< std::setw(10) << "speedup" << '\n';
+	for (auto n : sizes) {
+		auto pairs = random_pairs(n, gen);
+		run<map_t>("flat_map", pairs, threads);
+		run<multimap_t>("flat_multimap", pairs, threads);
+	}
+}
@@ -0,0 +1,70 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_set.hpp>
+#include <ancillary/container/flat_map.hpp>
+
+using key_type = std::uint64_t;
+
+template <class Search>
+using set_t = ancillary::flat_set<key_type, std::less<key_type>, std::allocator<key_type>, Search>;
+
+template <class Search>
+using map_t = ancillary::flat_map<key_type, key_type, std::less<key_type>,
+	std::allocator<std::pair<key_type, key_type>>, Search>;
+
+const std::size_t lookups = 4000000;
+
+template <class Container, class Elements>
+double ns_per_lookup(const Elements& elements, const std::vector<key_type>& probes) {
+	Container container(ancillary::sorted_unique, elements.begin(), elements.end());
+	std::size_t hits = 0;
+	double ms = time_ms([&] {
+		for (auto key : probes)
+			hits += container.contains(key);
+	});
+	do_not_optimize(hits);
+	return ms * 1e6 / probes.size();
+}
+
+template <template <class> class Container, class Elements>
+void run(const char* name, const Elements& elements, const std::vector<key_type>& probes) {
+	double branchy = ns_per_lookup<Container<ancillary::binary_search_policy>>(elements, probes);
+	double branchless = ns_per_lookup<Container<ancillary::branchless_search_policy>>(elements, probes);
+	std::cout << std::setw(10) << name << std::setw(12) << elements.size()
+		<< std::setw(12) << elements.size() * sizeof(elements[0]) / 1024
+		<< std::setw(14) << branchy << std::setw(14) << branchless << std::setw(10) << branchy / branchless << '\n';
+}
+
+int main(int argc, char** argv) {
+	// From L1 resident (4 KiB of keys) to far larger than the last level cache
+	auto sizes = sizes_from_args(argc, argv, { 1 << 9, 1 << 12, 1 << 15, 1 << 18, 1 << 21, 1 << 24, 1 << 26 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(10) << "container" << std::setw(12) << "n" << std::setw(12) << "data KiB"
+		<< std::setw(14) << "branchy ns" << std::setw(14) << "branchless ns" << std::setw(10) << "speedup" << '\n';
+	for (auto n : sizes) {
+		std::vector<key_type> keys(n);
+		for (auto& key : keys)
+			key = gen();
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+		// Half of the probes hit, half miss
+		std::vector<key_type> probes(lookups);
+		std::uniform_int_distribution<std::size_t> index(0, keys.size() - 1);
+		for (std::size_t i = 0; i < probes.size(); ++i)
+			probes[i] = i % 2 ? keys[index(gen)] : gen();
+
+		std::vector<std::pair<key_type, key_type>> pairs(keys.size());
+		for (std::size_t i = 0; i < keys.size(); ++i)
+			pairs[i] = { keys[i], i };
+
+		run<set_t>("flat_set", keys, probes);
+		run<map_t>("flat_map", pairs, probes);
+	}
+}
@@ -0,0 +1,65 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using pair_t = std::pair<key_type, key_type>;
+
+map_t random_map(std::size_t n, std::mt19937_64& gen) {
+	std::vector<pair_t> pairs(n);
+	for (auto& pair : pairs)
+		pair = { gen() % (4 * n + 1), gen() };
+	return map_t(pairs.begin(), pairs.end());
+}
+
+// Merging a map into another through the range insert the library had before
+double range_insert(const map_t& lhs, const map_t& rhs) {
+	map_t result(lhs);
+	return time_ms([&] {
+		result.insert(rhs.begin(), rhs.end());
+		do_not_optimize(result.size());
+	});
+}
+
+double merge(const map_t& lhs, const map_t& rhs) {
+	map_t result(lhs), other(rhs);
+	return time_ms([&] {
+		result.merge(other);
+		do_not_optimize(result.size());
+	});
+}
+
+template <class F>
+double timed(F f) {
+	return time_ms([&] {
+		auto result = f();
+		do_not_optimize(result.size());
+	});
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 100000, 1000000, 10000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(10) << "m" << std::setw(14) << "insert ms"
+		<< std::setw(12) << "merge ms" << std::setw(12) << "union ms"
+		<< std::setw(16) << "intersect ms" << std::setw(12) << "diff ms" << '\n';
+	for (auto n : sizes) {
+		auto lhs = random_map(n, gen);
+		for (auto m : { n, n / 1000 }) {
+			auto rhs = random_map(m, gen);
+			std::cout << std::setw(12) << n << std::setw(10) << m
+				<< std::setw(14) << range_insert(lhs, rhs)
+				<< std::setw(12) << merge(lhs, rhs)
+				<< std::setw(12) << timed([&] { return ancillary::set_union(lhs, rhs); })
+				<< std::setw(16) << timed([&] { return ancillary::set_intersection(lhs, rhs); })
+				<< std::setw(12) << timed([&] { return ancillary::set_difference(rhs, lhs); }) << '\n';
+		}
+	}
+}
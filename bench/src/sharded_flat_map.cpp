@@ -0,0 +1,64 @@
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/sharded_flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using sharded_map_t = ancillary::sharded_flat_map<key_type, key_type>;
+
+const std::size_t inserts = 1 << 20;
+
+// Splits `inserts` random insertions over the given number of threads and
+// returns the throughput in insertions per microsecond
+template <class Insert>
+double inserts_per_us(std::size_t threads, Insert insert) {
+	std::vector<std::vector<key_type>> keys(threads);
+	std::mt19937_64 gen{ 42 };
+	for (auto& part : keys) {
+		part.resize(inserts / threads);
+		for (auto& key : part)
+			key = gen();
+	}
+	double ms = time_ms([&] {
+		std::vector<std::thread> workers;
+		for (std::size_t t = 0; t < threads; ++t) {
+			workers.emplace_back([&, t] {
+				for (auto key : keys[t])
+					insert(key);
+			});
+		}
+		for (auto& worker : workers)
+			worker.join();
+	});
+	return inserts / (ms * 1000);
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1, 2, 4, 8, 16 });
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< std::setw(10) << "threads" << std::setw(22) << "locked inserts/us"
+		<< std::setw(22) << "sharded inserts/us" << '\n';
+	for (auto threads : sizes) {
+		map_t locked_map;
+		std::mutex mutex;
+		double locked = inserts_per_us(threads, [&](key_type key) {
+			std::lock_guard<std::mutex> lock(mutex);
+			locked_map.try_emplace(key, key);
+		});
+
+		sharded_map_t sharded_map;
+		double sharded = inserts_per_us(threads, [&](key_type key) {
+			sharded_map.try_emplace(key, key);
+		});
+
+		std::cout << std::setw(10) << threads << std::setw(22) << locked
+			<< std::setw(22) << sharded << '\n';
+	}
+}
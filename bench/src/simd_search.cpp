@@ -0,0 +1,68 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/flat_set.hpp>
+
+using key_type = std::uint64_t;
+
+// Equivalent to std::less but hides the ordering from the vectorized search
+struct plain_less {
+	bool operator()(key_type lhs, key_type rhs) const { return lhs < rhs; }
+};
+
+template <class Compare, class Search>
+using set_t = ancillary::flat_set<key_type, Compare, std::allocator<key_type>, Search>;
+
+template <class Compare, class Search>
+using map_t = ancillary::flat_map<key_type, key_type, Compare, std::allocator<std::pair<key_type, key_type>>, Search>;
+
+const std::size_t lookups = 4000000;
+
+template <class Set, class Value>
+double ns_per_find(const std::vector<Value>& values, const std::vector<key_type>& probes) {
+	Set set(ancillary::sorted_unique, values.begin(), values.end());
+	std::size_t hits = 0;
+	double ms = time_ms([&] {
+		for (auto key : probes)
+			hits += set.find(key) != set.end();
+	});
+	do_not_optimize(hits);
+	return ms * 1e6 / probes.size();
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1 << 6, 1 << 9, 1 << 12, 1 << 15, 1 << 18, 1 << 21, 1 << 24 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(14) << "branchy ns" << std::setw(16) << "branchless ns"
+		<< std::setw(14) << "simd ns" << std::setw(18) << "map branchy ns" << std::setw(20) << "map branchless ns"
+		<< std::setw(14) << "map simd ns" << '\n';
+	for (auto n : sizes) {
+		std::vector<key_type> keys(n);
+		for (auto& key : keys)
+			key = gen();
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+		std::vector<std::pair<key_type, key_type>> pairs(keys.size());
+		for (std::size_t i = 0; i < keys.size(); ++i)
+			pairs[i] = { keys[i], i };
+
+		std::vector<key_type> probes(lookups);
+		std::uniform_int_distribution<std::size_t> index(0, keys.size() - 1);
+		for (std::size_t i = 0; i < probes.size(); ++i)
+			probes[i] = i % 2 ? keys[index(gen)] : gen();
+
+		std::cout << std::setw(12) << n
+			<< std::setw(14) << ns_per_find<set_t<plain_less, ancillary::binary_search_policy>>(keys, probes)
+			<< std::setw(16) << ns_per_find<set_t<plain_less, ancillary::branchless_search_policy>>(keys, probes)
+			<< std::setw(14) << ns_per_find<set_t<std::less<key_type>, ancillary::binary_search_policy>>(keys, probes)
+			<< std::setw(18) << ns_per_find<map_t<plain_less, ancillary::binary_search_policy>>(pairs, probes)
+			<< std::setw(20) << ns_per_find<map_t<plain_less, ancillary::branchless_search_policy>>(pairs, probes)
+			<< std::setw(14) << ns_per_find<map_t<std::less<key_type>, ancillary::binary_search_policy>>(pairs, probes) << '\n';
+	}
+}
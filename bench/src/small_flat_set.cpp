@@ -0,0 +1,50 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_set.hpp>
+#include <ancillary/container/small_flat_set.hpp>
+
+using key_type = std::uint64_t;
+
+const std::size_t objects = 1000000;
+
+// Builds one set per object, each from `elements` random keys, then looks every key up
+template <class Set>
+void run(const char* name, std::size_t elements, const std::vector<key_type>& keys) {
+	std::vector<Set> sets(objects);
+	double build = time_ms([&] {
+		for (std::size_t i = 0; i < objects; ++i)
+			for (std::size_t j = 0; j < elements; ++j)
+				sets[i].insert(keys[i * elements + j]);
+	});
+	std::size_t hits = 0;
+	double lookup = time_ms([&] {
+		for (std::size_t i = 0; i < objects; ++i)
+			for (std::size_t j = 0; j < elements; ++j)
+				hits += sets[i].contains(keys[i * elements + j]);
+	});
+	do_not_optimize(hits);
+	double destroy = time_ms([&] { std::vector<Set>().swap(sets); });
+	std::cout << std::setw(20) << name << std::setw(10) << elements << std::setw(10) << sizeof(Set)
+		<< std::setw(12) << build << std::setw(12) << lookup << std::setw(12) << destroy << '\n';
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1, 4, 8, 16, 32 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(20) << "container" << std::setw(10) << "elements" << std::setw(10) << "bytes"
+		<< std::setw(12) << "build ms" << std::setw(12) << "lookup ms" << std::setw(12) << "destroy ms" << '\n';
+	for (auto n : sizes) {
+		std::vector<key_type> keys(objects * n);
+		for (auto& key : keys)
+			key = gen();
+		run<ancillary::flat_set<key_type>>("flat_set", n, keys);
+		run<ancillary::small_flat_set<key_type, 4>>("small_flat_set<4>", n, keys);
+		run<ancillary::small_flat_set<key_type, 8>>("small_flat_set<8>", n, keys);
+		run<ancillary::small_flat_set<key_type, 16>>("small_flat_set<16>", n, keys);
+	}
+}
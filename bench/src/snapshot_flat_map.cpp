@@ -0,0 +1,109 @@
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <shared_mutex>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/snapshot_flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, key_type>;
+using snapshot_map_t = ancillary::snapshot_flat_map<key_type, key_type>;
+
+const std::size_t entries = 1 << 16;
+const std::size_t batch = 64;
+const double run_ms = 500;
+
+struct result {
+	double reads_per_us;
+	std::size_t writes;
+};
+
+// Runs `readers` threads calling read(key) in a loop next to one writer calling
+// write(keys) with batches of fresh keys, for run_ms milliseconds
+template <class Read, class Write>
+result run(std::size_t readers, Read read, Write write) {
+	std::atomic<bool> done{ false };
+	std::atomic<std::size_t> reads{ 0 };
+	std::vector<std::thread> threads;
+	for (std::size_t r = 0; r < readers; ++r) {
+		threads.emplace_back([&, r] {
+			std::mt19937_64 gen{ r };
+			std::size_t count = 0, sum = 0;
+			while (!done.load(std::memory_order_relaxed)) {
+				for (int i = 0; i < 256; ++i)
+					sum += read(2 * (gen() % entries));
+				count += 256;
+			}
+			do_not_optimize(sum);
+			reads += count;
+		});
+	}
+
+	std::size_t writes = 0;
+	std::mt19937_64 gen{ 42 };
+	Timer timer;
+	while (timer.elapsed_ms() < run_ms) {
+		std::vector<key_type> keys(batch);
+		for (auto& key : keys)
+			key = 2 * (gen() % entries) + 1;
+		write(keys);
+		++writes;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	done = true;
+	for (auto& thread : threads)
+		thread.join();
+	return { reads / (timer.elapsed_ms() * 1000), writes };
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1, 2, 4, 8, 16 });
+
+	map_t initial;
+	for (key_type i = 0; i < entries; ++i)
+		initial.try_emplace(2 * i, i);
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(10) << "readers" << std::setw(22) << "shared_mutex reads/us"
+		<< std::setw(18) << "snapshot reads/us" << std::setw(18) << "mutex writes"
+		<< std::setw(18) << "snapshot writes" << '\n';
+	for (auto readers : sizes) {
+		map_t locked_map(initial);
+		std::shared_mutex mutex;
+		auto locked = run(readers,
+			[&](key_type key) {
+				std::shared_lock<std::shared_mutex> lock(mutex);
+				return locked_map.find(key)->second;
+			},
+			[&](const std::vector<key_type>& keys) {
+				std::unique_lock<std::shared_mutex> lock(mutex);
+				for (auto key : keys)
+					locked_map.insert_or_assign(key, key);
+				for (auto key : keys)
+					locked_map.erase(key);
+			});
+
+		snapshot_map_t snapshot_map(initial);
+		auto snapshot = run(readers,
+			[&](key_type key) {
+				return snapshot_map.read()->find(key)->second;
+			},
+			[&](const std::vector<key_type>& keys) {
+				snapshot_map.update([&](map_t& map) {
+					for (auto key : keys)
+						map.insert_or_assign(key, key);
+					for (auto key : keys)
+						map.erase(key);
+				});
+			});
+
+		std::cout << std::setw(10) << readers << std::setw(22) << locked.reads_per_us
+			<< std::setw(18) << snapshot.reads_per_us << std::setw(18) << locked.writes
+			<< std::setw(18) << snapshot.writes << '\n';
+	}
+}
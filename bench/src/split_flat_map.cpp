@@ -0,0 +1,55 @@
+#include <array>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/split_flat_map.hpp>
+
+using key_type = std::uint64_t;
+using payload_t = std::array<char, 200>;
+using map_t = ancillary::flat_map<key_type, payload_t>;
+using split_map_t = ancillary::split_flat_map<key_type, payload_t>;
+
+const std::size_t lookups = 2000000;
+
+template <class Map>
+double ns_per_find(const Map& map, const std::vector<key_type>& probes) {
+	std::size_t sum = 0;
+	double ms = time_ms([&] {
+		for (auto key : probes)
+			sum += map.find(key)->second[0];
+	});
+	do_not_optimize(sum);
+	return ms * 1e6 / probes.size();
+}
+
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1 << 10, 1 << 14, 1 << 18, 1 << 21 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "n" << std::setw(16) << "flat_map ns"
+		<< std::setw(16) << "split ns" << std::setw(10) << "speedup" << '\n';
+	for (auto n : sizes) {
+		std::vector<std::pair<key_type, payload_t>> pairs(n);
+		for (auto& pair : pairs) {
+			pair.first = gen();
+			pair.second.fill(static_cast<char>(pair.first));
+		}
+		map_t map(pairs.begin(), pairs.end());
+		split_map_t split(pairs.begin(), pairs.end());
+
+		std::vector<key_type> probes(lookups);
+		std::uniform_int_distribution<std::size_t> index(0, n - 1);
+		for (auto& probe : probes)
+			probe = pairs[index(gen)].first;
+
+		double flat = ns_per_find(map, probes);
+		double soa = ns_per_find(split, probes);
+		std::cout << std::setw(12) << n << std::setw(16) << flat
+			<< std::setw(16) << soa << std::setw(10) << flat / soa << '\n';
+	}
+}
@@ -0,0 +1,44 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iomanip>
+#include "../include/timer.hpp"
+#include <ancillary/container/flat_map.hpp>
+
+using key_type = std::uint64_t;
+using map_t = ancillary::flat_map<key_type, std::uint64_t>;
+
+const std::size_t operations = 4000000;
+
+// Counting keys drawn from a fixed universe, so most upserts hit an existing key
+int main(int argc, char** argv) {
+	auto sizes = sizes_from_args(argc, argv, { 1000, 100000, 1000000 });
+	std::mt19937_64 gen{ 42 };
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< std::setw(12) << "keys" << std::setw(18) << "operator[] ns"
+		<< std::setw(18) << "try_emplace ns" << std::setw(22) << "insert_or_assign ns" << '\n';
+	for (auto n : sizes) {
+		std::vector<key_type> keys(operations);
+		std::uniform_int_distribution<key_type> dist(0, n - 1);
+		for (auto& key : keys)
+			key = dist(gen) * 0x9E3779B97F4A7C15ull;
+
+		map_t counters;
+		double subscript = time_ms([&] {
+			for (auto key : keys)
+				++counters[key];
+		});
+		double emplace = time_ms([&] {
+			for (auto key : keys)
+				++counters.try_emplace(key, 0).first->second;
+		});
+		double assign = time_ms([&] {
+			for (auto key : keys)
+				counters.insert_or_assign(key, key);
+		});
+		do_not_optimize(counters.size());
+		std::cout << std::setw(12) << n << std::setw(18) << subscript * 1e6 / operations
+			<< std::setw(18) << emplace * 1e6 / operations << std::setw(22) << assign * 1e6 / operations << '\n';
+	}
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include <exception>
+
+namespace ancillary {
+
+	namespace execution {
+
+		// Requests that an algorithm spread its work over several threads. A thread
+		// count of zero uses every hardware thread.
+		struct parallel_policy {
+			std::size_t threads = 0;
+
+			std::size_t concurrency() const noexcept {
+				if (threads != 0)
+					return threads;
+				auto hardware = static_cast<std::size_t>(std::thread::hardware_concurrency());
+				return hardware != 0 ? hardware : 1;
+			}
+		};
+
+		inline constexpr parallel_policy par{};
+
+	}
+
+	namespace detail {
+
+		// Ranges shorter than this are sorted on the calling thread
+		inline constexpr std::size_t parallel_sort_cutoff = 1 << 14;
+
+		// Runs task(i) for every i in [0, count) on up to `threads` threads, the
+		// calling thread included. The first exception thrown by a task is rethrown.
+		template <class Task>
+		void parallel_for(std::size_t count, std::size_t threads, Task task) {
+			threads = std::min(threads, count);
+			if (threads <= 1) {
+				for (std::size_t i = 0; i < count; ++i)
+					task(i);
+				return;
+			}
+			std::vector<std::exception_ptr> errors(threads);
+			auto work = [&](std::size_t t) {
+				try {
+					for (std::size_t i = t; i < count; i += threads)
+						task(i);
+				}
+				catch (...) {
+					errors[t] = std::current_exception();
+				}
+			};
+			std::vector<std::thread> workers;
+			workers.reserve(threads - 1);
+			for (std::size_t t = 1; t < threads; ++t)
+				workers.emplace_back(work, t);
+			work(0);
+			for (auto& worker : workers)
+				worker.join();
+			for (auto& error : errors)
+				if (error)
+					std::rethrow_exception(error);
+		}
+
+		// Number of elements of the sorted range a that precede the k-th element of
+		// the stable merge of a and b, where equivalent elements of a come first
+		template <class RndIt1, class RndIt2, class Compare>
+		std::ptrdiff_t merge_co_rank(std::ptrdiff_t k, RndIt1 a, std::ptrdiff_t m, RndIt2 b, std::ptrdiff_t n, Compare& comp) {
+			std::ptrdiff_t lo = std::max<std::ptrdiff_t>(0, k - n);
+			std::ptrdiff_t hi = std::min(k, m);
+			while (lo < hi) {
+				std::ptrdiff_t i = lo + (hi - lo) / 2;
+				std::ptrdiff_t j = k - i;
+				if (comp(b[j - 1], a[i]))
+					hi = i;
+				else
+					lo = i + 1;
+			}
+			return lo;
+		}
+
+	}
+
+	// Stable sort that sorts one chunk per thread and then merges pairs of sorted
+	// chunks round by round. Every merge is cut into pieces of equal output length,
+	// so all threads stay busy until the last round. Needs a buffer of last - first
+	// elements, into which the range is moved.
+	template <class RndIt, class Compare>
+	void parallel_stable_sort(const execution::parallel_policy& policy, RndIt first, RndIt last, Compare comp) {
+		using value_type = typename std::iterator_traits<RndIt>::value_type;
+		const auto len = static_cast<std::size_t>(last - first);
+		const std::size_t threads = std::min(policy.concurrency(), len / detail::parallel_sort_cutoff);
+		if (threads <= 1) {
+			std::stable_sort(first, last, comp);
+			return;
+		}
+
+		std::vector<value_type> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+		auto data = buffer.begin();
+
+		// Chunk c spans [bounds[c], bounds[c + 1])
+		std::vector<std::size_t> bounds(threads + 1);
+		for (std::size_t c = 0; c <= threads; ++c)
+			bounds[c] = len * c / threads;
+		detail::parallel_for(threads, threads, [&](std::size_t c) {
+			std::stable_sort(data + bounds[c], data + bounds[c + 1], comp);
+		});
+
+		// Each round merges runs from src into dst, then swaps their roles
+		const std::size_t piece = (len + threads - 1) / threads;
+		bool in_buffer = true;
+		while (bounds.size() > 2) {
+			struct merge_task { std::size_t lo, mid, hi, k_first, k_last; };
+			std::vector<merge_task> tasks;
+			std::vector<std::size_t> next;
+			for (std::size_t c = 0; c + 1 < bounds.size(); c += 2) {
+				next.push_back(bounds[c]);
+				std::size_t lo = bounds[c];
+				std::size_t mid = bounds[c + 1];
+				std::size_t hi = c + 2 < bounds.size() ? bounds[c + 2] : mid;
+				for (std::size_t k = 0; k < hi - lo; k += piece)
+					tasks.push_back({ lo, mid, hi, k, std::min(k + piece, hi - lo) });
+			}
+			next.push_back(len);
+
+			auto run = [&](auto src, auto dst) {
+				detail::parallel_for(tasks.size(), threads, [&](std::size_t t) {
+					const merge_task& task = tasks[t];
+					auto a = src + task.lo;
+					auto b = src + task.mid;
+					auto m = static_cast<std::ptrdiff_t>(task.mid - task.lo);
+					auto n = static_cast<std::ptrdiff_t>(task.hi - task.mid);
+					auto k_first = static_cast<std::ptrdiff_t>(task.k_first);
+					auto k_last = static_cast<std::ptrdiff_t>(task.k_last);
+					auto i_first = detail::merge_co_rank(k_first, a, m, b, n, comp);
+					auto i_last = detail::merge_co_rank(k_last, a, m, b, n, comp);
+					std::merge(
+						std::make_move_iterator(a + i_first), std::make_move_iterator(a + i_last),
+						std::make_move_iterator(b + (k_first - i_first)), std::make_move_iterator(b + (k_last - i_last)),
+						dst + task.lo + task.k_first, comp);
+				});
+			};
+			if (in_buffer)
+				run(data, first);
+			else
+				run(first, data);
+			in_buffer = !in_buffer;
+			bounds = std::move(next);
+		}
+
+		if (in_buffer) {
+			detail::parallel_for(threads, threads, [&](std::size_t c) {
+				std::size_t lo = len * c / threads;
+				std::size_t hi = len * (c + 1) / threads;
+				std::move(data + lo, data + hi, first + lo);
+			});
+		}
+	}
+
+}
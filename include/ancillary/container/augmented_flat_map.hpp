@@ -0,0 +1,406 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+#include "flat_map.hpp"
+
+namespace ancillary {
+
+	// Monoids for augmented_flat_map. A monoid names the type it aggregates, an identity
+	// element and an associative operation; the operation need not be commutative.
+
+	template <
+		class T
+	> struct sum_monoid {
+		using value_type = T;
+		value_type identity() const { return value_type(); }
+		value_type operator()(const value_type& lhs, const value_type& rhs) const { return lhs + rhs; }
+	};
+
+	template <
+		class T
+	> struct min_monoid {
+		using value_type = T;
+		value_type identity() const {
+			if constexpr (std::numeric_limits<T>::has_infinity)
+				return std::numeric_limits<T>::infinity();
+			else
+				return std::numeric_limits<T>::max();
+		}
+		value_type operator()(const value_type& lhs, const value_type& rhs) const { return rhs < lhs ? rhs : lhs; }
+	};
+
+	template <
+		class T
+	> struct max_monoid {
+		using value_type = T;
+		value_type identity() const {
+			if constexpr (std::numeric_limits<T>::has_infinity)
+				return -std::numeric_limits<T>::infinity();
+			else
+				return std::numeric_limits<T>::lowest();
+		}
+		value_type operator()(const value_type& lhs, const value_type& rhs) const { return lhs < rhs ? rhs : lhs; }
+	};
+
+	// A flat_map that answers aggregate(lo, hi), the monoid fold of the mapped values of
+	// the keys in [lo, hi), in O(log n). A bottom-up segment tree over the mapped values
+	// runs parallel to the sorted storage. Assigning to an existing key patches the path
+	// to the root in O(log n); insertions and erasures shift positions, so they only mark
+	// the index stale and the next non-const aggregate() rebuilds it in O(n). The const
+	// aggregate() cannot rebuild, so on a stale index it folds the range directly in
+	// O(hi - lo). Mapped values can only change through the map, so iterators are constant.
+	template <
+		class Key,
+		class T,
+		class Monoid = sum_monoid<T>,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<Key, T>>,
+		class SearchPolicy = binary_search_policy
+	> class augmented_flat_map {
+	public:
+
+		using flat_map_type          = flat_map<Key, T, Compare, Allocator, SearchPolicy>;
+		using key_type               = Key;
+		using mapped_type            = T;
+		using value_type             = std::pair<Key, T>;
+		using key_compare            = Compare;
+		using value_compare          = typename flat_map_type::value_compare;
+		using monoid_type            = Monoid;
+		using aggregate_type         = typename Monoid::value_type;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using allocator_type         = Allocator;
+		using const_reference        = const value_type&;
+		using iterator               = typename flat_map_type::const_iterator;
+		using const_iterator         = typename flat_map_type::const_iterator;
+		using reverse_iterator       = typename flat_map_type::const_reverse_iterator;
+		using const_reverse_iterator = typename flat_map_type::const_reverse_iterator;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                  CONSTRUCTORS                                  //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		augmented_flat_map()
+			: augmented_flat_map(Compare()) {}
+
+		explicit augmented_flat_map(const Compare& comp,
+			const Monoid& monoid = Monoid(),
+			const Allocator& alloc = Allocator())
+			: m_map(comp, alloc)
+			, m_monoid(monoid) {}
+
+		explicit augmented_flat_map(flat_map_type map, const Monoid& monoid = Monoid())
+			: m_map(std::move(map))
+			, m_monoid(monoid)
+			, m_stale(true) {}
+
+		template <class InIt>
+		augmented_flat_map(InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const Monoid& monoid = Monoid(),
+			const Allocator& alloc = Allocator())
+			: m_map(first, last, comp, alloc)
+			, m_monoid(monoid)
+			, m_stale(true) {}
+
+		template <class InIt>
+		augmented_flat_map(sorted_unique_t tag, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const Monoid& monoid = Monoid(),
+			const Allocator& alloc = Allocator())
+			: m_map(tag, first, last, comp, alloc)
+			, m_monoid(monoid)
+			, m_stale(true) {}
+
+		augmented_flat_map(std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const Monoid& monoid = Monoid(),
+			const Allocator& alloc = Allocator())
+			: augmented_flat_map(list.begin(), list.end(), comp, monoid, alloc) {}
+
+		augmented_flat_map(const augmented_flat_map&) = default;
+		augmented_flat_map(augmented_flat_map&&) = default;
+
+		~augmented_flat_map() = default;
+
+		augmented_flat_map& operator=(const augmented_flat_map&) = default;
+		augmented_flat_map& operator=(augmented_flat_map&&) = default;
+
+		allocator_type get_allocator() const noexcept { return m_map.get_allocator(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    ITERATORS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		const_iterator begin() const noexcept { return m_map.begin(); }
+		const_iterator cbegin() const noexcept { return begin(); }
+
+		const_iterator end() const noexcept { return m_map.end(); }
+		const_iterator cend() const noexcept { return end(); }
+
+		const_reverse_iterator rbegin() const noexcept { return m_map.rbegin(); }
+		const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+		const_reverse_iterator rend() const noexcept { return m_map.rend(); }
+		const_reverse_iterator crend() const noexcept { return rend(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    CAPACITY                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		bool empty() const noexcept { return m_map.empty(); }
+		size_type size() const noexcept { return m_map.size(); }
+		void reserve(size_type new_cap) { m_map.reserve(new_cap); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                 ELEMENT ACCESS                                 //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		const mapped_type& at(const key_type& key) const { return m_map.at(key); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    MODIFIERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		void clear() noexcept {
+			m_map.clear();
+			m_index.clear();
+			m_stale = false;
+		}
+
+		std::pair<const_iterator, bool> insert(const value_type& x) { return try_emplace(x.first, x.second); }
+		std::pair<const_iterator, bool> insert(value_type&& x) { return try_emplace(std::move(x.first), std::move(x.second)); }
+
+		template <class InIt>
+		void insert(InIt first, InIt last) {
+			m_map.insert(first, last);
+			m_stale = true;
+		}
+
+		template <class InIt>
+		void insert(sorted_unique_t tag, InIt first, InIt last) {
+			m_map.insert(tag, first, last);
+			m_stale = true;
+		}
+
+		void insert(std::initializer_list<value_type> list) {
+			insert(list.begin(), list.end());
+		}
+
+		template <class... Args>
+		std::pair<const_iterator, bool> emplace(Args&&... args) {
+			return insert(value_type(std::forward<Args>(args)...));
+		}
+
+		template <class... Args>
+		std::pair<const_iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+			return structural(m_map.try_emplace(k, std::forward<Args>(args)...));
+		}
+
+		template <class... Args>
+		std::pair<const_iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+			return structural(m_map.try_emplace(std::move(k), std::forward<Args>(args)...));
+		}
+
+		template <class M>
+		std::pair<const_iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+			return assigned(m_map.insert_or_assign(k, std::forward<M>(obj)));
+		}
+
+		template <class M>
+		std::pair<const_iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+			return assigned(m_map.insert_or_assign(std::move(k), std::forward<M>(obj)));
+		}
+
+		// Calls f(mapped_type&) if the key is present and patches the index afterwards
+		template <class F>
+		bool update(const key_type& key, F f) {
+			auto it = m_map.find(key);
+			if (it == m_map.end())
+				return false;
+			f(it->second);
+			patch(it - m_map.begin());
+			return true;
+		}
+
+		const_iterator erase(const_iterator pos) {
+			m_stale = true;
+			return m_map.erase(pos);
+		}
+
+		const_iterator erase(const_iterator first, const_iterator last) {
+			m_stale = true;
+			return m_map.erase(first, last);
+		}
+
+		size_type erase(const key_type& key) {
+			size_type erased = m_map.erase(key);
+			m_stale = m_stale || erased != 0;
+			return erased;
+		}
+
+		void swap(augmented_flat_map& other) {
+			if (this != &other) {
+				std::swap(m_map, other.m_map);
+				std::swap(m_monoid, other.m_monoid);
+				std::swap(m_index, other.m_index);
+				std::swap(m_stale, other.m_stale);
+			}
+		}
+
+		// Rebuilds the index now rather than at the next aggregate()
+		void reindex() {
+			const size_type n = m_map.size();
+			m_index.assign(2 * n, m_monoid.identity());
+			for (size_type i = 0; i < n; ++i)
+				m_index[n + i] = m_map.begin()[i].second;
+			for (size_type i = n; i-- > 1;)
+				m_index[i] = m_monoid(m_index[2 * i], m_index[2 * i + 1]);
+			m_stale = false;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     LOOKUP                                     //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		size_type count(const key_type& key) const { return m_map.count(key); }
+		bool contains(const key_type& key) const { return m_map.contains(key); }
+		const_iterator find(const key_type& key) const { return m_map.find(key); }
+		const_iterator lower_bound(const key_type& key) const { return m_map.lower_bound(key); }
+		const_iterator upper_bound(const key_type& key) const { return m_map.upper_bound(key); }
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const { return m_map.equal_range(key); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                   AGGREGATES                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		// Folds the mapped values of the keys in [lo, hi) in key order
+		aggregate_type aggregate(const key_type& lo, const key_type& hi) {
+			if (m_stale)
+				reindex();
+			return std::as_const(*this).aggregate(lo, hi);
+		}
+
+		aggregate_type aggregate(const key_type& lo, const key_type& hi) const {
+			if (!m_map.key_comp()(lo, hi))
+				return m_monoid.identity();
+			return aggregate(m_map.lower_bound(lo), m_map.lower_bound(hi));
+		}
+
+		// Folds the mapped values of the elements in [first, last)
+		aggregate_type aggregate(const_iterator first, const_iterator last) {
+			if (m_stale)
+				reindex();
+			return std::as_const(*this).aggregate(first, last);
+		}
+
+		aggregate_type aggregate(const_iterator first, const_iterator last) const {
+			if (m_stale) {
+				aggregate_type result = m_monoid.identity();
+				for (; first != last; ++first)
+					result = m_monoid(result, first->second);
+				return result;
+			}
+			return fold(first - begin(), last - begin());
+		}
+
+		// Folds every mapped value
+		aggregate_type aggregate() { return aggregate(begin(), end()); }
+		aggregate_type aggregate() const { return aggregate(begin(), end()); }
+
+		// Whether an insertion or erasure happened since the index was last rebuilt
+		bool stale() const noexcept { return m_stale; }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    OBSERVERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		key_compare key_comp() const { return m_map.key_comp(); }
+		value_compare value_comp() const { return m_map.value_comp(); }
+		monoid_type monoid() const { return m_monoid; }
+
+		const flat_map_type& map() const noexcept { return m_map; }
+
+	private:
+
+		using index_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<aggregate_type>;
+
+		template <class It>
+		std::pair<const_iterator, bool> structural(std::pair<It, bool> result) {
+			m_stale = m_stale || result.second;
+			return result;
+		}
+
+		template <class It>
+		std::pair<const_iterator, bool> assigned(std::pair<It, bool> result) {
+			if (result.second)
+				m_stale = true;
+			else
+				patch(result.first - m_map.begin());
+			return result;
+		}
+
+		// Recomputes the leaf at position i and its ancestors
+		void patch(size_type i) {
+			if (m_stale)
+				return;
+			const size_type n = m_map.size();
+			i += n;
+			m_index[i] = m_map.begin()[i - n].second;
+			for (i /= 2; i >= 1; i /= 2)
+				m_index[i] = m_monoid(m_index[2 * i], m_index[2 * i + 1]);
+		}
+
+		// Folds the leaves [first, last), keeping the left and right partial results apart
+		// so that non-commutative monoids combine in order
+		aggregate_type fold(size_type first, size_type last) const {
+			const size_type n = m_map.size();
+			aggregate_type left = m_monoid.identity();
+			aggregate_type right = m_monoid.identity();
+			for (first += n, last += n; first < last; first /= 2, last /= 2) {
+				if (first & 1)
+					left = m_monoid(left, m_index[first++]);
+				if (last & 1)
+					right = m_monoid(m_index[--last], right);
+			}
+			return m_monoid(left, right);
+		}
+
+		flat_map_type m_map;                                  // Sorted elements
+		monoid_type m_monoid;                                 // Aggregation
+		std::vector<aggregate_type, index_allocator> m_index; // Segment tree with the mapped values at [size(), 2 * size())
+		bool m_stale = false;                                 // Whether m_index lags behind m_map
+
+	};
+
+	template <class Key, class T, class Monoid, class Compare, class Allocator, class SearchPolicy>
+	bool operator==(
+		const augmented_flat_map<Key, T, Monoid, Compare, Allocator, SearchPolicy>& lhs,
+		const augmented_flat_map<Key, T, Monoid, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <class Key, class T, class Monoid, class Compare, class Allocator, class SearchPolicy>
+	bool operator!=(
+		const augmented_flat_map<Key, T, Monoid, Compare, Allocator, SearchPolicy>& lhs,
+		const augmented_flat_map<Key, T, Monoid, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+}
+
+namespace std {
+	template <class Key, class T, class Monoid, class Compare, class Allocator, class SearchPolicy>
+	void swap(
+		ancillary::augmented_flat_map<Key, T, Monoid, Compare, Allocator, SearchPolicy>& lhs,
+		ancillary::augmented_flat_map<Key, T, Monoid, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return lhs.swap(rhs);
+	}
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <tuple>
+#include <stdexcept>
+#include "../detail/btree.hpp"
+#include "../detail/extract_key.hpp"
+
+namespace ancillary {
+
+	// A sorted map for sizes where flat_map inserts get too slow: the pairs live in a
+	// B+-tree whose leaves are small flat arrays, so an insertion shifts at most one leaf
+	// and scans still walk contiguous memory. Upserts descend the tree once.
+	template <
+		class Key,
+		class T,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<Key, T>>,
+		class SearchPolicy = binary_search_policy
+	> struct btree_map
+		: detail::btree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>, SearchPolicy>
+	{
+		using tree_type = detail::btree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>, SearchPolicy>;
+		using typename tree_type::key_type;
+		using mapped_type = T;
+		using typename tree_type::value_type;
+		using typename tree_type::key_compare;
+		using typename tree_type::value_compare;
+		using typename tree_type::size_type;
+		using typename tree_type::difference_type;
+		using typename tree_type::allocator_type;
+		using typename tree_type::reference;
+		using typename tree_type::const_reference;
+		using typename tree_type::pointer;
+		using typename tree_type::const_pointer;
+		using typename tree_type::iterator;
+		using typename tree_type::const_iterator;
+		using typename tree_type::reverse_iterator;
+		using typename tree_type::const_reverse_iterator;
+
+		btree_map() = default;
+
+		explicit btree_map(const Compare& comp, const allocator_type& alloc = allocator_type())
+			: tree_type(comp, alloc) {}
+
+		explicit btree_map(const allocator_type& alloc)
+			: tree_type(alloc) {}
+
+		template <class InIt>
+		btree_map(InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(first, last, comp, alloc) {}
+
+		template <class InIt>
+		btree_map(sorted_unique_t tag, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(tag, first, last, comp, alloc) {}
+
+		btree_map(std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(list, comp, alloc) {}
+
+		btree_map(const btree_map&) = default;
+		btree_map(btree_map&&) = default;
+
+		~btree_map() = default;
+
+		btree_map& operator=(const btree_map&) = default;
+		btree_map& operator=(btree_map&&) = default;
+		btree_map& operator=(std::initializer_list<value_type> list) {
+			tree_type::operator=(list);
+			return *this;
+		}
+
+		using tree_type::get_allocator;
+
+		mapped_type& at(const key_type& key) {
+			return const_cast<mapped_type&>(const_cast<const btree_map*>(this)->at(key));
+		}
+
+		const mapped_type& at(const key_type& key) const {
+			auto it = find(key);
+			if (it == end())
+				throw std::out_of_range("No such element with the given key!");
+			else
+				return it->second;
+		}
+
+		mapped_type& operator[](const key_type& key) {
+			return try_emplace(key).first->second;
+		}
+
+		mapped_type& operator[](key_type&& key) {
+			return try_emplace(std::move(key)).first->second;
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+			return assign_or_emplace(k, std::forward<M>(obj));
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+			return assign_or_emplace(std::move(k), std::forward<M>(obj));
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+			return try_emplace_impl(k, std::forward<Args>(args)...);
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+			return try_emplace_impl(std::move(k), std::forward<Args>(args)...);
+		}
+
+		using tree_type::begin;
+		using tree_type::cbegin;
+		using tree_type::end;
+		using tree_type::cend;
+
+		using tree_type::rbegin;
+		using tree_type::crbegin;
+		using tree_type::rend;
+		using tree_type::crend;
+
+		using tree_type::empty;
+		using tree_type::size;
+		using tree_type::max_size;
+		using tree_type::height;
+
+		using tree_type::clear;
+		using tree_type::insert;
+		using tree_type::emplace;
+		using tree_type::erase;
+		using tree_type::swap;
+
+		using tree_type::count;
+		using tree_type::find;
+		using tree_type::contains;
+		using tree_type::equal_range;
+		using tree_type::lower_bound;
+		using tree_type::upper_bound;
+
+		using tree_type::key_comp;
+		using tree_type::value_comp;
+
+	private:
+
+		template <class K, class... Args>
+		std::pair<iterator, bool> try_emplace_impl(K&& k, Args&&... args) {
+			const key_type& key = k;
+			return tree_type::emplace_key(key, [&] {
+				return value_type(std::piecewise_construct,
+					std::forward_as_tuple(std::forward<K>(k)),
+					std::forward_as_tuple(std::forward<Args>(args)...));
+			});
+		}
+
+		template <class K, class M>
+		std::pair<iterator, bool> assign_or_emplace(K&& k, M&& obj) {
+			const key_type& key = k;
+			bool constructed = false;
+			auto result = tree_type::emplace_key(key, [&] {
+				constructed = true;
+				return value_type(std::forward<K>(k), std::forward<M>(obj));
+			});
+			if (!constructed)
+				result.first->second = std::forward<M>(obj);
+			return result;
+		}
+
+	};
+
+}
+
+namespace std {
+	template <class Key, class T, class Compare, class Allocator, class SearchPolicy>
+	void swap(
+		ancillary::btree_map<Key, T, Compare, Allocator, SearchPolicy>& lhs,
+		ancillary::btree_map<Key, T, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return lhs.swap(rhs);
+	}
+}
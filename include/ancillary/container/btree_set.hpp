@@ -0,0 +1,117 @@
+#pragma once
+
+#include "../detail/btree.hpp"
+#include "../detail/extract_key.hpp"
+
+namespace ancillary {
+
+	// A sorted set for sizes where flat_set inserts get too slow: the keys live in a
+	// B+-tree whose leaves are small flat arrays, so an insertion shifts at most one leaf
+	// and scans still walk contiguous memory.
+	template <
+		class Key,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<Key>,
+		class SearchPolicy = binary_search_policy
+	> struct btree_set : detail::btree<Key, Compare, Allocator, detail::identity<Key>, SearchPolicy>
+	{
+		using tree_type = detail::btree<Key, Compare, Allocator, detail::identity<Key>, SearchPolicy>;
+		using typename tree_type::key_type;
+		using typename tree_type::value_type;
+		using typename tree_type::key_compare;
+		using typename tree_type::value_compare;
+		using typename tree_type::size_type;
+		using typename tree_type::difference_type;
+		using typename tree_type::allocator_type;
+		using typename tree_type::reference;
+		using typename tree_type::const_reference;
+		using typename tree_type::pointer;
+		using typename tree_type::const_pointer;
+		using typename tree_type::iterator;
+		using typename tree_type::const_iterator;
+		using typename tree_type::reverse_iterator;
+		using typename tree_type::const_reverse_iterator;
+
+		btree_set() = default;
+
+		explicit btree_set(const Compare& comp, const allocator_type& alloc = allocator_type())
+			: tree_type(comp, alloc) {}
+
+		explicit btree_set(const allocator_type& alloc)
+			: tree_type(alloc) {}
+
+		template <class InIt>
+		btree_set(InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(first, last, comp, alloc) {}
+
+		template <class InIt>
+		btree_set(sorted_unique_t tag, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(tag, first, last, comp, alloc) {}
+
+		btree_set(std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(list, comp, alloc) {}
+
+		btree_set(const btree_set&) = default;
+		btree_set(btree_set&&) = default;
+
+		~btree_set() = default;
+
+		btree_set& operator=(const btree_set&) = default;
+		btree_set& operator=(btree_set&&) = default;
+		btree_set& operator=(std::initializer_list<value_type> list) {
+			tree_type::operator=(list);
+			return *this;
+		}
+
+		using tree_type::get_allocator;
+
+		using tree_type::begin;
+		using tree_type::cbegin;
+		using tree_type::end;
+		using tree_type::cend;
+
+		using tree_type::rbegin;
+		using tree_type::crbegin;
+		using tree_type::rend;
+		using tree_type::crend;
+
+		using tree_type::empty;
+		using tree_type::size;
+		using tree_type::max_size;
+		using tree_type::height;
+
+		using tree_type::clear;
+		using tree_type::insert;
+		using tree_type::emplace;
+		using tree_type::erase;
+		using tree_type::swap;
+
+		using tree_type::count;
+		using tree_type::find;
+		using tree_type::contains;
+		using tree_type::equal_range;
+		using tree_type::lower_bound;
+		using tree_type::upper_bound;
+
+		using tree_type::key_comp;
+		using tree_type::value_comp;
+
+	};
+
+}
+
+namespace std {
+	template <class Key, class Compare, class Allocator, class SearchPolicy>
+	void swap(
+		ancillary::btree_set<Key, Compare, Allocator, SearchPolicy>& lhs,
+		ancillary::btree_set<Key, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return lhs.swap(rhs);
+	}
+}
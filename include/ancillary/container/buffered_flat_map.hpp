@@ -0,0 +1,442 @@
+#pragma once
+
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include "flat_map.hpp"
+
+namespace ancillary {
+
+	namespace detail {
+
+		// Walks two sorted ranges with disjoint keys as one sorted sequence
+		template <
+			class Iterator,
+			class Compare
+		> class buffered_iterator {
+		public:
+
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type        = typename std::iterator_traits<Iterator>::value_type;
+			using difference_type   = typename std::iterator_traits<Iterator>::difference_type;
+			using pointer           = typename std::iterator_traits<Iterator>::pointer;
+			using reference         = typename std::iterator_traits<Iterator>::reference;
+
+			buffered_iterator() = default;
+
+			buffered_iterator(Iterator body_first, Iterator body, Iterator body_last,
+				Iterator buffer_first, Iterator buffer, Iterator buffer_last, Compare comp)
+				: m_body_first(body_first), m_body(body), m_body_last(body_last)
+				, m_buffer_first(buffer_first), m_buffer(buffer), m_buffer_last(buffer_last)
+				, m_comp(comp) {}
+
+			reference operator*() const { return from_body() ? *m_body : *m_buffer; }
+			pointer operator->() const { return std::addressof(**this); }
+
+			buffered_iterator& operator++() {
+				if (from_body())
+					++m_body;
+				else
+					++m_buffer;
+				return *this;
+			}
+
+			buffered_iterator operator++(int) {
+				auto copy = *this;
+				++(*this);
+				return copy;
+			}
+
+			buffered_iterator& operator--() {
+				if (m_body == m_body_first)
+					--m_buffer;
+				else if (m_buffer == m_buffer_first || m_comp(std::prev(m_buffer)->first, std::prev(m_body)->first))
+					--m_body;
+				else
+					--m_buffer;
+				return *this;
+			}
+
+			buffered_iterator operator--(int) {
+				auto copy = *this;
+				--(*this);
+				return copy;
+			}
+
+			friend bool operator==(const buffered_iterator& lhs, const buffered_iterator& rhs) {
+				return lhs.m_body == rhs.m_body && lhs.m_buffer == rhs.m_buffer;
+			}
+
+			friend bool operator!=(const buffered_iterator& lhs, const buffered_iterator& rhs) {
+				return !(lhs == rhs);
+			}
+
+		private:
+
+			bool from_body() const {
+				return m_buffer == m_buffer_last || (m_body != m_body_last && m_comp(m_body->first, m_buffer->first));
+			}
+
+			Iterator m_body_first;   // Start of the sorted body
+			Iterator m_body;         // Next element of the body
+			Iterator m_body_last;    // End of the sorted body
+			Iterator m_buffer_first; // Start of the buffer
+			Iterator m_buffer;       // Next element of the buffer
+			Iterator m_buffer_last;  // End of the buffer
+			Compare m_comp;          // Key comparison
+
+		};
+
+	}
+
+	// A flat_map for write-heavy workloads. New elements go to a small sorted buffer, so an
+	// insertion shifts at most buffer_size() elements instead of the whole map, and the
+	// buffer is merged into the sorted body once full or on flush(). The buffer holds twice
+	// the square root of the body's size, but never less than min_buffer_size(), which keeps
+	// both the shifting and the amortized merging to O(sqrt(n)) per insertion. Lookups
+	// search both parts, and modifiers report whether an element was inserted rather than
+	// return an iterator. The mutable begin() and end() flush first and return iterators
+	// into the body, while const iteration walks the body and the buffer merged on the fly.
+	template <
+		class Key,
+		class T,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<Key, T>>,
+		class SearchPolicy = binary_search_policy
+	> class buffered_flat_map {
+	public:
+
+		using flat_map_type          = flat_map<Key, T, Compare, Allocator, SearchPolicy>;
+		using key_type               = Key;
+		using mapped_type            = T;
+		using value_type             = std::pair<Key, T>;
+		using key_compare            = Compare;
+		using value_compare          = typename flat_map_type::value_compare;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using allocator_type         = Allocator;
+		using reference              = value_type&;
+		using const_reference        = const value_type&;
+		using iterator               = typename flat_map_type::iterator;
+		using const_iterator         = detail::buffered_iterator<typename flat_map_type::const_iterator, Compare>;
+		using reverse_iterator       = typename flat_map_type::reverse_iterator;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static constexpr size_type default_min_buffer_size = 1024;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                  CONSTRUCTORS                                  //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		buffered_flat_map()
+			: buffered_flat_map(Compare()) {}
+
+		explicit buffered_flat_map(const Compare& comp,
+			const Allocator& alloc = Allocator(),
+			size_type min_buffer_size = default_min_buffer_size)
+			: m_body(comp, alloc)
+			, m_buffer(comp, alloc)
+			, m_min_buffer_size(std::max<size_type>(min_buffer_size, 1)) {}
+
+		explicit buffered_flat_map(flat_map_type body,
+			size_type min_buffer_size = default_min_buffer_size)
+			: m_body(std::move(body))
+			, m_buffer(m_body.key_comp(), m_body.get_allocator())
+			, m_min_buffer_size(std::max<size_type>(min_buffer_size, 1)) {}
+
+		template <class InIt>
+		buffered_flat_map(InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const Allocator& alloc = Allocator())
+			: m_body(first, last, comp, alloc)
+			, m_buffer(comp, alloc)
+			, m_min_buffer_size(default_min_buffer_size) {}
+
+		buffered_flat_map(std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const Allocator& alloc = Allocator())
+			: buffered_flat_map(list.begin(), list.end(), comp, alloc) {}
+
+		buffered_flat_map(const buffered_flat_map&) = default;
+		buffered_flat_map(buffered_flat_map&&) = default;
+
+		~buffered_flat_map() = default;
+
+		buffered_flat_map& operator=(const buffered_flat_map&) = default;
+		buffered_flat_map& operator=(buffered_flat_map&&) = default;
+
+		allocator_type get_allocator() const noexcept { return m_body.get_allocator(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    ITERATORS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		iterator begin() { flush(); return m_body.begin(); }
+		const_iterator begin() const noexcept { return make_iterator(m_body.begin(), m_buffer.begin()); }
+		const_iterator cbegin() const noexcept { return begin(); }
+
+		iterator end() { flush(); return m_body.end(); }
+		const_iterator end() const noexcept { return make_iterator(m_body.end(), m_buffer.end()); }
+		const_iterator cend() const noexcept { return end(); }
+
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+		const_reverse_iterator crend() const noexcept { return rend(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    CAPACITY                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		bool empty() const noexcept { return m_body.empty() && m_buffer.empty(); }
+		size_type size() const noexcept { return m_body.size() + m_buffer.size(); }
+		size_type pending() const noexcept { return m_buffer.size(); }
+		size_type min_buffer_size() const noexcept { return m_min_buffer_size; }
+
+		// Number of buffered elements that triggers a flush
+		size_type buffer_size() const noexcept {
+			auto root = static_cast<size_type>(2 * std::sqrt(static_cast<double>(m_body.size())));
+			return std::max(m_min_buffer_size, root);
+		}
+
+		void reserve(size_type new_cap) { m_body.reserve(new_cap); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                 ELEMENT ACCESS                                 //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		mapped_type& at(const key_type& key) {
+			return const_cast<mapped_type&>(const_cast<const buffered_flat_map*>(this)->at(key));
+		}
+
+		const mapped_type& at(const key_type& key) const {
+			if (auto p = lookup(key))
+				return p->second;
+			throw std::out_of_range("No such element with the given key!");
+		}
+
+		mapped_type& operator[](const key_type& key) {
+			return try_emplace_impl(key).first->second;
+		}
+
+		mapped_type& operator[](key_type&& key) {
+			return try_emplace_impl(std::move(key)).first->second;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    MODIFIERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		void clear() noexcept {
+			m_body.clear();
+			m_buffer.clear();
+		}
+
+		// Sorts the pending elements and merges them into the body
+		void flush() {
+			if (m_buffer.empty())
+				return;
+			m_body.insert(sorted_unique, std::make_move_iterator(m_buffer.begin()), std::make_move_iterator(m_buffer.end()));
+			m_buffer.clear();
+		}
+
+		bool insert(const value_type& x) { return try_emplace_impl(x.first, x.second).second; }
+		bool insert(value_type&& x) { return try_emplace_impl(std::move(x.first), std::move(x.second)).second; }
+
+		template <class InIt>
+		void insert(InIt first, InIt last) {
+			flush();
+			m_body.insert(first, last);
+		}
+
+		void insert(std::initializer_list<value_type> list) {
+			insert(list.begin(), list.end());
+		}
+
+		template <class... Args>
+		bool emplace(Args&&... args) {
+			return insert(value_type(std::forward<Args>(args)...));
+		}
+
+		template <class... Args>
+		bool try_emplace(const key_type& k, Args&&... args) {
+			return try_emplace_impl(k, std::forward<Args>(args)...).second;
+		}
+
+		template <class... Args>
+		bool try_emplace(key_type&& k, Args&&... args) {
+			return try_emplace_impl(std::move(k), std::forward<Args>(args)...).second;
+		}
+
+		template <class M>
+		bool insert_or_assign(const key_type& k, M&& obj) {
+			auto ret = try_emplace_impl(k, std::forward<M>(obj));
+			if (!ret.second)
+				ret.first->second = std::forward<M>(obj);
+			return ret.second;
+		}
+
+		template <class M>
+		bool insert_or_assign(key_type&& k, M&& obj) {
+			auto ret = try_emplace_impl(std::move(k), std::forward<M>(obj));
+			if (!ret.second)
+				ret.first->second = std::forward<M>(obj);
+			return ret.second;
+		}
+
+		size_type erase(const key_type& key) {
+			return m_buffer.erase(key) + m_body.erase(key);
+		}
+
+		void swap(buffered_flat_map& other) {
+			if (this != &other) {
+				std::swap(m_body, other.m_body);
+				std::swap(m_buffer, other.m_buffer);
+				std::swap(m_min_buffer_size, other.m_min_buffer_size);
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     LOOKUP                                     //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		size_type count(const key_type& key) const { return contains(key); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		size_type count(const K& key) const { return contains(key); }
+
+		bool contains(const key_type& key) const { return lookup(key) != nullptr; }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		bool contains(const K& key) const { return lookup(key) != nullptr; }
+
+		// The lookups below search both parts without flushing and return iterators
+		// that walk them merged, so compare their results against cend()
+
+		const_iterator find(const key_type& key) const { return find_impl(key); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator find(const K& key) const { return find_impl(key); }
+
+		const_iterator lower_bound(const key_type& key) const {
+			return make_iterator(m_body.lower_bound(key), m_buffer.lower_bound(key));
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator lower_bound(const K& key) const {
+			return make_iterator(m_body.lower_bound(key), m_buffer.lower_bound(key));
+		}
+
+		const_iterator upper_bound(const key_type& key) const {
+			return make_iterator(m_body.upper_bound(key), m_buffer.upper_bound(key));
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator upper_bound(const K& key) const {
+			return make_iterator(m_body.upper_bound(key), m_buffer.upper_bound(key));
+		}
+
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+			return { lower_bound(key), upper_bound(key) };
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+			return { lower_bound(key), upper_bound(key) };
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    OBSERVERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		key_compare key_comp() const { return m_body.key_comp(); }
+		value_compare value_comp() const { return m_body.value_comp(); }
+
+		// The sorted part of the map, which holds every element once flushed
+		const flat_map_type& body() const noexcept { return m_body; }
+
+	private:
+
+		const_iterator make_iterator(typename flat_map_type::const_iterator body,
+			typename flat_map_type::const_iterator buffer) const
+		{
+			return const_iterator(m_body.begin(), body, m_body.end(),
+				m_buffer.begin(), buffer, m_buffer.end(), m_body.key_comp());
+		}
+
+		template <class K>
+		const value_type* lookup(const K& key) const {
+			auto it = m_body.find(key);
+			if (it != m_body.end())
+				return std::addressof(*it);
+			auto buffered = m_buffer.find(key);
+			return buffered != m_buffer.end() ? std::addressof(*buffered) : nullptr;
+		}
+
+		// A key lives in only one part, so the other part is positioned at its lower bound
+		template <class K>
+		const_iterator find_impl(const K& key) const {
+			auto it = m_body.find(key);
+			if (it != m_body.end())
+				return make_iterator(it, m_buffer.lower_bound(key));
+			auto buffered = m_buffer.find(key);
+			if (buffered != m_buffer.end())
+				return make_iterator(m_body.lower_bound(key), buffered);
+			return end();
+		}
+
+		// Returns the element with the given key, inserting one built from args into the
+		// buffer if there is none. The pointer is valid until the next modification.
+		template <class K, class... Args>
+		std::pair<value_type*, bool> try_emplace_impl(K&& key, Args&&... args) {
+			auto it = m_body.find(key);
+			if (it != m_body.end())
+				return { std::addressof(*it), false };
+			auto buffered = m_buffer.lower_bound(key);
+			if (buffered != m_buffer.end() && !m_buffer.key_comp()(key, buffered->first))
+				return { std::addressof(*buffered), false };
+			if (m_buffer.size() >= buffer_size()) {
+				flush();
+				buffered = m_buffer.end();
+			}
+			buffered = m_buffer.try_emplace(buffered, std::forward<K>(key), std::forward<Args>(args)...);
+			return { std::addressof(*buffered), true };
+		}
+
+		flat_map_type m_body;    // Sorted elements
+		flat_map_type m_buffer;  // Sorted elements not yet merged into the body
+		size_type m_min_buffer_size; // Smallest number of buffered elements that triggers a flush
+
+	};
+
+	template <class Key, class T, class Compare, class Allocator, class SearchPolicy>
+	bool operator==(
+		const buffered_flat_map<Key, T, Compare, Allocator, SearchPolicy>& lhs,
+		const buffered_flat_map<Key, T, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <class Key, class T, class Compare, class Allocator, class SearchPolicy>
+	bool operator!=(
+		const buffered_flat_map<Key, T, Compare, Allocator, SearchPolicy>& lhs,
+		const buffered_flat_map<Key, T, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+}
+
+namespace std {
+	template <class Key, class T, class Compare, class Allocator, class SearchPolicy>
+	void swap(
+		ancillary::buffered_flat_map<Key, T, Compare, Allocator, SearchPolicy>& lhs,
+		ancillary::buffered_flat_map<Key, T, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return lhs.swap(rhs);
+	}
+}
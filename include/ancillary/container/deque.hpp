@@ -5,6 +5,7 @@
 #include <cassert>
 #include <iterator>
 #include <algorithm>
+#include <type_traits>
 #include "../detail/is_iterator.hpp"
 
 namespace ancillary {
@@ -39,7 +40,10 @@ namespace ancillary {
 				: m_parent(parent)
 				, m_it(it) {}
 
-			deque_iterator(const deque_iterator<Deque, false>& it)
+			deque_iterator(const deque_iterator&) = default;
+
+			template <bool WasConst, class = std::enable_if_t<IsConst && !WasConst>>
+			deque_iterator(const deque_iterator<Deque, WasConst>& it)
 				: m_parent(it.m_parent)
 				, m_it(it.m_it) {}
 
@@ -115,7 +119,7 @@ namespace ancillary {
 				return *this;
 			}
 
-			deque_iterator operator+(difference_type n) {
+			deque_iterator operator+(difference_type n) const {
 				return deque_iterator(*this) += n;
 			}
 
@@ -134,7 +138,7 @@ namespace ancillary {
 				return *this;
 			}
 
-			deque_iterator operator-(difference_type n) {
+			deque_iterator operator-(difference_type n) const {
 				return deque_iterator(*this) -= n;
 			}
 
@@ -214,8 +218,8 @@ namespace ancillary {
 		using reverse_iterator       = std::reverse_iterator<iterator>;
 		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-		friend class iterator;
-		friend class const_iterator;
+		friend iterator;
+		friend const_iterator;
 
 		////////////////////////////////////////////////////////////////////////////////
 		//                               Constructors                                 //
@@ -399,9 +403,9 @@ namespace ancillary {
 		//                                Iterators                                   //
 		////////////////////////////////////////////////////////////////////////////////
 
-		iterator begin() noexcept { return iterator(this, m_head); }
-		const_iterator begin() const noexcept { return const_iterator(this, m_head); }
-		const_iterator cbegin() const noexcept { return const_iterator(this, m_head); }
+		iterator begin() noexcept { return iterator(this, empty() ? nullptr : m_head); }
+		const_iterator begin() const noexcept { return const_iterator(this, empty() ? nullptr : m_head); }
+		const_iterator cbegin() const noexcept { return const_iterator(this, empty() ? nullptr : m_head); }
 
 		iterator end() noexcept { return iterator(this, nullptr); }
 		const_iterator end() const noexcept { return const_iterator(this, nullptr); }
@@ -456,16 +460,24 @@ namespace ancillary {
 			return it;
 		}
 
-		template <class BidirIt, class = std::enable_if_t<detail::is_iterator_v<BidirIt>>>
-		iterator insert(const_iterator pos, BidirIt first, BidirIt last) {
+		template <class InIt, class = std::enable_if_t<detail::is_iterator_v<InIt>>>
+		iterator insert(const_iterator pos, InIt first, InIt last) {
 			assert(iterator_in_range(pos) && "Iterator out of range!");
 			difference_type off = pos - cbegin();
-			if (first == last)
+			difference_type old_size = size();
+			// Grow from the end nearer to pos, so only the shorter side is rotated
+			if (off < old_size / 2) {
+				for (; first != last; ++first)
+					append_front(*first);
+				difference_type count = difference_type(size()) - old_size;
+				std::reverse(begin(), begin() + count);
+				std::rotate(begin(), begin() + count, begin() + count + off);
 				return begin() + off;
-			iterator it = begin() + off;
-			while (last != first)
-				it = insert(it, *--last);
-			return it;
+			}
+			for (; first != last; ++first)
+				append_back(*first);
+			std::rotate(begin() + off, begin() + old_size, end());
+			return begin() + off;
 		}
 
 		iterator insert(const_iterator pos, std::initializer_list<value_type> list) {
@@ -529,16 +541,24 @@ namespace ancillary {
 		iterator erase(const_iterator first, const_iterator last) {
 			assert(iterator_in_range(first) && "Iterator out of range!");
 			assert(iterator_in_range(last) && "Iterator out of range!");
-			assert(first != cend() && "Iterator must be dereferenceable!");
 			assert(first <= last && "Invalid range!");
 			difference_type off_first = first - cbegin();
-			size_type dist = last - first;
-			if (first == last)
+			difference_type off_last = last - cbegin();
+			difference_type dist = off_last - off_first;
+			if (dist == 0)
 				return begin() + off_first;
-			iterator it = begin() + off_first;
-			for (size_type i = 0; i != dist; ++i)
-				it = erase(it);
-			return it;
+			// Shift whichever side of the gap is shorter
+			if (off_first < static_cast<difference_type>(size()) - off_last) {
+				std::move_backward(begin(), begin() + off_first, begin() + off_last);
+				for (difference_type i = 0; i != dist; ++i)
+					remove_front();
+			}
+			else {
+				std::move(begin() + off_last, end(), begin() + off_first);
+				for (difference_type i = 0; i != dist; ++i)
+					remove_back();
+			}
+			return begin() + off_first;
 		}
 
 		void push_front(const T& value) { append_front(value); }
@@ -11,11 +11,14 @@ namespace ancillary {
 		class Key,
 		class T,
 		class Compare = std::less<Key>,
-		class Allocator = std::allocator<std::pair<Key, T>>
+		class Allocator = std::allocator<std::pair<Key, T>>,
+		class SearchPolicy = binary_search_policy,
+		class Container = std::vector<std::pair<Key, T>, Allocator>
 	> struct flat_map 
-		: detail::flat_tree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>, false>
+		: detail::flat_tree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>, false, SearchPolicy, Container>
 	{
-		using tree_type = detail::flat_tree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>, false>;
+		using tree_type = detail::flat_tree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>, false, SearchPolicy, Container>;
+		using typename tree_type::container_type;
 		using typename tree_type::key_type;
 		using mapped_type = T;
 		using typename tree_type::value_type;
@@ -35,40 +38,71 @@ namespace ancillary {
 
 		flat_map() = default;
 
-		explicit flat_map(const Compare& comp, const Allocator& alloc = Allocator())
+		explicit flat_map(const Compare& comp, const allocator_type& alloc = allocator_type())
 			: tree_type(comp, alloc) {}
 
-		explicit flat_map(const Allocator& alloc)
+		explicit flat_map(const allocator_type& alloc)
 			: tree_type(alloc) {}
 
 		template <class InIt>
 		flat_map(InIt first, InIt last,
 			const Compare& comp = Compare(),
-			const Allocator& alloc = Allocator())
+			const allocator_type& alloc = allocator_type())
 			: tree_type(first, last, comp, alloc) {}
 
 		template <class InIt>
 		flat_map(InIt first, InIt last,
-			const Allocator& alloc)
+			const allocator_type& alloc)
 			: tree_type(first, last, alloc) {}
 
+		template <class InIt>
+		flat_map(const execution::parallel_policy& policy, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(policy, first, last, comp, alloc) {}
+
+		template <class InIt>
+		flat_map(const execution::parallel_policy& policy, InIt first, InIt last,
+			const allocator_type& alloc)
+			: tree_type(policy, first, last, alloc) {}
+
+		template <class InIt>
+		flat_map(sorted_unique_t tag, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(tag, first, last, comp, alloc) {}
+
+		template <class InIt>
+		flat_map(sorted_unique_t tag, InIt first, InIt last,
+			const allocator_type& alloc)
+			: tree_type(tag, first, last, alloc) {}
+
 		flat_map(const flat_map&) = default;
-		flat_map(const flat_map& other, const Allocator& alloc)
+		flat_map(const flat_map& other, const allocator_type& alloc)
 			: tree_type(other, alloc) {}
 
 		flat_map(flat_map&&) = default;
-		flat_map(flat_map&& other, const Allocator& alloc)
+		flat_map(flat_map&& other, const allocator_type& alloc)
 			: tree_type(std::move(other), alloc) {}
 
 		flat_map(std::initializer_list<value_type> list,
 			const Compare& comp = Compare(),
-			const Allocator& alloc = Allocator())
+			const allocator_type& alloc = allocator_type())
 			: tree_type(list, comp, alloc) {}
 
 		flat_map(std::initializer_list<value_type> list,
-			const Allocator& alloc)
+			const allocator_type& alloc)
 			: tree_type(list, alloc) {}
 
+		flat_map(sorted_unique_t tag, std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(tag, list, comp, alloc) {}
+
+		flat_map(sorted_unique_t tag, std::initializer_list<value_type> list,
+			const allocator_type& alloc)
+			: tree_type(tag, list, alloc) {}
+
 		~flat_map() = default;
 
 		flat_map& operator=(const flat_map&) = default;
@@ -93,109 +127,51 @@ namespace ancillary {
 		}
 
 		mapped_type& operator[](const key_type& key) {
-			auto it = find(key);
-			if (it != end())
-				return it->second;
-			else
-				return try_emplace(key).first->second;
+			return try_emplace(key).first->second;
 		}
 
 		mapped_type& operator[](key_type&& key) {
-			auto it = find(key);
-			if (it != end())
-				return it->second;
-			else
-				return try_emplace(std::move(key)).first->second;
+			return try_emplace(std::move(key)).first->second;
 		}
 
 		template <class M>
 		std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
-			auto it = find(k);
-			if (it != end()) {
-				it->second = std::forward<M>(obj);
-				return { it, false };
-			}
-			else
-				return emplace(k, std::forward<M>(obj));
+			return assign_or_emplace(lower_bound(k), k, std::forward<M>(obj));
 		}
 
 		template <class M>
 		std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
-			auto it = find(k);
-			if (it != end()) {
-				it->second = std::forward<M>(obj);
-				return { it, false };
-			}
-			else
-				return emplace(std::move(k), std::forward<M>(obj));
+			return assign_or_emplace(lower_bound(k), std::move(k), std::forward<M>(obj));
 		}
 
 		template <class M>
 		iterator insert_or_assign(const_iterator hint, const key_type& k, M&& obj) {
-			auto it = find(k);
-			if (it != end()) {
-				it->second = std::forward<M>(obj);
-				return it;
-			}
-			else
-				return emplace_hint(hint, k, std::forward<M>(obj));
+			return assign_or_emplace(tree_type::lower_bound_hint(hint, k), k, std::forward<M>(obj)).first;
 		}
 
 		template <class M>
 		iterator insert_or_assign(const_iterator hint, key_type&& k, M&& obj) {
-			auto it = find(k);
-			if (it != end()) {
-				it->second = std::forward<M>(obj);
-				return it;
-			}
-			else
-				return emplace_hint(hint, std::move(k), std::forward<M>(obj));
+			return assign_or_emplace(tree_type::lower_bound_hint(hint, k), std::move(k), std::forward<M>(obj)).first;
 		}
 
 		template <class... Args>
 		std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
-			auto it = find(k);
-			if (it != end())
-				return { it, false };
-			else
-				return emplace(std::piecewise_construct,
-					std::forward_as_tuple(k),
-					std::forward_as_tuple(std::forward<Args>(args)...));
+			return try_emplace_at(lower_bound(k), k, std::forward<Args>(args)...);
 		}
 
 		template <class... Args>
 		std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
-			auto it = find(k);
-			if (it != end())
-				return { it, false };
-			else
-				return emplace(std::piecewise_construct,
-					std::forward_as_tuple(std::move(k)),
-					std::forward_as_tuple(std::forward<Args>(args)...));
+			return try_emplace_at(lower_bound(k), std::move(k), std::forward<Args>(args)...);
 		}
 
 		template <class... Args>
 		iterator try_emplace(const_iterator hint, const key_type& k, Args&&... args) {
-			auto it = find(k);
-			if (it != end())
-				return it;
-			else
-				return emplace_hint(hint,
-					std::piecewise_construct,
-					std::forward_as_tuple(k),
-					std::forward_as_tuple(std::forward<Args>(args)...));
+			return try_emplace_at(tree_type::lower_bound_hint(hint, k), k, std::forward<Args>(args)...).first;
 		}
 
 		template <class... Args>
 		iterator try_emplace(const_iterator hint, key_type&& k, Args&&... args) {
-			auto it = find(k);
-			if (it != end())
-				return it;
-			else
-				return emplace_hint(hint,
-					std::piecewise_construct,
-					std::forward_as_tuple(std::move(k)),
-					std::forward_as_tuple(std::forward<Args>(args)...));
+			return try_emplace_at(tree_type::lower_bound_hint(hint, k), std::move(k), std::forward<Args>(args)...).first;
 		}
 
 		using tree_type::begin;
@@ -220,11 +196,16 @@ namespace ancillary {
 		using tree_type::emplace;
 		using tree_type::emplace_hint;
 		using tree_type::erase;
+		using tree_type::extract;
+		using tree_type::replace;
+		using tree_type::merge;
 		using tree_type::swap;
 
 		using tree_type::count;
 		using tree_type::find;
 		using tree_type::contains;
+		using tree_type::find_many;
+		using tree_type::contains_many;
 		using tree_type::equal_range;
 		using tree_type::lower_bound;
 		using tree_type::upper_bound;
@@ -232,15 +213,37 @@ namespace ancillary {
 		using tree_type::key_comp;
 		using tree_type::value_comp;
 
+	private:
+
+		// Given the lower bound of k, constructs the element there only if k is absent
+		template <class K, class... Args>
+		std::pair<iterator, bool> try_emplace_at(iterator lower, K&& k, Args&&... args) {
+			if (lower != end() && !key_comp()(k, lower->first))
+				return { lower, false };
+			return { tree_type::emplace_at(lower,
+				std::piecewise_construct,
+				std::forward_as_tuple(std::forward<K>(k)),
+				std::forward_as_tuple(std::forward<Args>(args)...)), true };
+		}
+
+		template <class K, class M>
+		std::pair<iterator, bool> assign_or_emplace(iterator lower, K&& k, M&& obj) {
+			if (lower != end() && !key_comp()(k, lower->first)) {
+				lower->second = std::forward<M>(obj);
+				return { lower, false };
+			}
+			return { tree_type::emplace_at(lower, std::forward<K>(k), std::forward<M>(obj)), true };
+		}
+
 	};
 
 }
 
 namespace std {
-	template <class Key, class Compare, class Allocator>
+	template <class Key, class T, class Compare, class Allocator, class SearchPolicy, class Container>
 	void swap(
-		ancillary::flat_map<Key, Compare, Allocator>& lhs,
-		ancillary::flat_map<Key, Compare, Allocator>& rhs)
+		ancillary::flat_map<Key, T, Compare, Allocator, SearchPolicy, Container>& lhs,
+		ancillary::flat_map<Key, T, Compare, Allocator, SearchPolicy, Container>& rhs)
 	{
 		return lhs.swap(rhs);
 	}
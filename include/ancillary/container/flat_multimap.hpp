@@ -9,11 +9,14 @@ namespace ancillary {
 		class Key,
 		class T,
 		class Compare = std::less<Key>,
-		class Allocator = std::allocator<std::pair<Key, T>>
+		class Allocator = std::allocator<std::pair<Key, T>>,
+		class SearchPolicy = binary_search_policy,
+		class Container = std::vector<std::pair<Key, T>, Allocator>
 	> struct flat_multimap
-		: detail::flat_tree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>, true>
+		: detail::flat_tree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>, true, SearchPolicy, Container>
 	{
-		using tree_type = detail::flat_tree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>, true>;
+		using tree_type = detail::flat_tree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>, true, SearchPolicy, Container>;
+		using typename tree_type::container_type;
 		using typename tree_type::key_type;
 		using mapped_type = T;
 		using typename tree_type::value_type;
@@ -33,40 +36,71 @@ namespace ancillary {
 
 		flat_multimap() = default;
 
-		explicit flat_multimap(const Compare& comp, const Allocator& alloc = Allocator())
+		explicit flat_multimap(const Compare& comp, const allocator_type& alloc = allocator_type())
 			: tree_type(comp, alloc) {}
 
-		explicit flat_multimap(const Allocator& alloc)
+		explicit flat_multimap(const allocator_type& alloc)
 			: tree_type(alloc) {}
 
 		template <class InIt>
 		flat_multimap(InIt first, InIt last,
 			const Compare& comp = Compare(),
-			const Allocator& alloc = Allocator())
+			const allocator_type& alloc = allocator_type())
 			: tree_type(first, last, comp, alloc) {}
 
 		template <class InIt>
 		flat_multimap(InIt first, InIt last,
-			const Allocator& alloc)
+			const allocator_type& alloc)
 			: tree_type(first, last, alloc) {}
 
+		template <class InIt>
+		flat_multimap(const execution::parallel_policy& policy, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(policy, first, last, comp, alloc) {}
+
+		template <class InIt>
+		flat_multimap(const execution::parallel_policy& policy, InIt first, InIt last,
+			const allocator_type& alloc)
+			: tree_type(policy, first, last, alloc) {}
+
+		template <class InIt>
+		flat_multimap(sorted_equivalent_t tag, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(tag, first, last, comp, alloc) {}
+
+		template <class InIt>
+		flat_multimap(sorted_equivalent_t tag, InIt first, InIt last,
+			const allocator_type& alloc)
+			: tree_type(tag, first, last, alloc) {}
+
 		flat_multimap(const flat_multimap&) = default;
-		flat_multimap(const flat_multimap& other, const Allocator& alloc)
+		flat_multimap(const flat_multimap& other, const allocator_type& alloc)
 			: tree_type(other, alloc) {}
 
 		flat_multimap(flat_multimap&&) = default;
-		flat_multimap(flat_multimap&& other, const Allocator& alloc)
+		flat_multimap(flat_multimap&& other, const allocator_type& alloc)
 			: tree_type(std::move(other), alloc) {}
 
 		flat_multimap(std::initializer_list<value_type> list,
 			const Compare& comp = Compare(),
-			const Allocator& alloc = Allocator())
+			const allocator_type& alloc = allocator_type())
 			: tree_type(list, comp, alloc) {}
 
 		flat_multimap(std::initializer_list<value_type> list,
-			const Allocator& alloc)
+			const allocator_type& alloc)
 			: tree_type(list, alloc) {}
 
+		flat_multimap(sorted_equivalent_t tag, std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(tag, list, comp, alloc) {}
+
+		flat_multimap(sorted_equivalent_t tag, std::initializer_list<value_type> list,
+			const allocator_type& alloc)
+			: tree_type(tag, list, alloc) {}
+
 		~flat_multimap() = default;
 
 		flat_multimap& operator=(const flat_multimap&) = default;
@@ -100,11 +134,16 @@ namespace ancillary {
 		using tree_type::emplace;
 		using tree_type::emplace_hint;
 		using tree_type::erase;
+		using tree_type::extract;
+		using tree_type::replace;
+		using tree_type::merge;
 		using tree_type::swap;
 
 		using tree_type::count;
 		using tree_type::find;
 		using tree_type::contains;
+		using tree_type::find_many;
+		using tree_type::contains_many;
 		using tree_type::equal_range;
 		using tree_type::lower_bound;
 		using tree_type::upper_bound;
@@ -117,10 +156,10 @@ namespace ancillary {
 }
 
 namespace std {
-	template <class Key, class Compare, class Allocator>
+	template <class Key, class T, class Compare, class Allocator, class SearchPolicy, class Container>
 	void swap(
-		ancillary::flat_multimap<Key, Compare, Allocator>& lhs,
-		ancillary::flat_multimap<Key, Compare, Allocator>& rhs)
+		ancillary::flat_multimap<Key, T, Compare, Allocator, SearchPolicy, Container>& lhs,
+		ancillary::flat_multimap<Key, T, Compare, Allocator, SearchPolicy, Container>& rhs)
 	{
 		return lhs.swap(rhs);
 	}
@@ -8,10 +8,13 @@ namespace ancillary {
 	template <
 		class Key,
 		class Compare = std::less<Key>,
-		class Allocator = std::allocator<Key>
-	> struct flat_multiset : detail::flat_tree<Key, Compare, Allocator, detail::identity<Key>, true>
+		class Allocator = std::allocator<Key>,
+		class SearchPolicy = binary_search_policy,
+		class Container = std::vector<Key, Allocator>
+	> struct flat_multiset : detail::flat_tree<Key, Compare, Allocator, detail::identity<Key>, true, SearchPolicy, Container>
 	{
-		using tree_type = detail::flat_tree<Key, Compare, Allocator, detail::identity<Key>, true>;
+		using tree_type = detail::flat_tree<Key, Compare, Allocator, detail::identity<Key>, true, SearchPolicy, Container>;
+		using typename tree_type::container_type;
 		using typename tree_type::key_type;
 		using typename tree_type::value_type;
 		using typename tree_type::key_compare;
@@ -30,40 +33,71 @@ namespace ancillary {
 
 		flat_multiset() = default;
 
-		explicit flat_multiset(const Compare& comp, const Allocator& alloc = Allocator())
+		explicit flat_multiset(const Compare& comp, const allocator_type& alloc = allocator_type())
 			: tree_type(comp, alloc) {}
 
-		explicit flat_multiset(const Allocator& alloc)
+		explicit flat_multiset(const allocator_type& alloc)
 			: tree_type(alloc) {}
 
 		template <class InIt>
 		flat_multiset(InIt first, InIt last,
 			const Compare& comp = Compare(),
-			const Allocator& alloc = Allocator())
+			const allocator_type& alloc = allocator_type())
 			: tree_type(first, last, comp, alloc) {}
 
 		template <class InIt>
 		flat_multiset(InIt first, InIt last,
-			const Allocator& alloc)
+			const allocator_type& alloc)
 			: tree_type(first, last, alloc) {}
 
+		template <class InIt>
+		flat_multiset(const execution::parallel_policy& policy, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(policy, first, last, comp, alloc) {}
+
+		template <class InIt>
+		flat_multiset(const execution::parallel_policy& policy, InIt first, InIt last,
+			const allocator_type& alloc)
+			: tree_type(policy, first, last, alloc) {}
+
+		template <class InIt>
+		flat_multiset(sorted_equivalent_t tag, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(tag, first, last, comp, alloc) {}
+
+		template <class InIt>
+		flat_multiset(sorted_equivalent_t tag, InIt first, InIt last,
+			const allocator_type& alloc)
+			: tree_type(tag, first, last, alloc) {}
+
 		flat_multiset(const flat_multiset&) = default;
-		flat_multiset(const flat_multiset& other, const Allocator& alloc)
+		flat_multiset(const flat_multiset& other, const allocator_type& alloc)
 			: tree_type(other, alloc) {}
 
 		flat_multiset(flat_multiset&&) = default;
-		flat_multiset(flat_multiset&& other, const Allocator& alloc)
+		flat_multiset(flat_multiset&& other, const allocator_type& alloc)
 			: tree_type(std::move(other), alloc) {}
 
 		flat_multiset(std::initializer_list<value_type> list,
 			const Compare& comp = Compare(),
-			const Allocator& alloc = Allocator())
+			const allocator_type& alloc = allocator_type())
 			: tree_type(list, comp, alloc) {}
 
 		flat_multiset(std::initializer_list<value_type> list,
-			const Allocator& alloc)
+			const allocator_type& alloc)
 			: tree_type(list, alloc) {}
 
+		flat_multiset(sorted_equivalent_t tag, std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(tag, list, comp, alloc) {}
+
+		flat_multiset(sorted_equivalent_t tag, std::initializer_list<value_type> list,
+			const allocator_type& alloc)
+			: tree_type(tag, list, alloc) {}
+
 		~flat_multiset() = default;
 
 		flat_multiset& operator=(const flat_multiset&) = default;
@@ -97,11 +131,16 @@ namespace ancillary {
 		using tree_type::emplace;
 		using tree_type::emplace_hint;
 		using tree_type::erase;
+		using tree_type::extract;
+		using tree_type::replace;
+		using tree_type::merge;
 		using tree_type::swap;
 
 		using tree_type::count;
 		using tree_type::find;
 		using tree_type::contains;
+		using tree_type::find_many;
+		using tree_type::contains_many;
 		using tree_type::equal_range;
 		using tree_type::lower_bound;
 		using tree_type::upper_bound;
@@ -115,10 +154,10 @@ namespace ancillary {
 }
 
 namespace std {
-	template <class Key, class Compare, class Allocator>
+	template <class Key, class Compare, class Allocator, class SearchPolicy, class Container>
 	void swap(
-		ancillary::flat_multiset<Key, Compare, Allocator>& lhs,
-		ancillary::flat_multiset<Key, Compare, Allocator>& rhs)
+		ancillary::flat_multiset<Key, Compare, Allocator, SearchPolicy, Container>& lhs,
+		ancillary::flat_multiset<Key, Compare, Allocator, SearchPolicy, Container>& rhs)
 	{
 		return lhs.swap(rhs);
 	}
@@ -0,0 +1,399 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include "flat_map.hpp"
+#include "../detail/zip_iterator.hpp"
+
+namespace ancillary {
+	namespace detail {
+
+		inline void put_varint(std::vector<char>& out, std::size_t value) {
+			while (value >= 0x80) {
+				out.push_back(static_cast<char>(value | 0x80));
+				value >>= 7;
+			}
+			out.push_back(static_cast<char>(value));
+		}
+
+		inline std::size_t get_varint(const char*& p) noexcept {
+			std::size_t value = 0;
+			unsigned shift = 0;
+			for (;; shift += 7) {
+				auto byte = static_cast<unsigned char>(*p++);
+				value |= static_cast<std::size_t>(byte & 0x7f) << shift;
+				if (byte < 0x80)
+					return value;
+			}
+		}
+
+		inline std::size_t common_prefix(std::string_view a, std::string_view b) noexcept {
+			auto n = std::min(a.size(), b.size());
+			std::size_t i = 0;
+			while (i < n && a[i] == b[i])
+				++i;
+			return i;
+		}
+
+		// Iterates a front_coded_flat_map in key order. Keys are not stored whole, so
+		// dereferencing restores the key at the current position from its block head
+		// and yields it by value alongside a reference to the mapped value. Since the
+		// reference is a proxy the iterator only models an input iterator, though it
+		// supports the random access arithmetic of the underlying positions.
+		template <
+			class Map,
+			bool isConst
+		> class front_coded_iterator {
+		public:
+			using map_pointer = std::conditional_t<isConst, const Map*, Map*>;
+			using mapped_reference = std::conditional_t<isConst, const typename Map::mapped_type&, typename Map::mapped_type&>;
+
+			using iterator_category = std::input_iterator_tag;
+			using value_type = typename Map::value_type;
+			using difference_type = std::ptrdiff_t;
+			using reference = std::pair<std::string, mapped_reference>;
+			using pointer = arrow_proxy<reference>;
+
+			template <class, bool>
+			friend class front_coded_iterator;
+
+			front_coded_iterator() noexcept = default;
+
+			front_coded_iterator(map_pointer parent, std::size_t index) noexcept
+				: m_parent(parent)
+				, m_index(index) {}
+
+			template <bool wasConst, class = std::enable_if_t<isConst && !wasConst>>
+			front_coded_iterator(const front_coded_iterator<Map, wasConst>& other) noexcept
+				: m_parent(other.m_parent)
+				, m_index(other.m_index) {}
+
+			std::size_t index() const noexcept { return m_index; }
+
+			std::string key() const {
+				assert(m_index < m_parent->size() && "Bad iterator dereference!");
+				return m_parent->restore(m_index);
+			}
+
+			reference operator*() const { return { key(), m_parent->m_values[m_index] }; }
+			pointer operator->() const { return { **this }; }
+			reference operator[](difference_type n) const { return *(*this + n); }
+
+			front_coded_iterator& operator++() { ++m_index; return *this; }
+			front_coded_iterator operator++(int) { front_coded_iterator tmp(*this); ++*this; return tmp; }
+			front_coded_iterator& operator--() { --m_index; return *this; }
+			front_coded_iterator operator--(int) { front_coded_iterator tmp(*this); --*this; return tmp; }
+
+			front_coded_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+			front_coded_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+			front_coded_iterator operator+(difference_type n) const { return front_coded_iterator(*this) += n; }
+			front_coded_iterator operator-(difference_type n) const { return front_coded_iterator(*this) -= n; }
+			friend front_coded_iterator operator+(difference_type n, const front_coded_iterator& it) { return it + n; }
+
+			template <bool otherConst>
+			difference_type operator-(const front_coded_iterator<Map, otherConst>& other) const {
+				return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+			}
+
+			template <bool otherConst>
+			bool operator==(const front_coded_iterator<Map, otherConst>& other) const { return m_index == other.m_index; }
+			template <bool otherConst>
+			bool operator!=(const front_coded_iterator<Map, otherConst>& other) const { return m_index != other.m_index; }
+			template <bool otherConst>
+			bool operator<(const front_coded_iterator<Map, otherConst>& other) const { return m_index < other.m_index; }
+			template <bool otherConst>
+			bool operator>(const front_coded_iterator<Map, otherConst>& other) const { return m_index > other.m_index; }
+			template <bool otherConst>
+			bool operator<=(const front_coded_iterator<Map, otherConst>& other) const { return m_index <= other.m_index; }
+			template <bool otherConst>
+			bool operator>=(const front_coded_iterator<Map, otherConst>& other) const { return m_index >= other.m_index; }
+
+		private:
+			map_pointer m_parent = nullptr;
+			std::size_t m_index = 0;
+		};
+
+	}
+
+	// A sorted map from std::string keys that stores every key in one contiguous
+	// character arena using front coding. Keys are cut into blocks of BlockSize; the
+	// first key of a block is stored whole and every other key as the length of the
+	// prefix it shares with its predecessor followed by the remaining suffix. Lookups
+	// binary search the block heads and then scan one block, comparing the search key
+	// against shared prefixes without rebuilding any key. Keys are ordered as by
+	// std::less<std::string> and are looked up through std::string_view. The key set
+	// is fixed once built; mapped values remain mutable.
+	template <
+		class T,
+		std::size_t BlockSize = 16
+	> class front_coded_flat_map {
+	public:
+
+		static_assert(BlockSize > 0, "Blocks must hold at least one key!");
+
+		using key_type               = std::string;
+		using mapped_type            = T;
+		using value_type             = std::pair<std::string, T>;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = std::pair<std::string, T&>;
+		using const_reference        = std::pair<std::string, const T&>;
+		using iterator               = detail::front_coded_iterator<front_coded_flat_map, false>;
+		using const_iterator         = detail::front_coded_iterator<front_coded_flat_map, true>;
+		using flat_map_type          = flat_map<std::string, T>;
+
+		friend iterator;
+		friend const_iterator;
+
+		static constexpr size_type block_size = BlockSize;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                  CONSTRUCTORS                                  //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		front_coded_flat_map() = default;
+
+		explicit front_coded_flat_map(const flat_map_type& map)
+			: front_coded_flat_map(flat_map_type(map)) {}
+
+		explicit front_coded_flat_map(flat_map_type&& map) {
+			build(std::move(map).extract());
+		}
+
+		template <class InIt>
+		front_coded_flat_map(InIt first, InIt last)
+			: front_coded_flat_map(flat_map_type(first, last)) {}
+
+		template <class InIt>
+		front_coded_flat_map(sorted_unique_t tag, InIt first, InIt last)
+			: front_coded_flat_map(flat_map_type(tag, first, last)) {}
+
+		front_coded_flat_map(std::initializer_list<value_type> list)
+			: front_coded_flat_map(flat_map_type(list)) {}
+
+		front_coded_flat_map(sorted_unique_t tag, std::initializer_list<value_type> list)
+			: front_coded_flat_map(flat_map_type(tag, list)) {}
+
+		front_coded_flat_map(const front_coded_flat_map&) = default;
+		front_coded_flat_map(front_coded_flat_map&&) = default;
+
+		~front_coded_flat_map() = default;
+
+		front_coded_flat_map& operator=(const front_coded_flat_map&) = default;
+		front_coded_flat_map& operator=(front_coded_flat_map&&) = default;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    ITERATORS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		iterator begin() noexcept { return { this, 0 }; }
+		const_iterator begin() const noexcept { return { this, 0 }; }
+		const_iterator cbegin() const noexcept { return begin(); }
+
+		iterator end() noexcept { return { this, size() }; }
+		const_iterator end() const noexcept { return { this, size() }; }
+		const_iterator cend() const noexcept { return end(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    CAPACITY                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		bool empty() const noexcept { return m_values.empty(); }
+		size_type size() const noexcept { return m_values.size(); }
+
+		// Bytes spent on keys: the arena plus one offset per block
+		size_type key_bytes() const noexcept {
+			return m_arena.capacity() + m_blocks.capacity() * sizeof(size_type);
+		}
+
+		void shrink_to_fit() {
+			m_arena.shrink_to_fit();
+			m_blocks.shrink_to_fit();
+			m_values.shrink_to_fit();
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     LOOKUP                                     //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		T& at(std::string_view key) {
+			auto [i, found] = locate(key);
+			if (!found)
+				throw std::out_of_range("No such element with the given key!");
+			else
+				return m_values[i];
+		}
+
+		const T& at(std::string_view key) const {
+			auto [i, found] = locate(key);
+			if (!found)
+				throw std::out_of_range("No such element with the given key!");
+			else
+				return m_values[i];
+		}
+
+		size_type count(std::string_view key) const { return contains(key); }
+
+		iterator find(std::string_view key) {
+			auto [i, found] = locate(key);
+			return { this, found ? i : size() };
+		}
+
+		const_iterator find(std::string_view key) const {
+			auto [i, found] = locate(key);
+			return { this, found ? i : size() };
+		}
+
+		bool contains(std::string_view key) const { return locate(key).second; }
+
+		std::pair<iterator, iterator> equal_range(std::string_view key) {
+			auto [i, found] = locate(key);
+			return { iterator(this, i), iterator(this, i + found) };
+		}
+
+		std::pair<const_iterator, const_iterator> equal_range(std::string_view key) const {
+			auto [i, found] = locate(key);
+			return { const_iterator(this, i), const_iterator(this, i + found) };
+		}
+
+		iterator lower_bound(std::string_view key) { return { this, locate(key).first }; }
+		const_iterator lower_bound(std::string_view key) const { return { this, locate(key).first }; }
+
+		iterator upper_bound(std::string_view key) {
+			auto [i, found] = locate(key);
+			return { this, i + found };
+		}
+
+		const_iterator upper_bound(std::string_view key) const {
+			auto [i, found] = locate(key);
+			return { this, i + found };
+		}
+
+		const std::vector<T>& values() const noexcept { return m_values; }
+
+	private:
+
+		void build(std::vector<value_type>&& sorted) {
+			m_blocks.reserve((sorted.size() + BlockSize - 1) / BlockSize);
+			m_values.reserve(sorted.size());
+			std::string_view prev;
+			for (size_type i = 0; i < sorted.size(); ++i) {
+				std::string_view key = sorted[i].first;
+				if (i % BlockSize == 0) {
+					m_blocks.push_back(m_arena.size());
+					detail::put_varint(m_arena, key.size());
+					m_arena.insert(m_arena.end(), key.begin(), key.end());
+				}
+				else {
+					auto shared = detail::common_prefix(prev, key);
+					detail::put_varint(m_arena, shared);
+					detail::put_varint(m_arena, key.size() - shared);
+					m_arena.insert(m_arena.end(), key.begin() + shared, key.end());
+				}
+				prev = key;
+				m_values.push_back(std::move(sorted[i].second));
+			}
+		}
+
+		std::string_view block_head(size_type block) const noexcept {
+			const char* p = m_arena.data() + m_blocks[block];
+			auto len = detail::get_varint(p);
+			return { p, len };
+		}
+
+		// Index of the first key not less than key, and whether that key equals it
+		std::pair<size_type, bool> locate(std::string_view key) const {
+			// The last block whose head is not greater than key
+			size_type lo = 0, len = m_blocks.size();
+			while (len > 0) {
+				size_type step = len / 2;
+				if (!(key < block_head(lo + step))) {
+					lo += step + 1;
+					len -= step + 1;
+				}
+				else
+					len = step;
+			}
+			if (lo == 0)
+				return { 0, false };
+			const size_type block = lo - 1;
+			const size_type first = block * BlockSize;
+			const size_type last = std::min(first + BlockSize, size());
+
+			const char* p = m_arena.data() + m_blocks[block];
+			auto head_len = detail::get_varint(p);
+			std::string_view head(p, head_len);
+			p += head_len;
+			// The keys before position i are all less than key and the last of them
+			// matches key on exactly `match` leading characters
+			size_type match = detail::common_prefix(head, key);
+			if (match == key.size() && match == head.size())
+				return { first, true };
+			for (size_type i = first + 1; i < last; ++i) {
+				auto shared = detail::get_varint(p);
+				auto suffix_len = detail::get_varint(p);
+				const char* suffix = p;
+				p += suffix_len;
+				if (shared < match)
+					return { i, false };
+				if (shared > match)
+					continue;
+				auto rest = key.substr(match);
+				auto l = detail::common_prefix({ suffix, suffix_len }, rest);
+				if (l == rest.size())
+					return { i, l == suffix_len };
+				if (l < suffix_len && static_cast<unsigned char>(suffix[l]) > static_cast<unsigned char>(rest[l]))
+					return { i, false };
+				match += l;
+			}
+			return { last, false };
+		}
+
+		// Restores the key at index by replaying its block from the head
+		std::string restore(size_type index) const {
+			const size_type block = index / BlockSize;
+			const char* p = m_arena.data() + m_blocks[block];
+			auto len = detail::get_varint(p);
+			std::string key(p, len);
+			p += len;
+			for (size_type i = block * BlockSize; i < index; ++i) {
+				auto shared = detail::get_varint(p);
+				auto suffix_len = detail::get_varint(p);
+				key.resize(shared);
+				key.append(p, suffix_len);
+				p += suffix_len;
+			}
+			return key;
+		}
+
+		std::vector<char> m_arena; // Front coded keys
+		std::vector<size_type> m_blocks; // Arena offset of each block
+		std::vector<T> m_values; // Mapped values in key order
+
+	};
+
+	template <class T, std::size_t BlockSize>
+	bool operator==(
+		const front_coded_flat_map<T, BlockSize>& lhs,
+		const front_coded_flat_map<T, BlockSize>& rhs)
+	{
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <class T, std::size_t BlockSize>
+	bool operator!=(
+		const front_coded_flat_map<T, BlockSize>& lhs,
+		const front_coded_flat_map<T, BlockSize>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+}
@@ -0,0 +1,418 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include "flat_map.hpp"
+#include "../detail/prefetch.hpp"
+
+namespace ancillary {
+	namespace detail {
+
+		inline unsigned countr_one(std::size_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<unsigned>(__builtin_ctzll(~static_cast<unsigned long long>(x)));
+#else
+			unsigned n = 0;
+			for (; x & 1; x >>= 1)
+				++n;
+			return n;
+#endif
+		}
+
+		// Navigation over an implicit 1-indexed Eytzinger tree of n nodes, where the
+		// children of node k are 2k and 2k + 1. Index 0 is the past-the-end position.
+		struct eytzinger {
+			static std::size_t first(std::size_t n) noexcept {
+				if (n == 0)
+					return 0;
+				std::size_t k = 1;
+				while (2 * k <= n)
+					k *= 2;
+				return k;
+			}
+
+			static std::size_t last(std::size_t n) noexcept {
+				if (n == 0)
+					return 0;
+				std::size_t k = 1;
+				while (2 * k + 1 <= n)
+					k = 2 * k + 1;
+				return k;
+			}
+
+			static std::size_t next(std::size_t k, std::size_t n) noexcept {
+				if (2 * k + 1 <= n) {
+					k = 2 * k + 1;
+					while (2 * k <= n)
+						k *= 2;
+					return k;
+				}
+				return k >> (countr_one(k) + 1);
+			}
+
+			static std::size_t prev(std::size_t k, std::size_t n) noexcept {
+				if (k == 0)
+					return last(n);
+				if (2 * k <= n) {
+					k = 2 * k;
+					while (2 * k + 1 <= n)
+						k = 2 * k + 1;
+					return k;
+				}
+				return k >> (countr_one(~k) + 1);
+			}
+		};
+
+		template <
+			class Map
+		> class frozen_flat_map_iterator {
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = typename Map::value_type;
+			using difference_type = typename Map::difference_type;
+			using reference = typename Map::const_reference;
+			using pointer = typename Map::const_pointer;
+
+			frozen_flat_map_iterator() noexcept = default;
+
+			frozen_flat_map_iterator(const Map* parent, std::size_t node) noexcept
+				: m_parent(parent)
+				, m_node(node) {}
+
+			reference operator*() const {
+				return *(operator->());
+			}
+
+			pointer operator->() const {
+				assert(m_node && "Bad iterator dereference!");
+				return m_parent->m_data.data() + (m_node - 1);
+			}
+
+			frozen_flat_map_iterator& operator++() {
+				assert(m_node && "Increment out of bounds!");
+				m_node = eytzinger::next(m_node, m_parent->size());
+				return *this;
+			}
+
+			frozen_flat_map_iterator operator++(int) {
+				frozen_flat_map_iterator tmp(*this);
+				++*this;
+				return tmp;
+			}
+
+			frozen_flat_map_iterator& operator--() {
+				m_node = eytzinger::prev(m_node, m_parent->size());
+				assert(m_node && "Decrement out of bounds!");
+				return *this;
+			}
+
+			frozen_flat_map_iterator operator--(int) {
+				frozen_flat_map_iterator tmp(*this);
+				--*this;
+				return tmp;
+			}
+
+			bool operator==(const frozen_flat_map_iterator& other) const noexcept {
+				return m_node == other.m_node;
+			}
+
+			bool operator!=(const frozen_flat_map_iterator& other) const noexcept {
+				return !(*this == other);
+			}
+
+		private:
+			const Map* m_parent = nullptr;
+			std::size_t m_node = 0;
+		};
+
+	}
+
+	// A read-only map whose elements are stored in Eytzinger (BFS) order. Lookups
+	// descend an implicit tree over a separate key array and prefetch the cache line
+	// holding the descendants a few levels below the current node, which hides most
+	// of the memory latency for tables that do not fit in cache.
+	template <
+		class Key,
+		class T,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<Key, T>>
+	> class frozen_flat_map {
+	public:
+
+		using flat_map_type          = flat_map<Key, T, Compare, Allocator>;
+		using key_type               = Key;
+		using mapped_type            = T;
+		using value_type             = std::pair<Key, T>;
+		using key_compare            = Compare;
+		using value_compare          = typename flat_map_type::value_compare;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using allocator_type         = Allocator;
+		using reference              = const value_type&;
+		using const_reference        = const value_type&;
+		using pointer                = const value_type*;
+		using const_pointer          = const value_type*;
+		using iterator               = detail::frozen_flat_map_iterator<frozen_flat_map>;
+		using const_iterator         = iterator;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = reverse_iterator;
+
+		friend iterator;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                  CONSTRUCTORS                                  //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		frozen_flat_map()
+			: frozen_flat_map(flat_map_type()) {}
+
+		explicit frozen_flat_map(const flat_map_type& map)
+			: frozen_flat_map(flat_map_type(map)) {}
+
+		explicit frozen_flat_map(flat_map_type&& map)
+			: m_data(map.get_allocator())
+			, m_keys(map.get_allocator())
+			, m_kcmp(map.key_comp())
+		{
+			build(std::move(map).extract());
+		}
+
+		template <class InIt>
+		frozen_flat_map(InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const Allocator& alloc = Allocator())
+			: frozen_flat_map(flat_map_type(first, last, comp, alloc)) {}
+
+		frozen_flat_map(std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const Allocator& alloc = Allocator())
+			: frozen_flat_map(flat_map_type(list, comp, alloc)) {}
+
+		frozen_flat_map(const frozen_flat_map& other)
+			: m_data(other.m_data)
+			, m_keys(std::allocator_traits<key_allocator_type>::select_on_container_copy_construction(other.m_keys.get_allocator()))
+			, m_kcmp(other.m_kcmp)
+		{
+			copy_keys(other);
+		}
+
+		frozen_flat_map(frozen_flat_map&&) = default;
+
+		~frozen_flat_map() = default;
+
+		frozen_flat_map& operator=(const frozen_flat_map& other) {
+			if (this != &other) {
+				m_data = other.m_data;
+				m_kcmp = other.m_kcmp;
+				copy_keys(other);
+			}
+			return *this;
+		}
+
+		frozen_flat_map& operator=(frozen_flat_map&& other) {
+			if (this != &other) {
+				const key_type* storage = other.m_keys.data();
+				m_data = std::move(other.m_data);
+				m_keys = std::move(other.m_keys);
+				m_kcmp = std::move(other.m_kcmp);
+				m_offset = other.m_offset;
+				// Allocators that do not propagate move the keys into different storage
+				if (m_keys.data() != storage) {
+					const auto keys = std::move(m_keys);
+					const size_type first = m_offset + 1;
+					assign_keys(size(), [&](size_type i) -> const key_type& { return keys[first + i]; });
+				}
+			}
+			return *this;
+		}
+
+		allocator_type get_allocator() const noexcept { return m_data.get_allocator(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    ITERATORS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		const_iterator begin() const noexcept { return { this, detail::eytzinger::first(size()) }; }
+		const_iterator cbegin() const noexcept { return begin(); }
+
+		const_iterator end() const noexcept { return { this, 0 }; }
+		const_iterator cend() const noexcept { return end(); }
+
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+		const_reverse_iterator crend() const noexcept { return rend(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    CAPACITY                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		bool empty() const noexcept { return m_data.empty(); }
+		size_type size() const noexcept { return m_data.size(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     LOOKUP                                     //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		const mapped_type& at(const key_type& key) const {
+			auto it = find(key);
+			if (it == end())
+				throw std::out_of_range("No such element with the given key!");
+			else
+				return it->second;
+		}
+
+		size_type count(const key_type& key) const { return contains(key); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		size_type count(const K& key) const { return contains(key); }
+
+		const_iterator find(const key_type& key) const { return { this, find_node(key) }; }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator find(const K& key) const { return { this, find_node(key) }; }
+
+		bool contains(const key_type& key) const { return find_node(key) != 0; }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		bool contains(const K& key) const { return find_node(key) != 0; }
+
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+			return { lower_bound(key), upper_bound(key) };
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+			return { lower_bound(key), upper_bound(key) };
+		}
+
+		const_iterator lower_bound(const key_type& key) const {
+			return { this, search([&](const key_type& k) { return m_kcmp(k, key); }) };
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator lower_bound(const K& key) const {
+			return { this, search([&](const key_type& k) { return m_kcmp(k, key); }) };
+		}
+
+		const_iterator upper_bound(const key_type& key) const {
+			return { this, search([&](const key_type& k) { return !m_kcmp(key, k); }) };
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator upper_bound(const K& key) const {
+			return { this, search([&](const key_type& k) { return !m_kcmp(key, k); }) };
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    OBSERVERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		key_compare key_comp() const { return m_kcmp; }
+		value_compare value_comp() const { return value_compare(m_kcmp); }
+
+	private:
+
+		using key_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Key>;
+
+		// Number of keys sharing a cache line, rounded down to a power of two. The keys are
+		// laid out so that node k * block_size starts a cache line whenever the key size is
+		// a power of two, so prefetching it fetches all of the descendants of k
+		// log2(block_size) levels down with one line.
+		static constexpr size_type block_size = [] {
+			size_type block = 1;
+			while (2 * block * sizeof(Key) <= detail::cache_line_size)
+				block *= 2;
+			return block;
+		}();
+
+		void build(std::vector<value_type, Allocator>&& sorted) {
+			const size_type n = sorted.size();
+			std::vector<size_type> rank(n);
+			size_type k = detail::eytzinger::first(n);
+			for (size_type i = 0; i < n; ++i, k = detail::eytzinger::next(k, n))
+				rank[k - 1] = i;
+			assign_keys(n, [&](size_type i) -> const key_type& { return sorted[rank[i]].first; });
+			m_data.reserve(n);
+			for (size_type i = 0; i < n; ++i)
+				m_data.push_back(std::move(sorted[rank[i]]));
+		}
+
+		// Number of slots to skip so that slot 0 of the tree starts a cache line
+		static size_type line_offset(const key_type* storage) noexcept {
+			const auto address = reinterpret_cast<std::uintptr_t>(storage);
+			const auto gap = (detail::cache_line_size - address % detail::cache_line_size) % detail::cache_line_size;
+			return gap % sizeof(Key) == 0 && gap / sizeof(Key) < block_size ? gap / sizeof(Key) : 0;
+		}
+
+		// Stores the n keys returned by key_at(i) in Eytzinger order behind the padding and
+		// the unused slot 0, both filled with copies of the root key
+		template <class KeyAt>
+		void assign_keys(size_type n, KeyAt key_at) {
+			m_keys.clear();
+			m_offset = 0;
+			if (n == 0)
+				return;
+			m_keys.reserve(n + block_size);
+			m_offset = line_offset(m_keys.data());
+			m_keys.insert(m_keys.end(), m_offset + 1, key_at(0));
+			for (size_type i = 0; i < n; ++i)
+				m_keys.push_back(key_at(i));
+		}
+
+		void copy_keys(const frozen_flat_map& other) {
+			const key_type* keys = other.tree_keys();
+			assign_keys(other.size(), [keys](size_type i) -> const key_type& { return keys[i + 1]; });
+		}
+
+		// Node k of the tree is tree_keys()[k]
+		const key_type* tree_keys() const noexcept { return m_keys.empty() ? nullptr : m_keys.data() + m_offset; }
+
+		// Returns the node of the first key for which pred is false, or 0 if there is none
+		template <class Pred>
+		size_type search(Pred pred) const {
+			const size_type n = size();
+			const key_type* keys = tree_keys();
+			size_type k = 1;
+			while (k <= n) {
+				detail::prefetch(keys + std::min(k * block_size, n));
+				k = 2 * k + pred(keys[k]);
+			}
+			return k >> (detail::countr_one(k) + 1);
+		}
+
+		template <class K>
+		size_type find_node(const K& key) const {
+			size_type k = search([&](const key_type& x) { return m_kcmp(x, key); });
+			return k != 0 && !m_kcmp(key, tree_keys()[k]) ? k : 0;
+		}
+
+		std::vector<value_type, Allocator> m_data; // Elements in Eytzinger order
+		std::vector<key_type, key_allocator_type> m_keys; // Keys in Eytzinger order, from slot m_offset + 1
+		size_type m_offset = 0; // Padding before the unused slot 0 of the tree
+		key_compare m_kcmp; // Key comparison
+
+	};
+
+	template <class Key, class T, class Compare, class Allocator>
+	bool operator==(
+		const frozen_flat_map<Key, T, Compare, Allocator>& lhs,
+		const frozen_flat_map<Key, T, Compare, Allocator>& rhs)
+	{
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <class Key, class T, class Compare, class Allocator>
+	bool operator!=(
+		const frozen_flat_map<Key, T, Compare, Allocator>& lhs,
+		const frozen_flat_map<Key, T, Compare, Allocator>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <tuple>
+#include <stdexcept>
+#include "../detail/extract_key.hpp"
+#include "../detail/gapped_flat_tree.hpp"
+
+namespace ancillary {
+
+	// A flat_map stored as a packed memory array. Insertions and erasures move
+	// O(log^2 n) elements amortized instead of O(n), at the cost of up to four slots per
+	// element and iterators that skip over gaps. Both Key and T must be default
+	// constructible, since gap slots hold value-initialized pairs.
+	template <
+		class Key,
+		class T,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<Key, T>>
+	> struct gapped_flat_map
+		: detail::gapped_flat_tree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>>
+	{
+		using tree_type = detail::gapped_flat_tree<std::pair<Key, T>, Compare, Allocator, detail::select1st<std::pair<Key, T>>>;
+		using typename tree_type::container_type;
+		using typename tree_type::key_type;
+		using mapped_type = T;
+		using typename tree_type::value_type;
+		using typename tree_type::key_compare;
+		using typename tree_type::value_compare;
+		using typename tree_type::size_type;
+		using typename tree_type::difference_type;
+		using typename tree_type::allocator_type;
+		using typename tree_type::reference;
+		using typename tree_type::const_reference;
+		using typename tree_type::pointer;
+		using typename tree_type::const_pointer;
+		using typename tree_type::iterator;
+		using typename tree_type::const_iterator;
+		using typename tree_type::reverse_iterator;
+		using typename tree_type::const_reverse_iterator;
+
+		gapped_flat_map() = default;
+
+		explicit gapped_flat_map(const Compare& comp, const allocator_type& alloc = allocator_type())
+			: tree_type(comp, alloc) {}
+
+		explicit gapped_flat_map(const allocator_type& alloc)
+			: tree_type(alloc) {}
+
+		template <class InIt>
+		gapped_flat_map(InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(first, last, comp, alloc) {}
+
+		template <class InIt>
+		gapped_flat_map(sorted_unique_t tag, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(tag, first, last, comp, alloc) {}
+
+		gapped_flat_map(std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(list, comp, alloc) {}
+
+		gapped_flat_map(const gapped_flat_map&) = default;
+		gapped_flat_map(gapped_flat_map&&) = default;
+
+		~gapped_flat_map() = default;
+
+		gapped_flat_map& operator=(const gapped_flat_map&) = default;
+		gapped_flat_map& operator=(gapped_flat_map&&) = default;
+		gapped_flat_map& operator=(std::initializer_list<value_type> list) {
+			tree_type::operator=(list);
+			return *this;
+		}
+
+		using tree_type::get_allocator;
+
+		mapped_type& at(const key_type& key) {
+			return const_cast<mapped_type&>(const_cast<const gapped_flat_map*>(this)->at(key));
+		}
+
+		const mapped_type& at(const key_type& key) const {
+			auto it = find(key);
+			if (it == end())
+				throw std::out_of_range("No such element with the given key!");
+			else
+				return it->second;
+		}
+
+		mapped_type& operator[](const key_type& key) {
+			return try_emplace(key).first->second;
+		}
+
+		mapped_type& operator[](key_type&& key) {
+			return try_emplace(std::move(key)).first->second;
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+			return assign_or_emplace(lower_bound(k), k, std::forward<M>(obj));
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+			return assign_or_emplace(lower_bound(k), std::move(k), std::forward<M>(obj));
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+			return try_emplace_at(lower_bound(k), k, std::forward<Args>(args)...);
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+			return try_emplace_at(lower_bound(k), std::move(k), std::forward<Args>(args)...);
+		}
+
+		using tree_type::begin;
+		using tree_type::cbegin;
+		using tree_type::end;
+		using tree_type::cend;
+
+		using tree_type::rbegin;
+		using tree_type::crbegin;
+		using tree_type::rend;
+		using tree_type::crend;
+
+		using tree_type::empty;
+		using tree_type::size;
+		using tree_type::max_size;
+		using tree_type::capacity;
+		using tree_type::segment_size;
+
+		using tree_type::clear;
+		using tree_type::insert;
+		using tree_type::emplace;
+		using tree_type::erase;
+		using tree_type::swap;
+
+		using tree_type::count;
+		using tree_type::find;
+		using tree_type::contains;
+		using tree_type::equal_range;
+		using tree_type::lower_bound;
+		using tree_type::upper_bound;
+
+		using tree_type::key_comp;
+		using tree_type::value_comp;
+
+	private:
+
+		// Given the lower bound of k, constructs the element there only if k is absent
+		template <class K, class... Args>
+		std::pair<iterator, bool> try_emplace_at(iterator lower, K&& k, Args&&... args) {
+			if (lower != end() && !key_comp()(k, lower->first))
+				return { lower, false };
+			return { tree_type::emplace_at(lower,
+				std::piecewise_construct,
+				std::forward_as_tuple(std::forward<K>(k)),
+				std::forward_as_tuple(std::forward<Args>(args)...)), true };
+		}
+
+		template <class K, class M>
+		std::pair<iterator, bool> assign_or_emplace(iterator lower, K&& k, M&& obj) {
+			if (lower != end() && !key_comp()(k, lower->first)) {
+				lower->second = std::forward<M>(obj);
+				return { lower, false };
+			}
+			return { tree_type::emplace_at(lower, std::forward<K>(k), std::forward<M>(obj)), true };
+		}
+
+	};
+
+}
+
+namespace std {
+	template <class Key, class T, class Compare, class Allocator>
+	void swap(
+		ancillary::gapped_flat_map<Key, T, Compare, Allocator>& lhs,
+		ancillary::gapped_flat_map<Key, T, Compare, Allocator>& rhs)
+	{
+		return lhs.swap(rhs);
+	}
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../detail/extract_key.hpp"
+#include "../detail/gapped_flat_tree.hpp"
+
+namespace ancillary {
+
+	// A flat_set stored as a packed memory array. Insertions and erasures move
+	// O(log^2 n) elements amortized instead of O(n), at the cost of up to four slots per
+	// element and iterators that skip over gaps.
+	template <
+		class Key,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<Key>
+	> struct gapped_flat_set : detail::gapped_flat_tree<Key, Compare, Allocator, detail::identity<Key>>
+	{
+		using tree_type = detail::gapped_flat_tree<Key, Compare, Allocator, detail::identity<Key>>;
+		using typename tree_type::container_type;
+		using typename tree_type::key_type;
+		using typename tree_type::value_type;
+		using typename tree_type::key_compare;
+		using typename tree_type::value_compare;
+		using typename tree_type::size_type;
+		using typename tree_type::difference_type;
+		using typename tree_type::allocator_type;
+		using typename tree_type::reference;
+		using typename tree_type::const_reference;
+		using typename tree_type::pointer;
+		using typename tree_type::const_pointer;
+		using typename tree_type::iterator;
+		using typename tree_type::const_iterator;
+		using typename tree_type::reverse_iterator;
+		using typename tree_type::const_reverse_iterator;
+
+		gapped_flat_set() = default;
+
+		explicit gapped_flat_set(const Compare& comp, const allocator_type& alloc = allocator_type())
+			: tree_type(comp, alloc) {}
+
+		explicit gapped_flat_set(const allocator_type& alloc)
+			: tree_type(alloc) {}
+
+		template <class InIt>
+		gapped_flat_set(InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(first, last, comp, alloc) {}
+
+		template <class InIt>
+		gapped_flat_set(sorted_unique_t tag, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(tag, first, last, comp, alloc) {}
+
+		gapped_flat_set(std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const allocator_type& alloc = allocator_type())
+			: tree_type(list, comp, alloc) {}
+
+		gapped_flat_set(const gapped_flat_set&) = default;
+		gapped_flat_set(gapped_flat_set&&) = default;
+
+		~gapped_flat_set() = default;
+
+		gapped_flat_set& operator=(const gapped_flat_set&) = default;
+		gapped_flat_set& operator=(gapped_flat_set&&) = default;
+		gapped_flat_set& operator=(std::initializer_list<value_type> list) {
+			tree_type::operator=(list);
+			return *this;
+		}
+
+		using tree_type::get_allocator;
+
+		using tree_type::begin;
+		using tree_type::cbegin;
+		using tree_type::end;
+		using tree_type::cend;
+
+		using tree_type::rbegin;
+		using tree_type::crbegin;
+		using tree_type::rend;
+		using tree_type::crend;
+
+		using tree_type::empty;
+		using tree_type::size;
+		using tree_type::max_size;
+		using tree_type::capacity;
+		using tree_type::segment_size;
+
+		using tree_type::clear;
+		using tree_type::insert;
+		using tree_type::emplace;
+		using tree_type::erase;
+		using tree_type::swap;
+
+		using tree_type::count;
+		using tree_type::find;
+		using tree_type::contains;
+		using tree_type::equal_range;
+		using tree_type::lower_bound;
+		using tree_type::upper_bound;
+
+		using tree_type::key_comp;
+		using tree_type::value_comp;
+
+	};
+
+}
+
+namespace std {
+	template <class Key, class Compare, class Allocator>
+	void swap(
+		ancillary::gapped_flat_set<Key, Compare, Allocator>& lhs,
+		ancillary::gapped_flat_set<Key, Compare, Allocator>& rhs)
+	{
+		return lhs.swap(rhs);
+	}
+}
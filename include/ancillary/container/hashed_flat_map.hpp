@@ -0,0 +1,466 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include "flat_map.hpp"
+
+namespace ancillary {
+
+	// A flat_map with an open addressing side index from key hashes to positions in the
+	// sorted storage, so point lookups take O(1) expected time while iteration, bounds
+	// and range queries still run over the sorted elements. The index is a linear
+	// probing table of 8 byte slots, each holding 32 bits of the hash and a position,
+	// kept at most half full. An insertion or erasure in the middle of the map shifts
+	// the positions after it, which the index follows with one pass over its slots;
+	// appends and bulk operations avoid that pass. Hash and KeyEqual must agree with
+	// the equivalence of keys under Compare, and the map holds fewer than 2^32 elements.
+	template <
+		class Key,
+		class T,
+		class Hash = std::hash<Key>,
+		class KeyEqual = std::equal_to<Key>,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<Key, T>>,
+		class SearchPolicy = binary_search_policy
+	> class hashed_flat_map {
+	public:
+
+		using flat_map_type          = flat_map<Key, T, Compare, Allocator, SearchPolicy>;
+		using key_type               = Key;
+		using mapped_type            = T;
+		using value_type             = std::pair<Key, T>;
+		using key_compare            = Compare;
+		using value_compare          = typename flat_map_type::value_compare;
+		using hasher                 = Hash;
+		using key_equal              = KeyEqual;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using allocator_type         = Allocator;
+		using reference              = value_type&;
+		using const_reference        = const value_type&;
+		using iterator               = typename flat_map_type::iterator;
+		using const_iterator         = typename flat_map_type::const_iterator;
+		using reverse_iterator       = typename flat_map_type::reverse_iterator;
+		using const_reverse_iterator = typename flat_map_type::const_reverse_iterator;
+
+		// Smallest number of index slots allocated once the map holds an element
+		static constexpr size_type min_index_capacity = 16;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                  CONSTRUCTORS                                  //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		hashed_flat_map()
+			: hashed_flat_map(Compare()) {}
+
+		explicit hashed_flat_map(const Compare& comp,
+			const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual(),
+			const Allocator& alloc = Allocator())
+			: m_map(comp, alloc)
+			, m_hash(hash)
+			, m_equal(equal) {}
+
+		explicit hashed_flat_map(flat_map_type map,
+			const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual())
+			: m_map(std::move(map))
+			, m_hash(hash)
+			, m_equal(equal)
+		{
+			reindex();
+		}
+
+		template <class InIt>
+		hashed_flat_map(InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual(),
+			const Allocator& alloc = Allocator())
+			: m_map(first, last, comp, alloc)
+			, m_hash(hash)
+			, m_equal(equal)
+		{
+			reindex();
+		}
+
+		template <class InIt>
+		hashed_flat_map(sorted_unique_t tag, InIt first, InIt last,
+			const Compare& comp = Compare(),
+			const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual(),
+			const Allocator& alloc = Allocator())
+			: m_map(tag, first, last, comp, alloc)
+			, m_hash(hash)
+			, m_equal(equal)
+		{
+			reindex();
+		}
+
+		hashed_flat_map(std::initializer_list<value_type> list,
+			const Compare& comp = Compare(),
+			const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual(),
+			const Allocator& alloc = Allocator())
+			: hashed_flat_map(list.begin(), list.end(), comp, hash, equal, alloc) {}
+
+		hashed_flat_map(const hashed_flat_map&) = default;
+		hashed_flat_map(hashed_flat_map&&) = default;
+
+		~hashed_flat_map() = default;
+
+		hashed_flat_map& operator=(const hashed_flat_map&) = default;
+		hashed_flat_map& operator=(hashed_flat_map&&) = default;
+		hashed_flat_map& operator=(std::initializer_list<value_type> list) {
+			m_map = list;
+			reindex();
+			return *this;
+		}
+
+		allocator_type get_allocator() const noexcept { return m_map.get_allocator(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    ITERATORS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		iterator begin() noexcept { return m_map.begin(); }
+		const_iterator begin() const noexcept { return m_map.begin(); }
+		const_iterator cbegin() const noexcept { return begin(); }
+
+		iterator end() noexcept { return m_map.end(); }
+		const_iterator end() const noexcept { return m_map.end(); }
+		const_iterator cend() const noexcept { return end(); }
+
+		reverse_iterator rbegin() noexcept { return m_map.rbegin(); }
+		const_reverse_iterator rbegin() const noexcept { return m_map.rbegin(); }
+		const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+		reverse_iterator rend() noexcept { return m_map.rend(); }
+		const_reverse_iterator rend() const noexcept { return m_map.rend(); }
+		const_reverse_iterator crend() const noexcept { return rend(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    CAPACITY                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		bool empty() const noexcept { return m_map.empty(); }
+		size_type size() const noexcept { return m_map.size(); }
+		size_type max_size() const noexcept { return std::min<size_type>(m_map.max_size(), max_position); }
+		void reserve(size_type new_cap) { m_map.reserve(new_cap); }
+
+		// Number of slots in the side index
+		size_type index_capacity() const noexcept { return m_slots.size(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                 ELEMENT ACCESS                                 //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		mapped_type& at(const key_type& key) {
+			return const_cast<mapped_type&>(const_cast<const hashed_flat_map*>(this)->at(key));
+		}
+
+		const mapped_type& at(const key_type& key) const {
+			auto it = find(key);
+			if (it == end())
+				throw std::out_of_range("No such element with the given key!");
+			else
+				return it->second;
+		}
+
+		mapped_type& operator[](const key_type& key) {
+			return try_emplace(key).first->second;
+		}
+
+		mapped_type& operator[](key_type&& key) {
+			return try_emplace(std::move(key)).first->second;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    MODIFIERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		void clear() noexcept {
+			m_map.clear();
+			m_slots.clear();
+			m_shift = 0;
+		}
+
+		std::pair<iterator, bool> insert(const value_type& x) { return try_emplace(x.first, x.second); }
+		std::pair<iterator, bool> insert(value_type&& x) { return try_emplace(std::move(x.first), std::move(x.second)); }
+
+		template <class InIt>
+		void insert(InIt first, InIt last) {
+			m_map.insert(first, last);
+			reindex();
+		}
+
+		template <class InIt>
+		void insert(sorted_unique_t tag, InIt first, InIt last) {
+			m_map.insert(tag, first, last);
+			reindex();
+		}
+
+		void insert(std::initializer_list<value_type> list) {
+			insert(list.begin(), list.end());
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args) {
+			return insert(value_type(std::forward<Args>(args)...));
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+			return try_emplace_impl(k, std::forward<Args>(args)...);
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+			return try_emplace_impl(std::move(k), std::forward<Args>(args)...);
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+			auto result = try_emplace_impl(k, std::forward<M>(obj));
+			if (!result.second)
+				result.first->second = std::forward<M>(obj);
+			return result;
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+			auto result = try_emplace_impl(std::move(k), std::forward<M>(obj));
+			if (!result.second)
+				result.first->second = std::forward<M>(obj);
+			return result;
+		}
+
+		iterator erase(const_iterator pos) {
+			const size_type p = pos - cbegin();
+			unindex(slot_of(hash_of(pos->first), p), p);
+			return m_map.erase(pos);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) {
+			auto it = m_map.erase(first, last);
+			reindex();
+			return it;
+		}
+
+		size_type erase(const key_type& key) {
+			const std::uint64_t h = hash_of(key);
+			const size_type slot = find_slot(h, key);
+			if (slot == npos)
+				return 0;
+			const size_type p = m_slots[slot].position - 1;
+			unindex(slot, p);
+			m_map.erase(m_map.begin() + p);
+			return 1;
+		}
+
+		void swap(hashed_flat_map& other) {
+			if (this != &other) {
+				std::swap(m_map, other.m_map);
+				std::swap(m_hash, other.m_hash);
+				std::swap(m_equal, other.m_equal);
+				std::swap(m_slots, other.m_slots);
+				std::swap(m_shift, other.m_shift);
+			}
+		}
+
+		// Rebuilds the side index from the sorted elements
+		void reindex() {
+			if (m_map.size() > max_position)
+				throw std::length_error("A hashed_flat_map holds fewer than 2^32 elements!");
+			size_type capacity = min_index_capacity;
+			unsigned bits = 4;
+			while (capacity < 2 * m_map.size()) {
+				capacity *= 2;
+				++bits;
+			}
+			m_slots.assign(m_map.empty() ? 0 : capacity, slot_type());
+			m_shift = 64 - bits;
+			for (size_type p = 0; p < m_map.size(); ++p)
+				place(hash_of(m_map.begin()[p].first), p);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     LOOKUP                                     //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		size_type count(const key_type& key) const { return contains(key); }
+
+		iterator find(const key_type& key) {
+			size_type slot = find_slot(hash_of(key), key);
+			return slot == npos ? end() : begin() + (m_slots[slot].position - 1);
+		}
+
+		const_iterator find(const key_type& key) const {
+			size_type slot = find_slot(hash_of(key), key);
+			return slot == npos ? end() : begin() + (m_slots[slot].position - 1);
+		}
+
+		bool contains(const key_type& key) const { return find_slot(hash_of(key), key) != npos; }
+
+		std::pair<iterator, iterator> equal_range(const key_type& key) {
+			auto it = find(key);
+			if (it == end())
+				return { lower_bound(key), lower_bound(key) };
+			return { it, std::next(it) };
+		}
+
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+			auto it = find(key);
+			if (it == end())
+				return { lower_bound(key), lower_bound(key) };
+			return { it, std::next(it) };
+		}
+
+		iterator lower_bound(const key_type& key) { return m_map.lower_bound(key); }
+		const_iterator lower_bound(const key_type& key) const { return m_map.lower_bound(key); }
+
+		iterator upper_bound(const key_type& key) { return m_map.upper_bound(key); }
+		const_iterator upper_bound(const key_type& key) const { return m_map.upper_bound(key); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    OBSERVERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		key_compare key_comp() const { return m_map.key_comp(); }
+		value_compare value_comp() const { return m_map.value_comp(); }
+		hasher hash_function() const { return m_hash; }
+		key_equal key_eq() const { return m_equal; }
+
+		const flat_map_type& map() const noexcept { return m_map; }
+
+	private:
+
+		struct slot_type {
+			std::uint32_t tag = 0;      // Low 32 bits of the mixed hash
+			std::uint32_t position = 0; // One past the element's position, zero if the slot is empty
+		};
+
+		static constexpr size_type npos = static_cast<size_type>(-1);
+		static constexpr size_type max_position = std::numeric_limits<std::uint32_t>::max() - 1;
+
+		// Mixes the user hash so that identity hashes of integers spread over the table
+		std::uint64_t hash_of(const key_type& key) const {
+			std::uint64_t h = static_cast<std::uint64_t>(m_hash(key));
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdULL;
+			h ^= h >> 33;
+			h *= 0xc4ceb9fe1a85ec53ULL;
+			h ^= h >> 33;
+			return h;
+		}
+
+		// The top bits pick the home slot and the low bits serve as the tag
+		size_type home_of(std::uint64_t h) const noexcept { return static_cast<size_type>(h >> m_shift); }
+		size_type next_slot(size_type slot) const noexcept { return (slot + 1) & (m_slots.size() - 1); }
+
+		size_type find_slot(std::uint64_t h, const key_type& key) const {
+			if (m_slots.empty())
+				return npos;
+			const auto tag = static_cast<std::uint32_t>(h);
+			for (size_type slot = home_of(h);; slot = next_slot(slot)) {
+				const slot_type& s = m_slots[slot];
+				if (s.position == 0)
+					return npos;
+				if (s.tag == tag && m_equal(m_map.begin()[s.position - 1].first, key))
+					return slot;
+			}
+		}
+
+		// Returns the slot indexing position p, whose key hashes to h
+		size_type slot_of(std::uint64_t h, size_type p) const {
+			for (size_type slot = home_of(h);; slot = next_slot(slot))
+				if (m_slots[slot].position == p + 1)
+					return slot;
+		}
+
+		void place(std::uint64_t h, size_type p) {
+			size_type slot = home_of(h);
+			while (m_slots[slot].position != 0)
+				slot = next_slot(slot);
+			m_slots[slot] = { static_cast<std::uint32_t>(h), static_cast<std::uint32_t>(p + 1) };
+		}
+
+		template <class K, class... Args>
+		std::pair<iterator, bool> try_emplace_impl(K&& k, Args&&... args) {
+			const std::uint64_t h = hash_of(k);
+			size_type slot = find_slot(h, k);
+			if (slot != npos)
+				return { begin() + (m_slots[slot].position - 1), false };
+			if (m_map.size() >= max_position)
+				throw std::length_error("A hashed_flat_map holds fewer than 2^32 elements!");
+			auto it = m_map.try_emplace(std::forward<K>(k), std::forward<Args>(args)...).first;
+			const size_type p = it - begin();
+			if (2 * m_map.size() > m_slots.size()) {
+				reindex();
+				return { it, true };
+			}
+			// Positions at or after p moved up by one
+			if (p + 1 != m_map.size())
+				for (auto& s : m_slots)
+					s.position += s.position > p;
+			place(h, p);
+			return { it, true };
+		}
+
+		// Empties the slot indexing position p with backward shift deletion, then moves the
+		// positions after p down by one. Must run before the element is erased.
+		void unindex(size_type slot, size_type p) {
+			const size_type mask = m_slots.size() - 1;
+			for (size_type next = next_slot(slot); m_slots[next].position != 0; next = next_slot(next)) {
+				const size_type home = home_of(hash_of(m_map.begin()[m_slots[next].position - 1].first));
+				if (((next - home) & mask) >= ((next - slot) & mask)) {
+					m_slots[slot] = m_slots[next];
+					slot = next;
+				}
+			}
+			m_slots[slot] = slot_type();
+			if (p + 1 != m_map.size())
+				for (auto& s : m_slots)
+					s.position -= s.position > p + 1;
+		}
+
+		flat_map_type m_map;            // Sorted elements
+		hasher m_hash;                  // Key hashing
+		key_equal m_equal;              // Key equality
+		std::vector<slot_type> m_slots; // Linear probing index, a power of two in size
+		unsigned m_shift = 0;           // 64 minus the number of index bits
+
+	};
+
+	template <class Key, class T, class Hash, class KeyEqual, class Compare, class Allocator, class SearchPolicy>
+	bool operator==(
+		const hashed_flat_map<Key, T, Hash, KeyEqual, Compare, Allocator, SearchPolicy>& lhs,
+		const hashed_flat_map<Key, T, Hash, KeyEqual, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <class Key, class T, class Hash, class KeyEqual, class Compare, class Allocator, class SearchPolicy>
+	bool operator!=(
+		const hashed_flat_map<Key, T, Hash, KeyEqual, Compare, Allocator, SearchPolicy>& lhs,
+		const hashed_flat_map<Key, T, Hash, KeyEqual, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+}
+
+namespace std {
+	template <class Key, class T, class Hash, class KeyEqual, class Compare, class Allocator, class SearchPolicy>
+	void swap(
+		ancillary::hashed_flat_map<Key, T, Hash, KeyEqual, Compare, Allocator, SearchPolicy>& lhs,
+		ancillary::hashed_flat_map<Key, T, Hash, KeyEqual, Compare, Allocator, SearchPolicy>& rhs)
+	{
+		return lhs.swap(rhs);
+	}
+}
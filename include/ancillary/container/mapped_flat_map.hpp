@@ -0,0 +1,242 @@
+#pragma once
+
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include "flat_map.hpp"
+#include "../detail/mapped_file.hpp"
+#include "../detail/zip_iterator.hpp"
+
+namespace ancillary {
+
+	// A read-only map served straight out of a memory-mapped file written by
+	// write_mapped. Keys and mapped values live in two separate arrays, so searches
+	// only fault in pages of the key array and run the same search code as the
+	// flat containers, vector compares included. Opening one does no parsing or
+	// copying, and every process mapping the same file shares its pages. Keys and
+	// mapped values must be trivially copyable, and the file must have been written
+	// by a map ordered by the same Compare.
+	template <
+		class Key,
+		class T,
+		class Compare = std::less<Key>,
+		class SearchPolicy = binary_search_policy
+	> class mapped_flat_map {
+	public:
+
+		using key_type               = Key;
+		using mapped_type            = T;
+		using value_type             = std::pair<Key, T>;
+		using key_compare            = Compare;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = std::pair<const Key&, const T&>;
+		using const_reference        = reference;
+		using iterator               = detail::zip_iterator<const Key*, const T*>;
+		using const_iterator         = iterator;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = reverse_iterator;
+		using search_policy          = SearchPolicy;
+
+		class value_compare {
+			friend class mapped_flat_map;
+			Compare m_cmp;
+			value_compare(Compare c)
+				: m_cmp(c) {}
+		public:
+			template <class Lhs, class Rhs>
+			bool operator()(const Lhs& lhs, const Rhs& rhs) const {
+				return m_cmp(lhs.first, rhs.first);
+			}
+		};
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                  CONSTRUCTORS                                  //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		mapped_flat_map() = default;
+
+		explicit mapped_flat_map(const std::string& path, const Compare& comp = Compare())
+			: m_file(path)
+			, m_kcmp(comp)
+		{
+			detail::check_mappable<Key, T>();
+			const auto& header = m_file.header(sizeof(Key), sizeof(T));
+			const auto n = static_cast<size_type>(header.size);
+			m_keys = { reinterpret_cast<const Key*>(m_file.data() + header.keys_offset), n };
+			m_values = { reinterpret_cast<const T*>(m_file.data() + header.values_offset), n };
+		}
+
+		mapped_flat_map(const mapped_flat_map&) = delete;
+
+		mapped_flat_map(mapped_flat_map&& other) noexcept
+			: m_file(std::move(other.m_file))
+			, m_keys(std::exchange(other.m_keys, {}))
+			, m_values(std::exchange(other.m_values, {}))
+			, m_kcmp(other.m_kcmp) {}
+
+		~mapped_flat_map() = default;
+
+		mapped_flat_map& operator=(const mapped_flat_map&) = delete;
+
+		mapped_flat_map& operator=(mapped_flat_map&& other) noexcept {
+			m_file = std::move(other.m_file);
+			m_keys = std::exchange(other.m_keys, {});
+			m_values = std::exchange(other.m_values, {});
+			m_kcmp = other.m_kcmp;
+			return *this;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    ITERATORS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		const_iterator begin() const noexcept { return make_iterator(0); }
+		const_iterator cbegin() const noexcept { return begin(); }
+
+		const_iterator end() const noexcept { return make_iterator(size()); }
+		const_iterator cend() const noexcept { return end(); }
+
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+		const_reverse_iterator crend() const noexcept { return rend(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    CAPACITY                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		bool empty() const noexcept { return m_keys.empty(); }
+		size_type size() const noexcept { return m_keys.size(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     LOOKUP                                     //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		const mapped_type& at(const key_type& key) const {
+			auto i = find_index(key);
+			if (i == size())
+				throw std::out_of_range("No such element with the given key!");
+			else
+				return m_values[i];
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const mapped_type& at(const K& key) const {
+			auto i = find_index(key);
+			if (i == size())
+				throw std::out_of_range("No such element with the given key!");
+			else
+				return m_values[i];
+		}
+
+		size_type count(const key_type& key) const { return contains(key); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		size_type count(const K& key) const { return contains(key); }
+
+		const_iterator find(const key_type& key) const { return make_iterator(find_index(key)); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator find(const K& key) const { return make_iterator(find_index(key)); }
+
+		bool contains(const key_type& key) const { return find_index(key) != size(); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		bool contains(const K& key) const { return find_index(key) != size(); }
+
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+			auto i = lower_index(key);
+			auto j = i != size() && !m_kcmp(key, m_keys[i]) ? i + 1 : i;
+			return { make_iterator(i), make_iterator(j) };
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+			return { lower_bound(key), upper_bound(key) };
+		}
+
+		const_iterator lower_bound(const key_type& key) const { return make_iterator(lower_index(key)); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator lower_bound(const K& key) const { return make_iterator(lower_index(key)); }
+
+		const_iterator upper_bound(const key_type& key) const { return make_iterator(upper_index(key)); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator upper_bound(const K& key) const { return make_iterator(upper_index(key)); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    OBSERVERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		key_compare key_comp() const { return m_kcmp; }
+		value_compare value_comp() const { return value_compare(m_kcmp); }
+
+		const detail::array_view<Key>& keys() const noexcept { return m_keys; }
+		const detail::array_view<T>& values() const noexcept { return m_values; }
+
+	private:
+
+		using key_extract = detail::identity<Key>;
+		using search_type = detail::container_search<detail::array_view<Key>, Compare, key_extract, SearchPolicy>;
+
+		const_iterator make_iterator(size_type i) const noexcept {
+			return { m_keys.data() + i, m_values.data() + i };
+		}
+
+		template <class K>
+		size_type lower_index(const K& key) const {
+			return search_type::lower_bound(m_keys, m_keys.begin(), m_keys.end(), key, m_kcmp, key_extract()) - m_keys.begin();
+		}
+
+		template <class K>
+		size_type upper_index(const K& key) const {
+			return search_type::upper_bound(m_keys, m_keys.begin(), m_keys.end(), key, m_kcmp, key_extract()) - m_keys.begin();
+		}
+
+		template <class K>
+		size_type find_index(const K& key) const {
+			auto i = lower_index(key);
+			return i != size() && !m_kcmp(key, m_keys[i]) ? i : size();
+		}
+
+		detail::mapped_file m_file; // Owns the mapping
+		detail::array_view<Key> m_keys; // Sorted keys inside the mapping
+		detail::array_view<T> m_values; // Mapped values, parallel to m_keys
+		key_compare m_kcmp; // Key comparison
+
+	};
+
+	template <class Key, class T, class Compare, class SearchPolicy>
+	bool operator==(
+		const mapped_flat_map<Key, T, Compare, SearchPolicy>& lhs,
+		const mapped_flat_map<Key, T, Compare, SearchPolicy>& rhs)
+	{
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template <class Key, class T, class Compare, class SearchPolicy>
+	bool operator!=(
+		const mapped_flat_map<Key, T, Compare, SearchPolicy>& lhs,
+		const mapped_flat_map<Key, T, Compare, SearchPolicy>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	// Writes the elements of map in the format read by mapped_flat_map
+	template <class Key, class T, class Compare, class Allocator, class SearchPolicy, class Container>
+	void write_mapped(const flat_map<Key, T, Compare, Allocator, SearchPolicy, Container>& map, const std::string& path) {
+		detail::check_mappable<Key, T>();
+		detail::mapped_writer writer(path, detail::make_mapped_header(map.size(), sizeof(Key), sizeof(T)));
+		for (const auto& element : map)
+			writer.write_key(element.first);
+		writer.begin_values();
+		for (const auto& element : map)
+			writer.write_value(element.second);
+		writer.finish();
+	}
+
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include "flat_set.hpp"
+#include "../detail/mapped_file.hpp"
+
+namespace ancillary {
+
+	// A read-only set served straight out of a memory-mapped file written by
+	// write_mapped. Opening one does no parsing or copying: pages of the key array
+	// are faulted in as lookups touch them and are shared between every process
+	// that maps the same file. Keys must be trivially copyable and the file must
+	// have been written by a set ordered by the same Compare.
+	template <
+		class Key,
+		class Compare = std::less<Key>,
+		class SearchPolicy = binary_search_policy
+	> class mapped_flat_set {
+	public:
+
+		using key_type               = Key;
+		using value_type             = Key;
+		using key_compare            = Compare;
+		using value_compare          = Compare;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = const value_type&;
+		using const_reference        = const value_type&;
+		using pointer                = const value_type*;
+		using const_pointer          = const value_type*;
+		using iterator               = const value_type*;
+		using const_iterator         = const value_type*;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+		using search_policy          = SearchPolicy;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                  CONSTRUCTORS                                  //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		mapped_flat_set() = default;
+
+		explicit mapped_flat_set(const std::string& path, const Compare& comp = Compare())
+			: m_file(path)
+			, m_kcmp(comp)
+		{
+			detail::check_mappable<Key, Key>();
+			const auto& header = m_file.header(sizeof(Key), 0);
+			m_keys = { reinterpret_cast<const Key*>(m_file.data() + header.keys_offset), static_cast<size_type>(header.size) };
+		}
+
+		mapped_flat_set(const mapped_flat_set&) = delete;
+
+		mapped_flat_set(mapped_flat_set&& other) noexcept
+			: m_file(std::move(other.m_file))
+			, m_keys(std::exchange(other.m_keys, {}))
+			, m_kcmp(other.m_kcmp) {}
+
+		~mapped_flat_set() = default;
+
+		mapped_flat_set& operator=(const mapped_flat_set&) = delete;
+
+		mapped_flat_set& operator=(mapped_flat_set&& other) noexcept {
+			m_file = std::move(other.m_file);
+			m_keys = std::exchange(other.m_keys, {});
+			m_kcmp = other.m_kcmp;
+			return *this;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    ITERATORS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		const_iterator begin() const noexcept { return m_keys.begin(); }
+		const_iterator cbegin() const noexcept { return begin(); }
+
+		const_iterator end() const noexcept { return m_keys.end(); }
+		const_iterator cend() const noexcept { return end(); }
+
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+		const_reverse_iterator crend() const noexcept { return rend(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    CAPACITY                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		bool empty() const noexcept { return m_keys.empty(); }
+		size_type size() const noexcept { return m_keys.size(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     LOOKUP                                     //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		size_type count(const key_type& key) const { return contains(key); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		size_type count(const K& key) const { return contains(key); }
+
+		const_iterator find(const key_type& key) const { return find_impl(key); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator find(const K& key) const { return find_impl(key); }
+
+		bool contains(const key_type& key) const { return find_impl(key) != end(); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		bool contains(const K& key) const { return find_impl(key) != end(); }
+
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+			auto it = lower_bound(key);
+			return { it, it != end() && !m_kcmp(key, *it) ? std::next(it) : it };
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+			return { lower_bound(key), upper_bound(key) };
+		}
+
+		const_iterator lower_bound(const key_type& key) const {
+			return search_type::lower_bound(m_keys, begin(), end(), key, m_kcmp, key_extract());
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator lower_bound(const K& key) const {
+			return search_type::lower_bound(m_keys, begin(), end(), key, m_kcmp, key_extract());
+		}
+
+		const_iterator upper_bound(const key_type& key) const {
+			return search_type::upper_bound(m_keys, begin(), end(), key, m_kcmp, key_extract());
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator upper_bound(const K& key) const {
+			return search_type::upper_bound(m_keys, begin(), end(), key, m_kcmp, key_extract());
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    OBSERVERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		key_compare key_comp() const { return m_kcmp; }
+		value_compare value_comp() const { return m_kcmp; }
+
+	private:
+
+		using key_extract = detail::identity<Key>;
+		using search_type = detail::container_search<detail::array_view<Key>, Compare, key_extract, SearchPolicy>;
+
+		template <class K>
+		const_iterator find_impl(const K& key) const {
+			auto it = lower_bound(key);
+			return it != end() && !m_kcmp(key, *it) ? it : end();
+		}
+
+		detail::mapped_file m_file; // Owns the mapping
+		detail::array_view<Key> m_keys; // Sorted keys inside the mapping
+		key_compare m_kcmp; // Key comparison
+
+	};
+
+	template <class Key, class Compare, class SearchPolicy>
+	bool operator==(
+		const mapped_flat_set<Key, Compare, SearchPolicy>& lhs,
+		const mapped_flat_set<Key, Compare, SearchPolicy>& rhs)
+	{
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <class Key, class Compare, class SearchPolicy>
+	bool operator!=(
+		const mapped_flat_set<Key, Compare, SearchPolicy>& lhs,
+		const mapped_flat_set<Key, Compare, SearchPolicy>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	// Writes the keys of set in the format read by mapped_flat_set
+	template <class Key, class Compare, class Allocator, class SearchPolicy, class Container>
+	void write_mapped(const flat_set<Key, Compare, Allocator, SearchPolicy, Container>& set, const std::string& path) {
+		detail::check_mappable<Key, Key>();
+		detail::mapped_writer writer(path, detail::make_mapped_header(set.size(), sizeof(Key), 0));
+		for (const auto& key : set)
+			writer.write_key(key);
+		writer.begin_values();
+		writer.finish();
+	}
+
+}
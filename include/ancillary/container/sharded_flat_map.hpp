@@ -0,0 +1,401 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <shared_mutex>
+#include "flat_map.hpp"
+#include "../detail/prefetch.hpp"
+
+namespace ancillary {
+
+	// A concurrent sorted map that splits its key space into a fixed number of
+	// ordered shards, each a flat_map behind its own reader-writer lock. Writers to
+	// different shards never contend, and every insertion or erasure only shifts
+	// the elements of one shard. Shard boundaries are recomputed so that every
+	// shard holds the same number of elements whenever one shard grows past twice
+	// the balanced size, which keeps skewed or sequential keys from piling into a
+	// single shard.
+	//
+	// Lookups and mutations route a key through the current boundaries, lock its
+	// shard and check that the boundaries did not change in between; rebalancing
+	// holds every shard lock while it moves elements. Threads announce themselves
+	// on a per-thread counter while they read the boundaries, and replaced ones are
+	// freed once every counter has been seen idle. Ordered traversal and range
+	// queries visit the shards in key order one lock at a time and hold off
+	// rebalancing meanwhile, so they observe each shard atomically but not the map
+	// as a whole.
+	template <
+		class Key,
+		class T,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<Key, T>>,
+		class SearchPolicy = binary_search_policy
+	> class sharded_flat_map {
+	public:
+
+		using map_type    = flat_map<Key, T, Compare, Allocator, SearchPolicy>;
+		using key_type    = Key;
+		using mapped_type = T;
+		using value_type  = std::pair<Key, T>;
+		using key_compare = Compare;
+		using size_type   = std::size_t;
+
+		// Shards smaller than this are never considered skewed
+		static constexpr size_type min_rebalance_size = 1024;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                  CONSTRUCTORS                                  //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		sharded_flat_map()
+			: sharded_flat_map(default_shard_count()) {}
+
+		explicit sharded_flat_map(size_type shards, const Compare& comp = Compare())
+			: m_shards(new shard[std::max<size_type>(shards, 1)])
+			, m_routers(new router[std::max<size_type>(shards, 1)])
+			, m_shard_count(std::max<size_type>(shards, 1))
+			, m_kcmp(comp)
+		{
+			m_layouts.emplace_back(new layout());
+			m_layout.store(m_layouts.back().get());
+		}
+
+		// Splits the elements evenly over the shards up front
+		template <class InIt>
+		sharded_flat_map(InIt first, InIt last, size_type shards = default_shard_count(), const Compare& comp = Compare())
+			: sharded_flat_map(shards, comp)
+		{
+			redistribute(map_type(first, last, comp).extract());
+			reclaim_layouts();
+		}
+
+		sharded_flat_map(const sharded_flat_map&) = delete;
+		sharded_flat_map(sharded_flat_map&&) = delete;
+
+		~sharded_flat_map() = default;
+
+		sharded_flat_map& operator=(const sharded_flat_map&) = delete;
+		sharded_flat_map& operator=(sharded_flat_map&&) = delete;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    CAPACITY                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		// Exact when no writer is running concurrently
+		size_type size() const noexcept {
+			size_type total = 0;
+			for (size_type i = 0; i < m_shard_count; ++i)
+				total += m_shards[i].count.load(std::memory_order_relaxed);
+			return total;
+		}
+
+		bool empty() const noexcept { return size() == 0; }
+
+		size_type shard_count() const noexcept { return m_shard_count; }
+
+		std::vector<size_type> shard_sizes() const {
+			std::vector<size_type> sizes(m_shard_count);
+			for (size_type i = 0; i < m_shard_count; ++i)
+				sizes[i] = m_shards[i].count.load(std::memory_order_relaxed);
+			return sizes;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    MODIFIERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		bool insert(const value_type& value) { return try_emplace(value.first, value.second); }
+		bool insert(value_type&& value) { return try_emplace(value.first, std::move(value.second)); }
+
+		// Returns whether the key was inserted
+		template <class... Args>
+		bool try_emplace(const key_type& key, Args&&... args) {
+			size_type size = 0;
+			bool inserted = write(key, [&](map_type& map) {
+				return map.try_emplace(key, std::forward<Args>(args)...).second;
+			}, size);
+			if (inserted)
+				rebalance_if_skewed(size);
+			return inserted;
+		}
+
+		// Returns whether the key was inserted rather than assigned
+		template <class M>
+		bool insert_or_assign(const key_type& key, M&& obj) {
+			size_type size = 0;
+			bool inserted = write(key, [&](map_type& map) {
+				return map.insert_or_assign(key, std::forward<M>(obj)).second;
+			}, size);
+			if (inserted)
+				rebalance_if_skewed(size);
+			return inserted;
+		}
+
+		size_type erase(const key_type& key) {
+			size_type size = 0;
+			return write(key, [&](map_type& map) { return map.erase(key); }, size);
+		}
+
+		// Calls f(mapped_type&) under the shard lock if the key is present
+		template <class F>
+		bool update(const key_type& key, F f) {
+			size_type size = 0;
+			return write(key, [&](map_type& map) {
+				auto it = map.find(key);
+				if (it == map.end())
+					return false;
+				f(it->second);
+				return true;
+			}, size);
+		}
+
+		void clear() {
+			std::lock_guard<std::shared_mutex> guard(m_rebalance);
+			for (size_type i = 0; i < m_shard_count; ++i) {
+				std::unique_lock<std::shared_mutex> lock(m_shards[i].lock);
+				m_shards[i].map.clear();
+				m_shards[i].count.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		// Recomputes the shard boundaries so that every shard holds the same number of elements
+		void rebalance() {
+			std::lock_guard<std::shared_mutex> guard(m_rebalance);
+			redistribute_locked();
+			reclaim_layouts();
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     LOOKUP                                     //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		bool contains(const key_type& key) const {
+			return read(key, [&](const map_type& map) { return map.contains(key); });
+		}
+
+		size_type count(const key_type& key) const { return contains(key); }
+
+		std::optional<mapped_type> get(const key_type& key) const {
+			return read(key, [&](const map_type& map) -> std::optional<mapped_type> {
+				auto it = map.find(key);
+				if (it == map.end())
+					return std::nullopt;
+				return it->second;
+			});
+		}
+
+		// Calls f(const mapped_type&) under the shard lock if the key is present
+		template <class F>
+		bool visit(const key_type& key, F f) const {
+			return read(key, [&](const map_type& map) {
+				auto it = map.find(key);
+				if (it == map.end())
+					return false;
+				f(it->second);
+				return true;
+			});
+		}
+
+		// Calls f(const value_type&) for every element in key order. Scans run
+		// concurrently with each other but hold off rebalancing, and f runs under a
+		// shard lock, so it must not modify the map.
+		template <class F>
+		void for_each(F f) const {
+			std::shared_lock<std::shared_mutex> guard(m_rebalance);
+			for (size_type i = 0; i < m_shard_count; ++i) {
+				std::shared_lock<std::shared_mutex> lock(m_shards[i].lock);
+				for (const auto& element : m_shards[i].map)
+					f(element);
+			}
+		}
+
+		// Calls f(const value_type&) in key order for every element with a key in
+		// [first, last). As with the full scan, f must not modify the map.
+		template <class F>
+		void for_each(const key_type& first, const key_type& last, F f) const {
+			if (!m_kcmp(first, last))
+				return;
+			std::shared_lock<std::shared_mutex> guard(m_rebalance);
+			const layout* current = m_layout.load(std::memory_order_acquire);
+			const size_type lo = current->route(first, m_kcmp);
+			const size_type hi = current->route(last, m_kcmp);
+			for (size_type i = lo; i <= hi; ++i) {
+				std::shared_lock<std::shared_mutex> lock(m_shards[i].lock);
+				const map_type& map = m_shards[i].map;
+				auto it = i == lo ? map.lower_bound(first) : map.begin();
+				auto end = i == hi ? map.lower_bound(last) : map.end();
+				for (; it != end; ++it)
+					f(*it);
+			}
+		}
+
+		// Copies the elements into a single flat_map
+		map_type to_flat_map() const {
+			typename map_type::container_type data;
+			for_each([&](const value_type& element) { data.push_back(element); });
+			map_type map(m_kcmp);
+			map.replace(std::move(data));
+			return map;
+		}
+
+		key_compare key_comp() const { return m_kcmp; }
+
+	private:
+
+		// Shard i + 1 holds the keys from bounds[i] up to bounds[i + 1]. Shards past the
+		// end of bounds are empty.
+		struct layout {
+			std::vector<Key> bounds;
+
+			size_type route(const Key& key, const Compare& comp) const {
+				return std::upper_bound(bounds.begin(), bounds.end(), key, comp) - bounds.begin();
+			}
+		};
+
+		struct alignas(detail::cache_line_size) router {
+			std::atomic<size_type> active{ 0 }; // Threads currently reading the boundaries
+		};
+
+		struct alignas(detail::cache_line_size) shard {
+			mutable std::shared_mutex lock;
+			map_type map;
+			std::atomic<size_type> count{ 0 }; // Size of map, readable without the lock
+		};
+
+		static size_type default_shard_count() {
+			return std::max<size_type>(2, 2 * static_cast<size_type>(std::thread::hardware_concurrency()));
+		}
+
+		// Threads spread over the router counters by the hash of their id
+		std::atomic<size_type>& router_of_this_thread() const {
+			static thread_local const size_type hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+			return m_routers[hash % m_shard_count].active;
+		}
+
+		// Locks the shard owning key with Lock and returns f(shard), retrying if the
+		// boundaries moved before the lock was acquired. The layout is only touched
+		// while the thread is announced on its router, and the generation rather than
+		// the layout's address is rechecked since freed addresses can be reused.
+		template <class Lock, class F>
+		decltype(auto) with_shard(const key_type& key, F&& f) const {
+			auto& active = router_of_this_thread();
+			for (;;) {
+				active.fetch_add(1);
+				const std::uint64_t generation = m_generation.load();
+				const size_type index = m_layout.load()->route(key, m_kcmp);
+				active.fetch_sub(1, std::memory_order_release);
+				shard& s = m_shards[index];
+				Lock lock(s.lock);
+				if (m_generation.load(std::memory_order_acquire) == generation)
+					return f(s);
+			}
+		}
+
+		template <class F>
+		decltype(auto) read(const key_type& key, F&& f) const {
+			return with_shard<std::shared_lock<std::shared_mutex>>(key, [&](shard& s) {
+				return f(static_cast<const map_type&>(s.map));
+			});
+		}
+
+		template <class F>
+		decltype(auto) write(const key_type& key, F&& f, size_type& size) {
+			return with_shard<std::unique_lock<std::shared_mutex>>(key, [&](shard& s) {
+				auto result = f(s.map);
+				size = s.map.size();
+				s.count.store(size, std::memory_order_relaxed);
+				return result;
+			});
+		}
+
+		void rebalance_if_skewed(size_type shard_size) {
+			if (shard_size < min_rebalance_size || shard_size <= 2 * m_balanced.load(std::memory_order_relaxed))
+				return;
+			// Writers that lose the race simply carry on
+			std::unique_lock<std::shared_mutex> guard(m_rebalance, std::try_to_lock);
+			if (!guard.owns_lock())
+				return;
+			auto sizes = shard_sizes();
+			const size_type balanced = std::accumulate(sizes.begin(), sizes.end(), size_type(0)) / m_shard_count;
+			if (*std::max_element(sizes.begin(), sizes.end()) > 2 * balanced) {
+				redistribute_locked();
+				reclaim_layouts();
+			}
+			else
+				m_balanced.store(balanced, std::memory_order_relaxed);
+		}
+
+		// Requires m_rebalance to be held exclusively
+		void redistribute_locked() {
+			std::vector<std::unique_lock<std::shared_mutex>> locks;
+			locks.reserve(m_shard_count);
+			for (size_type i = 0; i < m_shard_count; ++i)
+				locks.emplace_back(m_shards[i].lock);
+			typename map_type::container_type all;
+			all.reserve(size());
+			for (size_type i = 0; i < m_shard_count; ++i) {
+				auto data = std::move(m_shards[i].map).extract();
+				all.insert(all.end(), std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
+			}
+			redistribute(std::move(all));
+		}
+
+		// Requires every shard to be locked or the map to be unshared
+		void redistribute(typename map_type::container_type&& all) {
+			const size_type total = all.size();
+			auto next = std::make_unique<layout>();
+			if (total != 0) {
+				next->bounds.reserve(m_shard_count - 1);
+				for (size_type i = 1; i < m_shard_count; ++i)
+					next->bounds.push_back(all[total * i / m_shard_count].first);
+			}
+			for (size_type i = 0; i < m_shard_count; ++i) {
+				auto first = all.begin() + total * i / m_shard_count;
+				auto last = all.begin() + total * (i + 1) / m_shard_count;
+				typename map_type::container_type part(std::make_move_iterator(first), std::make_move_iterator(last));
+				m_shards[i].map.replace(std::move(part));
+				m_shards[i].count.store(m_shards[i].map.size(), std::memory_order_relaxed);
+			}
+			// Readers may still be routing through older layouts until reclaim_layouts()
+			m_layouts.push_back(std::move(next));
+			m_layout.store(m_layouts.back().get());
+			m_generation.fetch_add(1);
+			m_balanced.store(total / m_shard_count, std::memory_order_relaxed);
+		}
+
+		// Frees every layout but the current one. A thread that loaded an older layout
+		// announced itself before the new one was published, so once each router has
+		// been seen idle since then, no thread can still be reading an older layout.
+		// Requires m_rebalance to be held exclusively and no shard lock, since routing threads
+		// never block while announced.
+		void reclaim_layouts() {
+			if (m_layouts.size() == 1)
+				return;
+			for (size_type i = 0; i < m_shard_count; ++i)
+				while (m_routers[i].active.load() != 0)
+					std::this_thread::yield();
+			m_layouts.erase(m_layouts.begin(), std::prev(m_layouts.end()));
+		}
+
+		std::unique_ptr<shard[]> m_shards;
+		std::unique_ptr<router[]> m_routers; // One announcement counter per thread hash bucket
+		size_type m_shard_count;
+		key_compare m_kcmp; // Key comparison
+		std::atomic<const layout*> m_layout; // Current shard boundaries
+		std::atomic<std::uint64_t> m_generation{ 0 }; // Bumped every time a layout is published
+		std::vector<std::unique_ptr<layout>> m_layouts; // The current layout and those not yet reclaimed
+		std::atomic<size_type> m_balanced{ 0 }; // Shard size right after the last rebalance
+		mutable std::shared_mutex m_rebalance; // Shared by scans, exclusive while the layout changes
+
+	};
+
+}
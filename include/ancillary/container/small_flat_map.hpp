@@ -0,0 +1,18 @@
+#pragma once
+
+#include "flat_map.hpp"
+#include "small_vector.hpp"
+
+namespace ancillary {
+
+	// A flat_map that keeps up to N elements inside the object and only allocates beyond that
+	template <
+		class Key,
+		class T,
+		std::size_t N,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<Key, T>>,
+		class SearchPolicy = binary_search_policy
+	> using small_flat_map = flat_map<Key, T, Compare, Allocator, SearchPolicy, small_vector<std::pair<Key, T>, N, Allocator>>;
+
+}
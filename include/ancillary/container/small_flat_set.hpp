@@ -0,0 +1,17 @@
+#pragma once
+
+#include "flat_set.hpp"
+#include "small_vector.hpp"
+
+namespace ancillary {
+
+	// A flat_set that keeps up to N keys inside the object and only allocates beyond that
+	template <
+		class Key,
+		std::size_t N,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<Key>,
+		class SearchPolicy = binary_search_policy
+	> using small_flat_set = flat_set<Key, Compare, Allocator, SearchPolicy, small_vector<Key, N, Allocator>>;
+
+}
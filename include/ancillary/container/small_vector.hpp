@@ -0,0 +1,532 @@
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include "../detail/is_iterator.hpp"
+
+namespace ancillary {
+
+	// A vector that stores up to N elements inside the object itself and only allocates
+	// once it grows beyond that. Iterators are raw pointers. Moving a small_vector whose
+	// elements are stored inline moves the elements one by one, so unlike std::vector a
+	// move may invalidate iterators.
+	template <
+		class T,
+		std::size_t N,
+		class Allocator = std::allocator<T>
+	> class small_vector {
+		static_assert(N > 0, "A small_vector needs room for at least one inline element!");
+		using alloc_traits = std::allocator_traits<Allocator>;
+	public:
+
+		using value_type             = T;
+		using allocator_type         = Allocator;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = value_type&;
+		using const_reference        = const value_type&;
+		using pointer                = value_type*;
+		using const_pointer          = const value_type*;
+		using iterator               = pointer;
+		using const_iterator         = const_pointer;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static constexpr size_type inline_capacity = N;
+
+		////////////////////////////////////////////////////////////////////////////////
+		//                               Constructors                                 //
+		////////////////////////////////////////////////////////////////////////////////
+
+		small_vector() : small_vector(Allocator()) {}
+
+		explicit small_vector(const Allocator& alloc) noexcept
+			: m_alloc(alloc)
+			, m_data(inline_data())
+			, m_size(0)
+			, m_capacity(N) {}
+
+		explicit small_vector(size_type n, const Allocator& alloc = Allocator())
+			: small_vector(alloc)
+		{
+			resize(n);
+		}
+
+		small_vector(size_type n, const value_type& v, const Allocator& alloc = Allocator())
+			: small_vector(alloc)
+		{
+			resize(n, v);
+		}
+
+		template <class InIt, class = std::enable_if_t<detail::is_iterator_v<InIt>>>
+		small_vector(InIt first, InIt last, const Allocator& alloc = Allocator())
+			: small_vector(alloc)
+		{
+			append(first, last);
+		}
+
+		small_vector(const small_vector& other)
+			: small_vector(alloc_traits::select_on_container_copy_construction(other.get_allocator()))
+		{
+			append(other.begin(), other.end());
+		}
+
+		small_vector(const small_vector& other, const Allocator& alloc)
+			: small_vector(alloc)
+		{
+			append(other.begin(), other.end());
+		}
+
+		small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+			: small_vector(std::move(other.m_alloc))
+		{
+			steal(other);
+		}
+
+		small_vector(small_vector&& other, const Allocator& alloc)
+			: small_vector(alloc)
+		{
+			if (alloc_traits::is_always_equal::value || m_alloc == other.m_alloc)
+				steal(other);
+			else {
+				append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+				other.clear();
+			}
+		}
+
+		small_vector(std::initializer_list<value_type> list, const Allocator& alloc = Allocator())
+			: small_vector(list.begin(), list.end(), alloc) {}
+
+		~small_vector()
+		{
+			clear();
+			release();
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		//                                Assignment                                  //
+		////////////////////////////////////////////////////////////////////////////////
+
+		small_vector& operator=(const small_vector& other) {
+			if (this != std::addressof(other)) {
+				if (alloc_traits::propagate_on_container_copy_assignment::value && m_alloc != other.m_alloc) {
+					clear();
+					release();
+					m_alloc = other.m_alloc;
+				}
+				assign(other.begin(), other.end());
+			}
+			return *this;
+		}
+
+		small_vector& operator=(small_vector&& other) {
+			if (this != std::addressof(other)) {
+				if (alloc_traits::propagate_on_container_move_assignment::value ||
+					alloc_traits::is_always_equal::value || m_alloc == other.m_alloc)
+				{
+					clear();
+					release();
+					if (alloc_traits::propagate_on_container_move_assignment::value)
+						m_alloc = std::move(other.m_alloc);
+					steal(other);
+				}
+				else {
+					assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+					other.clear();
+				}
+			}
+			return *this;
+		}
+
+		small_vector& operator=(std::initializer_list<value_type> list) {
+			assign(list.begin(), list.end());
+			return *this;
+		}
+
+		template <class InIt, class = std::enable_if_t<detail::is_iterator_v<InIt>>>
+		void assign(InIt first, InIt last) {
+			clear();
+			append(first, last);
+		}
+
+		void assign(size_type n, const value_type& v) {
+			if (is_element(v)) {
+				// clear() would destroy v before it is copied
+				value_type tmp(v);
+				assign(n, tmp);
+				return;
+			}
+			clear();
+			resize(n, v);
+		}
+
+		void assign(std::initializer_list<value_type> list) {
+			assign(list.begin(), list.end());
+		}
+
+		allocator_type get_allocator() const noexcept { return m_alloc; }
+
+		////////////////////////////////////////////////////////////////////////////////
+		//                              Element access                                //
+		////////////////////////////////////////////////////////////////////////////////
+
+		reference at(size_type pos) {
+			return const_cast<reference>(const_cast<const small_vector*>(this)->at(pos));
+		}
+
+		const_reference at(size_type pos) const {
+			if (pos >= size())
+				throw std::out_of_range("Index out of range!");
+			return m_data[pos];
+		}
+
+		reference operator[](size_type pos) {
+			assert(pos < size() && "Index out of range!");
+			return m_data[pos];
+		}
+
+		const_reference operator[](size_type pos) const {
+			assert(pos < size() && "Index out of range!");
+			return m_data[pos];
+		}
+
+		reference front() { return *begin(); }
+		const_reference front() const { return *begin(); }
+
+		reference back() { return *std::prev(end()); }
+		const_reference back() const { return *std::prev(end()); }
+
+		pointer data() noexcept { return m_data; }
+		const_pointer data() const noexcept { return m_data; }
+
+		////////////////////////////////////////////////////////////////////////////////
+		//                                 Iterators                                  //
+		////////////////////////////////////////////////////////////////////////////////
+
+		iterator begin() noexcept { return m_data; }
+		const_iterator begin() const noexcept { return m_data; }
+		const_iterator cbegin() const noexcept { return m_data; }
+
+		iterator end() noexcept { return m_data + m_size; }
+		const_iterator end() const noexcept { return m_data + m_size; }
+		const_iterator cend() const noexcept { return m_data + m_size; }
+
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(cend()); }
+		const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(cbegin()); }
+		const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+		////////////////////////////////////////////////////////////////////////////////
+		//                                 Capacity                                   //
+		////////////////////////////////////////////////////////////////////////////////
+
+		bool empty() const noexcept { return m_size == 0; }
+		size_type size() const noexcept { return m_size; }
+		size_type max_size() const noexcept {
+			return std::min<size_type>(alloc_traits::max_size(m_alloc), std::numeric_limits<difference_type>::max());
+		}
+		size_type capacity() const noexcept { return m_capacity; }
+
+		// Whether the elements are stored inside the object rather than on the heap
+		bool is_inline() const noexcept { return m_data == inline_data(); }
+
+		void reserve(size_type new_cap) {
+			if (new_cap > capacity())
+				reallocate(new_cap);
+		}
+
+		// Moves the elements back inline when they fit, or into an exact size allocation
+		void shrink_to_fit() {
+			if (is_inline() || m_size == m_capacity)
+				return;
+			if (m_size <= N) {
+				pointer old_data = m_data;
+				size_type old_capacity = m_capacity;
+				relocate(old_data, old_data + m_size, inline_data());
+				alloc_traits::deallocate(m_alloc, old_data, old_capacity);
+				m_data = inline_data();
+				m_capacity = N;
+			}
+			else
+				reallocate(m_size);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		//                                 Modifiers                                  //
+		////////////////////////////////////////////////////////////////////////////////
+
+		void clear() noexcept {
+			destroy(m_data, m_data + m_size);
+			m_size = 0;
+		}
+
+		iterator insert(const_iterator pos, const value_type& v) { return emplace(pos, v); }
+		iterator insert(const_iterator pos, value_type&& v) { return emplace(pos, std::move(v)); }
+
+		iterator insert(const_iterator pos, size_type n, const value_type& v) {
+			size_type index = pos - cbegin();
+			size_type old_size = m_size;
+			resize(m_size + n, v);
+			std::rotate(m_data + index, m_data + old_size, m_data + m_size);
+			return m_data + index;
+		}
+
+		// Appends the range and rotates it into place
+		template <class InIt, class = std::enable_if_t<detail::is_iterator_v<InIt>>>
+		iterator insert(const_iterator pos, InIt first, InIt last) {
+			size_type index = pos - cbegin();
+			size_type old_size = m_size;
+			append(first, last);
+			std::rotate(m_data + index, m_data + old_size, m_data + m_size);
+			return m_data + index;
+		}
+
+		iterator insert(const_iterator pos, std::initializer_list<value_type> list) {
+			return insert(pos, list.begin(), list.end());
+		}
+
+		template <class... Args>
+		iterator emplace(const_iterator pos, Args&&... args) {
+			size_type index = pos - cbegin();
+			if (m_size == m_capacity) {
+				// The new element is built first, since args may refer to an element
+				size_type new_capacity = grown_capacity(m_size + 1);
+				pointer block = alloc_traits::allocate(m_alloc, new_capacity);
+				try {
+					alloc_traits::construct(m_alloc, block + index, std::forward<Args>(args)...);
+				}
+				catch (...) {
+					alloc_traits::deallocate(m_alloc, block, new_capacity);
+					throw;
+				}
+				relocate(m_data, m_data + index, block);
+				relocate(m_data + index, m_data + m_size, block + index + 1);
+				release();
+				m_data = block;
+				m_capacity = new_capacity;
+			}
+			else if (index == m_size) {
+				alloc_traits::construct(m_alloc, m_data + m_size, std::forward<Args>(args)...);
+			}
+			else {
+				value_type tmp(std::forward<Args>(args)...);
+				alloc_traits::construct(m_alloc, m_data + m_size, std::move(m_data[m_size - 1]));
+				std::move_backward(m_data + index, m_data + m_size - 1, m_data + m_size);
+				m_data[index] = std::move(tmp);
+			}
+			++m_size;
+			return m_data + index;
+		}
+
+		iterator erase(const_iterator pos) {
+			assert(pos != cend() && "Cannot erase the end iterator!");
+			return erase(pos, pos + 1);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) {
+			pointer f = m_data + (first - cbegin());
+			pointer l = m_data + (last - cbegin());
+			if (f != l) {
+				pointer new_end = std::move(l, end(), f);
+				destroy(new_end, end());
+				m_size = new_end - m_data;
+			}
+			return f;
+		}
+
+		void push_back(const value_type& v) { emplace_back(v); }
+		void push_back(value_type&& v) { emplace_back(std::move(v)); }
+
+		template <class... Args>
+		reference emplace_back(Args&&... args) {
+			return *emplace(cend(), std::forward<Args>(args)...);
+		}
+
+		void pop_back() {
+			assert(!empty() && "Cannot pop from an empty small_vector!");
+			alloc_traits::destroy(m_alloc, m_data + --m_size);
+		}
+
+		void resize(size_type n) {
+			if (n < m_size)
+				erase(begin() + n, end());
+			else {
+				reserve(grown_capacity(n));
+				for (; m_size < n; ++m_size)
+					alloc_traits::construct(m_alloc, m_data + m_size);
+			}
+		}
+
+		void resize(size_type n, const value_type& v) {
+			if (n < m_size)
+				erase(begin() + n, end());
+			else if (n > m_capacity && is_element(v)) {
+				// Reallocating would free the storage v lives in
+				value_type tmp(v);
+				resize(n, tmp);
+			}
+			else {
+				reserve(grown_capacity(n));
+				for (; m_size < n; ++m_size)
+					alloc_traits::construct(m_alloc, m_data + m_size, v);
+			}
+		}
+
+		void swap(small_vector& other) {
+			if (this == std::addressof(other))
+				return;
+			if (!is_inline() && !other.is_inline() &&
+				(alloc_traits::propagate_on_container_swap::value || m_alloc == other.m_alloc))
+			{
+				if (alloc_traits::propagate_on_container_swap::value)
+					std::swap(m_alloc, other.m_alloc);
+				std::swap(m_data, other.m_data);
+				std::swap(m_size, other.m_size);
+				std::swap(m_capacity, other.m_capacity);
+			}
+			else {
+				small_vector tmp(std::move(other));
+				other = std::move(*this);
+				*this = std::move(tmp);
+			}
+		}
+
+	private:
+
+		allocator_type m_alloc; // Memory management handle
+		pointer m_data;         // Inline storage or a heap allocation
+		size_type m_size;       // Number of elements
+		size_type m_capacity;   // Number of elements that fit in m_data
+		alignas(T) unsigned char m_inline[N * sizeof(T)];
+
+		pointer inline_data() noexcept { return reinterpret_cast<pointer>(m_inline); }
+		const_pointer inline_data() const noexcept { return reinterpret_cast<const_pointer>(m_inline); }
+
+		// Whether v is one of the elements, which modifiers taking v by reference must
+		// copy before freeing or destroying the storage it lives in
+		bool is_element(const value_type& v) const noexcept {
+			const value_type* p = std::addressof(v);
+			return std::less_equal<const value_type*>()(m_data, p) && std::less<const value_type*>()(p, m_data + m_size);
+		}
+
+		size_type grown_capacity(size_type required) const {
+			if (required <= m_capacity)
+				return m_capacity;
+			if (required > max_size())
+				throw std::length_error("small_vector cannot grow beyond max_size()!");
+			return std::max(required, std::min(max_size(), 2 * m_capacity));
+		}
+
+		// Appends a range, allocating at most once when its length is known up front
+		template <class InIt>
+		void append(InIt first, InIt last) {
+			using category = typename std::iterator_traits<InIt>::iterator_category;
+			if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+				reserve(grown_capacity(m_size + std::distance(first, last)));
+				for (; first != last; ++first, ++m_size)
+					alloc_traits::construct(m_alloc, m_data + m_size, *first);
+			}
+			else {
+				for (; first != last; ++first)
+					emplace_back(*first);
+			}
+		}
+
+		void destroy(pointer first, pointer last) noexcept {
+			for (; first != last; ++first)
+				alloc_traits::destroy(m_alloc, first);
+		}
+
+		// Moves [first, last) into uninitialized storage at out, destroying the originals
+		void relocate(pointer first, pointer last, pointer out) {
+			for (; first != last; ++first, ++out) {
+				alloc_traits::construct(m_alloc, out, std::move_if_noexcept(*first));
+				alloc_traits::destroy(m_alloc, first);
+			}
+		}
+
+		void reallocate(size_type new_capacity) {
+			pointer block = alloc_traits::allocate(m_alloc, new_capacity);
+			relocate(m_data, m_data + m_size, block);
+			release();
+			m_data = block;
+			m_capacity = new_capacity;
+		}
+
+		// Frees the heap allocation, if any, leaving the object pointing at its inline storage
+		void release() noexcept {
+			if (!is_inline()) {
+				alloc_traits::deallocate(m_alloc, m_data, m_capacity);
+				m_data = inline_data();
+				m_capacity = N;
+			}
+		}
+
+		// Takes over the elements of other, which is left empty
+		void steal(small_vector& other) {
+			if (other.is_inline()) {
+				relocate(other.m_data, other.m_data + other.m_size, m_data);
+				m_size = other.m_size;
+				other.m_size = 0;
+			}
+			else {
+				m_data = other.m_data;
+				m_size = other.m_size;
+				m_capacity = other.m_capacity;
+				other.m_data = other.inline_data();
+				other.m_size = 0;
+				other.m_capacity = N;
+			}
+		}
+
+	};
+
+	template <class T, std::size_t N, class Allocator>
+	bool operator==(const small_vector<T, N, Allocator>& lhs, const small_vector<T, N, Allocator>& rhs) {
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <class T, std::size_t N, class Allocator>
+	bool operator!=(const small_vector<T, N, Allocator>& lhs, const small_vector<T, N, Allocator>& rhs) {
+		return !(lhs == rhs);
+	}
+
+	template <class T, std::size_t N, class Allocator>
+	bool operator<(const small_vector<T, N, Allocator>& lhs, const small_vector<T, N, Allocator>& rhs) {
+		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <class T, std::size_t N, class Allocator>
+	bool operator<=(const small_vector<T, N, Allocator>& lhs, const small_vector<T, N, Allocator>& rhs) {
+		return !(rhs < lhs);
+	}
+
+	template <class T, std::size_t N, class Allocator>
+	bool operator>(const small_vector<T, N, Allocator>& lhs, const small_vector<T, N, Allocator>& rhs) {
+		return rhs < lhs;
+	}
+
+	template <class T, std::size_t N, class Allocator>
+	bool operator>=(const small_vector<T, N, Allocator>& lhs, const small_vector<T, N, Allocator>& rhs) {
+		return !(lhs < rhs);
+	}
+
+}
+
+namespace std {
+	template <class T, std::size_t N, class Allocator>
+	void swap(ancillary::small_vector<T, N, Allocator>& lhs, ancillary::small_vector<T, N, Allocator>& rhs) {
+		lhs.swap(rhs);
+	}
+}
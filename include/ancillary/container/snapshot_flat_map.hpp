@@ -0,0 +1,266 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include "flat_map.hpp"
+#include "../detail/prefetch.hpp"
+
+namespace ancillary {
+
+	// A flat_map shared between one or more writers and many concurrent readers.
+	// Readers pin an immutable version with read(), which claims a reader slot with
+	// a compare-exchange and then loads the current version. The search for a slot
+	// starts at one picked by hashing the thread id. Slots sit on separate cache lines,
+	// so readers only contend when they collide on a slot. When every slot is busy a
+	// reader claims or adds an overflow slot rather than wait, so read() never takes a
+	// lock or waits for another reader. Writers are serialized, copy the current
+	// version, apply a whole batch of mutations to the copy and publish it with one
+	// atomic exchange. Replaced versions are retired and freed by the writer once every
+	// reader slot has either gone idle or moved past the epoch in which the version
+	// was replaced.
+	template <
+		class Key,
+		class T,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<Key, T>>,
+		class SearchPolicy = binary_search_policy
+	> class snapshot_flat_map {
+	public:
+
+		using map_type    = flat_map<Key, T, Compare, Allocator, SearchPolicy>;
+		using key_type    = Key;
+		using mapped_type = T;
+		using value_type  = std::pair<Key, T>;
+		using size_type   = std::size_t;
+
+		// Keeps one version of the map alive for as long as it exists. Readers should
+		// hold a snapshot only for the duration of a lookup or a short batch of them,
+		// since a pinned version holds back the reclamation of every later one.
+		class snapshot {
+		public:
+			snapshot() noexcept = default;
+
+			snapshot(const snapshot&) = delete;
+
+			snapshot(snapshot&& other) noexcept
+				: m_slot(std::exchange(other.m_slot, nullptr))
+				, m_map(std::exchange(other.m_map, nullptr)) {}
+
+			~snapshot() {
+				release();
+			}
+
+			snapshot& operator=(const snapshot&) = delete;
+
+			snapshot& operator=(snapshot&& other) noexcept {
+				if (this != &other) {
+					release();
+					m_slot = std::exchange(other.m_slot, nullptr);
+					m_map = std::exchange(other.m_map, nullptr);
+				}
+				return *this;
+			}
+
+			const map_type& operator*() const noexcept {
+				assert(m_map && "Bad snapshot dereference!");
+				return *m_map;
+			}
+
+			const map_type* operator->() const noexcept {
+				assert(m_map && "Bad snapshot dereference!");
+				return m_map;
+			}
+
+			const map_type* get() const noexcept { return m_map; }
+
+			explicit operator bool() const noexcept { return m_map != nullptr; }
+
+			void release() noexcept {
+				if (m_slot)
+					m_slot->store(0, std::memory_order_release);
+				m_slot = nullptr;
+				m_map = nullptr;
+			}
+
+		private:
+			friend class snapshot_flat_map;
+
+			snapshot(std::atomic<std::uint64_t>* slot, const map_type* map) noexcept
+				: m_slot(slot)
+				, m_map(map) {}
+
+			std::atomic<std::uint64_t>* m_slot = nullptr;
+			const map_type* m_map = nullptr;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                  CONSTRUCTORS                                  //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		snapshot_flat_map()
+			: snapshot_flat_map(map_type()) {}
+
+		// Room for reader_slots concurrent snapshots up front. Readers beyond that add
+		// overflow slots, which are kept for reuse until the map is destroyed.
+		explicit snapshot_flat_map(map_type map, size_type reader_slots = default_reader_slots())
+			: m_slots(new reader_slot[std::max<size_type>(reader_slots, 1)])
+			, m_slot_count(std::max<size_type>(reader_slots, 1))
+			, m_current(new map_type(std::move(map))) {}
+
+		snapshot_flat_map(const snapshot_flat_map&) = delete;
+		snapshot_flat_map(snapshot_flat_map&&) = delete;
+
+		~snapshot_flat_map() {
+			assert(std::all_of(m_slots.get(), m_slots.get() + m_slot_count, [](const reader_slot& slot) {
+				return slot.epoch.load() == 0;
+			}) && "Destroyed while snapshots are held!");
+			for (reader_slot* slot = m_overflow.load(); slot;) {
+				assert(slot->epoch.load() == 0 && "Destroyed while snapshots are held!");
+				delete std::exchange(slot, slot->next);
+			}
+			delete m_current.load();
+			for (auto& version : m_retired)
+				delete version.first;
+		}
+
+		snapshot_flat_map& operator=(const snapshot_flat_map&) = delete;
+		snapshot_flat_map& operator=(snapshot_flat_map&&) = delete;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     READERS                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		// Pins the current version of the map. The slot must announce the epoch before
+		// the version is loaded, so that a writer either sees the announcement or the
+		// reader sees the newer version.
+		snapshot read() const {
+			const size_type start = std::hash<std::thread::id>()(std::this_thread::get_id()) % m_slot_count;
+			size_type i = start;
+			do {
+				if (claim(m_slots[i]))
+					return snapshot(&m_slots[i].epoch, m_current.load());
+				if (++i == m_slot_count)
+					i = 0;
+			} while (i != start);
+
+			for (reader_slot* slot = m_overflow.load(); slot; slot = slot->next)
+				if (claim(*slot))
+					return snapshot(&slot->epoch, m_current.load());
+			// Every slot is busy, so announce through a new one
+			auto* slot = new reader_slot;
+			slot->epoch.store(m_epoch.load(), std::memory_order_relaxed);
+			slot->next = m_overflow.load();
+			while (!m_overflow.compare_exchange_weak(slot->next, slot))
+				;
+			return snapshot(&slot->epoch, m_current.load());
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     WRITERS                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		// Applies mutate to a copy of the current version and publishes the result.
+		// Batch as many mutations as possible into one call, since every call copies
+		// the whole map.
+		template <class F>
+		void update(F&& mutate) {
+			std::lock_guard<std::mutex> lock(m_write);
+			auto next = std::make_unique<map_type>(*m_current.load());
+			std::forward<F>(mutate)(*next);
+			publish(next.release());
+		}
+
+		// Replaces the contents of the map
+		void assign(map_type map) {
+			std::lock_guard<std::mutex> lock(m_write);
+			publish(new map_type(std::move(map)));
+		}
+
+		template <class M>
+		void insert_or_assign(const key_type& key, M&& obj) {
+			update([&](map_type& map) { map.insert_or_assign(key, std::forward<M>(obj)); });
+		}
+
+		size_type erase(const key_type& key) {
+			size_type erased = 0;
+			update([&](map_type& map) { erased = map.erase(key); });
+			return erased;
+		}
+
+		// Frees every retired version that no reader can still see
+		void reclaim() {
+			std::lock_guard<std::mutex> lock(m_write);
+			reclaim_retired();
+		}
+
+		// Number of replaced versions still waiting for readers to move on
+		size_type retired() const {
+			std::lock_guard<std::mutex> lock(m_write);
+			return m_retired.size();
+		}
+
+	private:
+
+		struct alignas(detail::cache_line_size) reader_slot {
+			std::atomic<std::uint64_t> epoch{ 0 }; // Epoch announced by the reader, 0 when idle
+			reader_slot* next = nullptr; // Next overflow slot, set before the slot is shared
+		};
+
+		static size_type default_reader_slots() {
+			return std::max<size_type>(64, 2 * static_cast<size_type>(std::thread::hardware_concurrency()));
+		}
+
+		bool claim(reader_slot& slot) const {
+			std::uint64_t idle = 0;
+			return slot.epoch.load(std::memory_order_relaxed) == 0 && slot.epoch.compare_exchange_strong(idle, m_epoch.load());
+		}
+
+		// Requires m_write to be held
+		void publish(const map_type* next) {
+			const map_type* prev = m_current.exchange(next);
+			const std::uint64_t epoch = m_epoch.fetch_add(1) + 1;
+			m_retired.emplace_back(prev, epoch);
+			reclaim_retired();
+		}
+
+		// A version retired at epoch e can be freed once no reader announced an epoch
+		// below e, because any reader that announced e or later loaded a newer version.
+		// Requires m_write to be held.
+		void reclaim_retired() {
+			std::uint64_t oldest = UINT64_MAX;
+			auto visit = [&oldest](const reader_slot& slot) {
+				auto epoch = slot.epoch.load();
+				if (epoch != 0)
+					oldest = std::min(oldest, epoch);
+			};
+			for (size_type i = 0; i < m_slot_count; ++i)
+				visit(m_slots[i]);
+			for (const reader_slot* slot = m_overflow.load(); slot; slot = slot->next)
+				visit(*slot);
+			auto reclaimable = std::stable_partition(m_retired.begin(), m_retired.end(), [oldest](const auto& version) {
+				return version.second > oldest;
+			});
+			for (auto it = reclaimable; it != m_retired.end(); ++it)
+				delete it->first;
+			m_retired.erase(reclaimable, m_retired.end());
+		}
+
+		std::unique_ptr<reader_slot[]> m_slots; // One announcement slot per concurrent reader
+		size_type m_slot_count;
+		mutable std::atomic<reader_slot*> m_overflow{ nullptr }; // Slots added while every other one was busy
+		std::atomic<const map_type*> m_current; // The version handed to new readers
+		std::atomic<std::uint64_t> m_epoch{ 1 }; // Bumped every time a version is published
+		mutable std::mutex m_write; // Serializes writers
+		std::vector<std::pair<const map_type*, std::uint64_t>> m_retired; // Replaced versions and their retirement epochs
+
+	};
+
+}
@@ -0,0 +1,542 @@
+#pragma once
+
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cassert>
+#include <stdexcept>
+#include <algorithm>
+#include "../detail/flat_tree.hpp"
+#include "../detail/sequence.hpp"
+#include "../detail/extract_key.hpp"
+#include "../detail/zip_iterator.hpp"
+
+namespace ancillary {
+
+	// A sorted map that keeps its keys and mapped values in two separate containers,
+	// in the style of C++23 std::flat_map. Searches only touch the key container, so
+	// large mapped values do not dilute the cache lines read by each probe.
+	template <
+		class Key,
+		class T,
+		class Compare = std::less<Key>,
+		class KeyContainer = std::vector<Key>,
+		class MappedContainer = std::vector<T>,
+		class SearchPolicy = binary_search_policy
+	> class split_flat_map {
+	public:
+
+		using key_type               = Key;
+		using mapped_type            = T;
+		using value_type             = std::pair<Key, T>;
+		using key_compare            = Compare;
+		using reference              = std::pair<const Key&, T&>;
+		using const_reference        = std::pair<const Key&, const T&>;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using iterator               = detail::zip_iterator<typename KeyContainer::const_iterator, typename MappedContainer::iterator>;
+		using const_iterator         = detail::zip_iterator<typename KeyContainer::const_iterator, typename MappedContainer::const_iterator>;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+		using key_container_type     = KeyContainer;
+		using mapped_container_type  = MappedContainer;
+		using search_policy          = SearchPolicy;
+
+		struct containers {
+			key_container_type keys;
+			mapped_container_type values;
+		};
+
+		class value_compare {
+			friend class split_flat_map;
+			Compare m_cmp;
+			value_compare(Compare c)
+				: m_cmp(c) {}
+		public:
+			template <class Lhs, class Rhs>
+			bool operator()(const Lhs& lhs, const Rhs& rhs) const {
+				return m_cmp(lhs.first, rhs.first);
+			}
+		};
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                  CONSTRUCTORS                                  //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		split_flat_map()
+			: split_flat_map(Compare()) {}
+
+		explicit split_flat_map(const Compare& comp)
+			: m_keys()
+			, m_values()
+			, m_kcmp(comp) {}
+
+		split_flat_map(key_container_type keys, mapped_container_type values,
+			const Compare& comp = Compare())
+			: m_keys(detail::make_sequence<key_container_type>(detail::sequence_get_allocator<key_allocator>(keys)))
+			, m_values(detail::make_sequence<mapped_container_type>(detail::sequence_get_allocator<mapped_allocator>(values)))
+			, m_kcmp(comp)
+		{
+			assert(keys.size() == values.size() && "Containers differ in size!");
+			std::vector<value_type> pairs;
+			pairs.reserve(keys.size());
+			for (size_type i = 0; i < keys.size(); ++i)
+				pairs.emplace_back(std::move(keys[i]), std::move(values[i]));
+			insert(std::make_move_iterator(pairs.begin()), std::make_move_iterator(pairs.end()));
+		}
+
+		split_flat_map(sorted_unique_t, key_container_type keys, mapped_container_type values,
+			const Compare& comp = Compare())
+			: m_keys(std::move(keys))
+			, m_values(std::move(values))
+			, m_kcmp(comp)
+		{
+			assert(m_keys.size() == m_values.size() && "Containers differ in size!");
+			assert(is_ordered(m_keys) && "Keys are not sorted!");
+		}
+
+		template <class InIt>
+		split_flat_map(InIt first, InIt last,
+			const Compare& comp = Compare())
+			: split_flat_map(comp)
+		{
+			insert(first, last);
+		}
+
+		template <class InIt>
+		split_flat_map(sorted_unique_t tag, InIt first, InIt last,
+			const Compare& comp = Compare())
+			: split_flat_map(comp)
+		{
+			insert(tag, first, last);
+		}
+
+		split_flat_map(std::initializer_list<value_type> list,
+			const Compare& comp = Compare())
+			: split_flat_map(list.begin(), list.end(), comp) {}
+
+		split_flat_map(sorted_unique_t tag, std::initializer_list<value_type> list,
+			const Compare& comp = Compare())
+			: split_flat_map(tag, list.begin(), list.end(), comp) {}
+
+		split_flat_map(const split_flat_map&) = default;
+		split_flat_map(split_flat_map&&) = default;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                   DESTRUCTOR                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		~split_flat_map() = default;
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                   ASSIGNMENT                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		split_flat_map& operator=(const split_flat_map&) = default;
+		split_flat_map& operator=(split_flat_map&&) = default;
+		split_flat_map& operator=(std::initializer_list<value_type> list) {
+			clear();
+			insert(list);
+			return *this;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    ITERATORS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		iterator begin() noexcept { return { m_keys.cbegin(), m_values.begin() }; }
+		const_iterator begin() const noexcept { return { m_keys.cbegin(), m_values.cbegin() }; }
+		const_iterator cbegin() const noexcept { return begin(); }
+
+		iterator end() noexcept { return { m_keys.cend(), m_values.end() }; }
+		const_iterator end() const noexcept { return { m_keys.cend(), m_values.cend() }; }
+		const_iterator cend() const noexcept { return end(); }
+
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+		const_reverse_iterator crend() const noexcept { return rend(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    CAPACITY                                    //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		bool empty() const noexcept { return m_keys.empty(); }
+		size_type size() const noexcept { return m_keys.size(); }
+		size_type max_size() const noexcept { return std::min<size_type>(m_keys.max_size(), m_values.max_size()); }
+		void reserve(size_type new_cap) { m_keys.reserve(new_cap); m_values.reserve(new_cap); }
+		void shrink_to_fit() { m_keys.shrink_to_fit(); m_values.shrink_to_fit(); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                 ELEMENT ACCESS                                 //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		mapped_type& at(const key_type& key) {
+			return const_cast<mapped_type&>(const_cast<const split_flat_map*>(this)->at(key));
+		}
+
+		const mapped_type& at(const key_type& key) const {
+			auto it = find(key);
+			if (it == end())
+				throw std::out_of_range("No such element with the given key!");
+			else
+				return it->second;
+		}
+
+		mapped_type& operator[](const key_type& key) {
+			return try_emplace(key).first->second;
+		}
+
+		mapped_type& operator[](key_type&& key) {
+			return try_emplace(std::move(key)).first->second;
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    MODIFIERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		void clear() noexcept {
+			m_keys.clear();
+			m_values.clear();
+		}
+
+		std::pair<iterator, bool> insert(const value_type& x) { return try_emplace(x.first, x.second); }
+		std::pair<iterator, bool> insert(value_type&& x) { return try_emplace(std::move(x.first), std::move(x.second)); }
+
+		iterator insert(const_iterator hint, const value_type& x) { return try_emplace(hint, x.first, x.second); }
+		iterator insert(const_iterator hint, value_type&& x) { return try_emplace(hint, std::move(x.first), std::move(x.second)); }
+
+		template <class InIt>
+		void insert(InIt first, InIt last) {
+			std::vector<value_type> tail(first, last);
+			std::stable_sort(tail.begin(), tail.end(), value_comp());
+			merge_sorted(tail);
+		}
+
+		template <class InIt>
+		void insert(sorted_unique_t, InIt first, InIt last) {
+			std::vector<value_type> tail(first, last);
+			assert(std::is_sorted(tail.begin(), tail.end(), value_comp()) && "Range is not sorted!");
+			merge_sorted(tail);
+		}
+
+		void insert(std::initializer_list<value_type> list) {
+			insert(list.begin(), list.end());
+		}
+
+		void insert(sorted_unique_t tag, std::initializer_list<value_type> list) {
+			insert(tag, list.begin(), list.end());
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args) {
+			return insert(value_type(std::forward<Args>(args)...));
+		}
+
+		template <class... Args>
+		iterator emplace_hint(const_iterator hint, Args&&... args) {
+			return insert(hint, value_type(std::forward<Args>(args)...));
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+			return try_emplace_impl(lower_index(k), k, std::forward<Args>(args)...);
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+			return try_emplace_impl(lower_index(k), std::move(k), std::forward<Args>(args)...);
+		}
+
+		template <class... Args>
+		iterator try_emplace(const_iterator hint, const key_type& k, Args&&... args) {
+			return try_emplace_impl(hinted_index(hint, k), k, std::forward<Args>(args)...).first;
+		}
+
+		template <class... Args>
+		iterator try_emplace(const_iterator hint, key_type&& k, Args&&... args) {
+			return try_emplace_impl(hinted_index(hint, k), std::move(k), std::forward<Args>(args)...).first;
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+			auto ret = try_emplace(k, std::forward<M>(obj));
+			if (!ret.second)
+				ret.first->second = std::forward<M>(obj);
+			return ret;
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+			auto ret = try_emplace(std::move(k), std::forward<M>(obj));
+			if (!ret.second)
+				ret.first->second = std::forward<M>(obj);
+			return ret;
+		}
+
+		template <class M>
+		iterator insert_or_assign(const_iterator hint, const key_type& k, M&& obj) {
+			auto ret = try_emplace_impl(hinted_index(hint, k), k, std::forward<M>(obj));
+			if (!ret.second)
+				ret.first->second = std::forward<M>(obj);
+			return ret.first;
+		}
+
+		template <class M>
+		iterator insert_or_assign(const_iterator hint, key_type&& k, M&& obj) {
+			auto ret = try_emplace_impl(hinted_index(hint, k), std::move(k), std::forward<M>(obj));
+			if (!ret.second)
+				ret.first->second = std::forward<M>(obj);
+			return ret.first;
+		}
+
+		iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+		iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+		iterator erase(const_iterator first, const_iterator last) {
+			auto i = first - cbegin();
+			m_keys.erase(first.first(), last.first());
+			m_values.erase(first.second(), last.second());
+			return make_iterator(i);
+		}
+
+		size_type erase(const key_type& key) {
+			auto it = find(key);
+			if (it == end())
+				return 0;
+			erase(it);
+			return 1;
+		}
+
+		void swap(split_flat_map& other) {
+			if (this != &other) {
+				std::swap(m_kcmp, other.m_kcmp);
+				std::swap(m_keys, other.m_keys);
+				std::swap(m_values, other.m_values);
+			}
+		}
+
+		containers extract() && {
+			containers data{ std::move(m_keys), std::move(m_values) };
+			clear();
+			return data;
+		}
+
+		void replace(key_container_type&& keys, mapped_container_type&& values) {
+			assert(keys.size() == values.size() && "Containers differ in size!");
+			assert(is_ordered(keys) && "Keys are not sorted!");
+			m_keys = std::move(keys);
+			m_values = std::move(values);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                     LOOKUP                                     //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		size_type count(const key_type& key) const { return contains(key); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		size_type count(const K& key) const { return contains(key); }
+
+		iterator find(const key_type& key) { return make_iterator(find_index(key)); }
+		const_iterator find(const key_type& key) const { return make_iterator(find_index(key)); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		iterator find(const K& key) { return make_iterator(find_index(key)); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator find(const K& key) const { return make_iterator(find_index(key)); }
+
+		bool contains(const key_type& key) const { return find_index(key) != size(); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		bool contains(const K& key) const { return find_index(key) != size(); }
+
+		std::pair<iterator, iterator> equal_range(const key_type& key) {
+			auto i = find_index(key);
+			return { make_iterator(i), make_iterator(i == size() ? i : i + 1) };
+		}
+
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+			auto i = find_index(key);
+			return { make_iterator(i), make_iterator(i == size() ? i : i + 1) };
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		std::pair<iterator, iterator> equal_range(const K& key) {
+			return { lower_bound(key), upper_bound(key) };
+		}
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+			return { lower_bound(key), upper_bound(key) };
+		}
+
+		iterator lower_bound(const key_type& key) { return make_iterator(lower_index(key)); }
+		const_iterator lower_bound(const key_type& key) const { return make_iterator(lower_index(key)); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		iterator lower_bound(const K& key) { return make_iterator(lower_index(key)); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator lower_bound(const K& key) const { return make_iterator(lower_index(key)); }
+
+		iterator upper_bound(const key_type& key) { return make_iterator(upper_index(key)); }
+		const_iterator upper_bound(const key_type& key) const { return make_iterator(upper_index(key)); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		iterator upper_bound(const K& key) { return make_iterator(upper_index(key)); }
+
+		template <class K, class = std::enable_if_t<detail::is_transparent_v<Compare, K>>>
+		const_iterator upper_bound(const K& key) const { return make_iterator(upper_index(key)); }
+
+		////////////////////////////////////////////////////////////////////////////////////
+		//                                    OBSERVERS                                   //
+		////////////////////////////////////////////////////////////////////////////////////
+
+		key_compare key_comp() const { return m_kcmp; }
+		value_compare value_comp() const { return value_compare(m_kcmp); }
+
+		const key_container_type& keys() const noexcept { return m_keys; }
+		const mapped_container_type& values() const noexcept { return m_values; }
+
+	private:
+
+		using key_extract = detail::identity<Key>;
+		using search_type = detail::container_search<KeyContainer, Compare, key_extract, SearchPolicy>;
+		using key_allocator = detail::sequence_allocator_t<KeyContainer, std::allocator<Key>>;
+		using mapped_allocator = detail::sequence_allocator_t<MappedContainer, std::allocator<T>>;
+
+		iterator make_iterator(size_type i) noexcept {
+			return { m_keys.cbegin() + i, m_values.begin() + i };
+		}
+
+		const_iterator make_iterator(size_type i) const noexcept {
+			return { m_keys.cbegin() + i, m_values.cbegin() + i };
+		}
+
+		template <class K>
+		size_type lower_index(const K& key) const {
+			return search_type::lower_bound(m_keys, m_keys.cbegin(), m_keys.cend(), key, m_kcmp, key_extract()) - m_keys.cbegin();
+		}
+
+		template <class K>
+		size_type upper_index(const K& key) const {
+			return search_type::upper_bound(m_keys, m_keys.cbegin(), m_keys.cend(), key, m_kcmp, key_extract()) - m_keys.cbegin();
+		}
+
+		template <class K>
+		size_type find_index(const K& key) const {
+			auto i = lower_index(key);
+			return i != size() && !m_kcmp(key, m_keys[i]) ? i : size();
+		}
+
+		// Uses the hint when the key belongs right before it, otherwise searches
+		size_type hinted_index(const_iterator hint, const key_type& key) const {
+			size_type i = hint - cbegin();
+			if ((i == size() || m_kcmp(key, m_keys[i])) && (i == 0 || m_kcmp(m_keys[i - 1], key)))
+				return i;
+			return lower_index(key);
+		}
+
+		template <class K, class... Args>
+		std::pair<iterator, bool> try_emplace_impl(size_type i, K&& key, Args&&... args) {
+			if (i != size() && !m_kcmp(key, m_keys[i]))
+				return { make_iterator(i), false };
+			auto kit = m_keys.emplace(m_keys.cbegin() + i, std::forward<K>(key));
+			try {
+				m_values.emplace(m_values.cbegin() + i, std::forward<Args>(args)...);
+			}
+			catch (...) {
+				m_keys.erase(kit);
+				throw;
+			}
+			return { make_iterator(i), true };
+		}
+
+		bool is_ordered(const key_container_type& keys) const {
+			return std::adjacent_find(keys.begin(), keys.end(), [this](const key_type& lhs, const key_type& rhs) {
+				return !m_kcmp(lhs, rhs);
+			}) == keys.end();
+		}
+
+		// Merges a sorted run of pairs into the map with one allocation per container. Only
+		// the first of several equivalent keys is kept and existing keys are never replaced.
+		// The merged containers are built aside with the map's allocators, moving existing
+		// elements only when that cannot throw, so the map is left untouched on failure.
+		void merge_sorted(std::vector<value_type>& tail) {
+			auto equal = [this](const value_type& lhs, const value_type& rhs) {
+				return !m_kcmp(lhs.first, rhs.first) && !m_kcmp(rhs.first, lhs.first);
+			};
+			tail.erase(std::unique(tail.begin(), tail.end(), equal), tail.end());
+			if (tail.empty())
+				return;
+
+			auto keys = detail::make_sequence<key_container_type>(detail::sequence_get_allocator<key_allocator>(m_keys));
+			auto values = detail::make_sequence<mapped_container_type>(detail::sequence_get_allocator<mapped_allocator>(m_values));
+			detail::sequence_reserve(keys, size() + tail.size());
+			detail::sequence_reserve(values, size() + tail.size());
+			auto take_tail = [&](value_type& x) {
+				keys.push_back(std::move(x.first));
+				values.push_back(std::move(x.second));
+			};
+			auto take_existing = [&](size_type i) {
+				keys.push_back(std::move_if_noexcept(m_keys[i]));
+				values.push_back(std::move_if_noexcept(m_values[i]));
+			};
+			size_type i = 0;
+			auto it = tail.begin();
+			while (i < size() && it != tail.end()) {
+				if (m_kcmp(it->first, m_keys[i])) {
+					take_tail(*it++);
+				}
+				else {
+					if (!m_kcmp(m_keys[i], it->first))
+						++it;
+					take_existing(i++);
+				}
+			}
+			for (; i < size(); ++i)
+				take_existing(i);
+			for (; it != tail.end(); ++it)
+				take_tail(*it);
+			m_keys = std::move(keys);
+			m_values = std::move(values);
+		}
+
+		key_container_type    m_keys;   // Sorted keys
+		mapped_container_type m_values; // Mapped values, parallel to the keys
+		key_compare           m_kcmp;   // Key comparison
+
+	};
+
+	template <class Key, class T, class Compare, class KeyContainer, class MappedContainer, class SearchPolicy>
+	bool operator==(
+		const split_flat_map<Key, T, Compare, KeyContainer, MappedContainer, SearchPolicy>& lhs,
+		const split_flat_map<Key, T, Compare, KeyContainer, MappedContainer, SearchPolicy>& rhs)
+	{
+		return lhs.keys() == rhs.keys() && lhs.values() == rhs.values();
+	}
+
+	template <class Key, class T, class Compare, class KeyContainer, class MappedContainer, class SearchPolicy>
+	bool operator!=(
+		const split_flat_map<Key, T, Compare, KeyContainer, MappedContainer, SearchPolicy>& lhs,
+		const split_flat_map<Key, T, Compare, KeyContainer, MappedContainer, SearchPolicy>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+}
+
+namespace std {
+	template <class Key, class T, class Compare, class KeyContainer, class MappedContainer, class SearchPolicy>
+	void swap(
+		ancillary::split_flat_map<Key, T, Compare, KeyContainer, MappedContainer, SearchPolicy>& lhs,
+		ancillary::split_flat_map<Key, T, Compare, KeyContainer, MappedContainer, SearchPolicy>& rhs)
+	{
+		return lhs.swap(rhs);
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include "prefetch.hpp"
+#include "search_policy.hpp"
+
+namespace ancillary {
+	namespace detail {
+
+		// Number of searches advanced in lockstep by interleaved_lower_bound
+		inline constexpr std::size_t batch_group_size = 16;
+
+		// Largest average gap between sorted keys for which batch_lower_bound gallops
+		inline constexpr std::size_t galloping_density = 64;
+
+		// Runs the lower bound searches of a group of keys side by side. Every search in
+		// the group has the same length at each step, so one pass over the group issues a
+		// probe and a prefetch per search, letting their cache misses overlap.
+		template <class RndIt, class KeyIt, class Compare, class ExtractKey, class Visitor>
+		void interleaved_lower_bound(RndIt first, RndIt last, KeyIt keys_first, KeyIt keys_last,
+			const Compare& comp, const ExtractKey& ext, Visitor visit)
+		{
+			typename std::iterator_traits<RndIt>::difference_type len, half;
+			RndIt base[batch_group_size];
+			KeyIt keys[batch_group_size];
+			while (keys_first != keys_last) {
+				std::size_t n = 0;
+				for (; n < batch_group_size && keys_first != keys_last; ++n, ++keys_first) {
+					keys[n] = keys_first;
+					base[n] = first;
+				}
+				len = last - first;
+				if (len == 0) {
+					for (std::size_t i = 0; i < n; ++i)
+						visit(*keys[i], first);
+					continue;
+				}
+				while (len > 1) {
+					half = len / 2;
+					for (std::size_t i = 0; i < n; ++i) {
+						base[i] += comp(ext(base[i][half]), *keys[i]) ? half : 0;
+						prefetch(std::addressof(base[i][(len - half) / 2]));
+					}
+					len -= half;
+				}
+				for (std::size_t i = 0; i < n; ++i)
+					visit(*keys[i], base[i] + comp(ext(*base[i]), *keys[i]));
+			}
+		}
+
+		// Finds the lower bounds of sorted keys in a single forward pass. Each search
+		// gallops from the previous result, so it costs O(log d) for a distance d.
+		template <class RndIt, class KeyIt, class Compare, class ExtractKey, class Visitor>
+		void galloping_lower_bound(RndIt first, RndIt last, KeyIt keys_first, KeyIt keys_last,
+			const Compare& comp, const ExtractKey& ext, Visitor visit)
+		{
+			typename std::iterator_traits<RndIt>::difference_type len, step;
+			for (; keys_first != keys_last; ++keys_first) {
+				const auto& key = *keys_first;
+				len = last - first;
+				if (len != 0 && comp(ext(*first), key)) {
+					step = 1;
+					while (step < len && comp(ext(first[step]), key))
+						step *= 2;
+					first = branchless_search_policy::lower_bound(first + (step / 2 + 1), first + std::min(step, len), key, comp, ext);
+				}
+				visit(key, first);
+			}
+		}
+
+		// Visits the lower bound of every key in [keys_first, keys_last) within the sorted
+		// range [first, last), in the order of the keys. Galloping only pays off when the
+		// sorted keys are dense enough for consecutive results to share cache lines.
+		template <class RndIt, class KeyIt, class Compare, class ExtractKey, class Visitor>
+		void batch_lower_bound(RndIt first, RndIt last, KeyIt keys_first, KeyIt keys_last,
+			const Compare& comp, const ExtractKey& ext, Visitor visit)
+		{
+			const auto count = static_cast<std::size_t>(std::distance(keys_first, keys_last));
+			const auto len = static_cast<std::size_t>(last - first);
+			if (count * galloping_density >= len && std::is_sorted(keys_first, keys_last, comp))
+				galloping_lower_bound(first, last, keys_first, keys_last, comp, ext, visit);
+			else
+				interleaved_lower_bound(first, last, keys_first, keys_last, comp, ext, visit);
+		}
+
+	}
+}
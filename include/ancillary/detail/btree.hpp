@@ -0,0 +1,805 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cassert>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include "flat_tree.hpp"
+#include "prefetch.hpp"
+#include "extract_key.hpp"
+#include "../container/small_vector.hpp"
+
+namespace ancillary {
+	namespace detail {
+
+		// Bidirectional iterator over the elements of a chain of btree leaves
+		template <
+			class Leaf,
+			class Value,
+			class Pointer
+		> class btree_iterator {
+			template <class, class, class> friend class btree_iterator;
+			template <class, class, class, class, class> friend class btree;
+		public:
+
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type        = Value;
+			using difference_type   = std::ptrdiff_t;
+			using pointer           = Pointer;
+			using reference         = decltype(*std::declval<Pointer>());
+
+			btree_iterator() = default;
+
+			btree_iterator(Leaf* leaf, std::size_t index) noexcept
+				: m_leaf(leaf)
+				, m_index(index) {}
+
+			// Conversion from iterator to const_iterator
+			template <class P, class = std::enable_if_t<std::is_convertible_v<P, Pointer> && !std::is_same_v<P, Pointer>>>
+			btree_iterator(const btree_iterator<Leaf, Value, P>& other) noexcept
+				: m_leaf(other.m_leaf)
+				, m_index(other.m_index) {}
+
+			reference operator*() const noexcept { return m_leaf->values[m_index]; }
+			pointer operator->() const noexcept { return m_leaf->values.data() + m_index; }
+
+			btree_iterator& operator++() noexcept {
+				if (++m_index == m_leaf->values.size() && m_leaf->next) {
+					m_leaf = m_leaf->next;
+					m_index = 0;
+				}
+				return *this;
+			}
+
+			btree_iterator operator++(int) noexcept {
+				auto copy = *this;
+				++*this;
+				return copy;
+			}
+
+			btree_iterator& operator--() noexcept {
+				if (m_index == 0) {
+					m_leaf = m_leaf->prev;
+					m_index = m_leaf->values.size();
+				}
+				--m_index;
+				return *this;
+			}
+
+			btree_iterator operator--(int) noexcept {
+				auto copy = *this;
+				--*this;
+				return copy;
+			}
+
+			template <class P>
+			bool operator==(const btree_iterator<Leaf, Value, P>& other) const noexcept {
+				return m_leaf == other.m_leaf && m_index == other.m_index;
+			}
+
+			template <class P>
+			bool operator!=(const btree_iterator<Leaf, Value, P>& other) const noexcept {
+				return !(*this == other);
+			}
+
+		private:
+			Leaf* m_leaf = nullptr;
+			std::size_t m_index = 0;
+		};
+
+		// A B+-tree of unique keys. The elements live in leaves that are small flat sorted
+		// arrays of about a kilobyte, chained in key order and searched with the same
+		// routines as flat_tree. Inner nodes hold a cache line of separator keys, so every
+		// level of a descent reads one line of keys before following a child pointer.
+		//
+		// Insertions split full leaves in half, except that appending past the last element
+		// starts a new leaf, which keeps ascending inserts from leaving half empty leaves.
+		// Erasures merge a leaf that drops under a quarter full into a neighbour under the
+		// same parent when the two fit in three quarters of a leaf, and free empty leaves.
+		// Iterators and references are invalidated by every insertion and erasure.
+		template <
+			class Value,
+			class Compare,
+			class Allocator,
+			class ExtractKey,
+			class SearchPolicy
+		> class btree {
+		public:
+
+			using key_type      = typename ExtractKey::type;
+			using value_type    = Value;
+			using key_compare   = Compare;
+			using value_compare = FTValueCompare<Value, Compare, ExtractKey>;
+			using key_extract   = ExtractKey;
+			using size_type     = std::size_t;
+			using search_policy = SearchPolicy;
+
+			static constexpr size_type leaf_slots = std::max<size_type>(8, 1024 / sizeof(Value));
+			static constexpr size_type inner_slots = std::max<size_type>(4, cache_line_size / sizeof(key_type));
+
+		private:
+
+			using leaf_storage = small_vector<Value, leaf_slots, Allocator>;
+			using key_storage  = small_vector<key_type, inner_slots>;
+
+			struct node {};
+
+			struct inner : node {
+				key_storage keys; // keys[i] is a lower bound of the keys under children[i + 1]
+				std::array<node*, inner_slots + 1> children;
+			};
+
+			struct leaf : node {
+				explicit leaf(const Allocator& alloc)
+					: values(alloc) {}
+				leaf_storage values;
+				leaf* prev = nullptr;
+				leaf* next = nullptr;
+			};
+
+			using alloc_traits = std::allocator_traits<Allocator>;
+			using leaf_allocator = typename alloc_traits::template rebind_alloc<leaf>;
+			using inner_allocator = typename alloc_traits::template rebind_alloc<inner>;
+
+			using leaf_search  = container_search<leaf_storage, Compare, ExtractKey, SearchPolicy>;
+			using inner_search = container_search<key_storage, Compare, identity<key_type>, SearchPolicy>;
+
+			// Deep enough for any tree that fits in memory
+			static constexpr size_type max_height = 48;
+
+			struct path_entry {
+				inner* parent;
+				size_type child;
+			};
+
+			using path_type = std::array<path_entry, max_height>;
+
+		public:
+
+			using difference_type        = std::ptrdiff_t;
+			using allocator_type         = Allocator;
+			using reference              = Value&;
+			using const_reference        = const Value&;
+			using pointer                = Value*;
+			using const_pointer          = const Value*;
+			using iterator               = btree_iterator<leaf, Value, Value*>;
+			using const_iterator         = btree_iterator<leaf, Value, const Value*>;
+			using reverse_iterator       = std::reverse_iterator<iterator>;
+			using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                  CONSTRUCTORS                                  //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			btree()
+				: btree(Compare(), allocator_type()) {}
+
+			explicit btree(const Compare& comp, const allocator_type& alloc = allocator_type())
+				: m_alloc(alloc)
+				, m_kcmp(comp)
+				, m_vcmp(comp)
+				, m_kext() {}
+
+			explicit btree(const allocator_type& alloc)
+				: btree(Compare(), alloc) {}
+
+			template <class InIt>
+			btree(InIt first, InIt last,
+				const Compare& comp = Compare(),
+				const allocator_type& alloc = allocator_type())
+				: btree(comp, alloc)
+			{
+				insert(first, last);
+			}
+
+			template <class InIt>
+			btree(sorted_unique_t tag, InIt first, InIt last,
+				const Compare& comp = Compare(),
+				const allocator_type& alloc = allocator_type())
+				: btree(comp, alloc)
+			{
+				insert(tag, first, last);
+			}
+
+			btree(std::initializer_list<value_type> list,
+				const Compare& comp = Compare(),
+				const allocator_type& alloc = allocator_type())
+				: btree(list.begin(), list.end(), comp, alloc) {}
+
+			btree(const btree& other)
+				: btree(other.m_kcmp, alloc_traits::select_on_container_copy_construction(other.m_alloc))
+			{
+				bulk_load(std::vector<value_type>(other.begin(), other.end()));
+			}
+
+			btree(btree&& other) noexcept
+				: m_alloc(std::move(other.m_alloc))
+				, m_kcmp(std::move(other.m_kcmp))
+				, m_vcmp(std::move(other.m_vcmp))
+				, m_kext(std::move(other.m_kext))
+			{
+				steal(other);
+			}
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                   DESTRUCTOR                                   //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			~btree() { clear(); }
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                   ASSIGNMENT                                   //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			btree& operator=(const btree& other) {
+				if (this != &other) {
+					clear();
+					m_kcmp = other.m_kcmp;
+					m_vcmp = other.m_vcmp;
+					bulk_load(std::vector<value_type>(other.begin(), other.end()));
+				}
+				return *this;
+			}
+
+			btree& operator=(btree&& other) noexcept {
+				if (this != &other) {
+					clear();
+					m_alloc = std::move(other.m_alloc);
+					m_kcmp = std::move(other.m_kcmp);
+					m_vcmp = std::move(other.m_vcmp);
+					steal(other);
+				}
+				return *this;
+			}
+
+			btree& operator=(std::initializer_list<value_type> list) {
+				clear();
+				insert(list);
+				return *this;
+			}
+
+			allocator_type get_allocator() const noexcept { return m_alloc; }
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                    ITERATORS                                   //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			iterator begin() noexcept { return iterator(m_first, 0); }
+			const_iterator begin() const noexcept { return const_iterator(m_first, 0); }
+			const_iterator cbegin() const noexcept { return begin(); }
+
+			iterator end() noexcept { return iterator(m_last, m_last ? m_last->values.size() : 0); }
+			const_iterator end() const noexcept { return const_iterator(m_last, m_last ? m_last->values.size() : 0); }
+			const_iterator cend() const noexcept { return end(); }
+
+			reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+			const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+			const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+			reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+			const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+			const_reverse_iterator crend() const noexcept { return rend(); }
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                    CAPACITY                                    //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			bool empty() const noexcept { return m_size == 0; }
+			size_type size() const noexcept { return m_size; }
+			size_type max_size() const noexcept { return std::numeric_limits<difference_type>::max() / sizeof(value_type); }
+
+			// Number of inner levels above the leaves
+			size_type height() const noexcept { return m_height; }
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                    MODIFIERS                                   //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			void clear() noexcept {
+				if (m_root)
+					destroy(m_root, m_height);
+				m_root = nullptr;
+				m_first = m_last = nullptr;
+				m_size = 0;
+				m_height = 0;
+			}
+
+			std::pair<iterator, bool> insert(const value_type& x) {
+				return emplace_key(m_kext(x), [&]() -> const value_type& { return x; });
+			}
+
+			std::pair<iterator, bool> insert(value_type&& x) {
+				return emplace_key(m_kext(x), [&]() -> value_type&& { return std::move(x); });
+			}
+
+			// An empty tree is bulk loaded from the sorted elements; otherwise they are inserted one by one
+			template <class InIt>
+			void insert(InIt first, InIt last) {
+				if (!empty()) {
+					for (; first != last; ++first)
+						insert(*first);
+					return;
+				}
+				std::vector<value_type> values(first, last);
+				std::stable_sort(values.begin(), values.end(), m_vcmp);
+				values.erase(std::unique(values.begin(), values.end(), [&](const value_type& lhs, const value_type& rhs) {
+					return !m_vcmp(lhs, rhs);
+				}), values.end());
+				bulk_load(std::move(values));
+			}
+
+			template <class InIt>
+			void insert(sorted_unique_t, InIt first, InIt last) {
+				if (!empty()) {
+					insert(first, last);
+					return;
+				}
+				std::vector<value_type> values(first, last);
+				assert(std::is_sorted(values.begin(), values.end(), m_vcmp) && "Range is not sorted!");
+				bulk_load(std::move(values));
+			}
+
+			void insert(std::initializer_list<value_type> list) {
+				insert(list.begin(), list.end());
+			}
+
+			template <class... Args>
+			std::pair<iterator, bool> emplace(Args&&... args) {
+				return insert(value_type(std::forward<Args>(args)...));
+			}
+
+			iterator erase(const_iterator pos) {
+				assert(pos != cend() && "Iterator out of range!");
+				path_type path;
+				leaf* l = descend(m_kext(*pos), path);
+				assert(l == pos.m_leaf && "Iterator out of range!");
+				return erase_at(path, l, pos.m_index);
+			}
+
+			iterator erase(const_iterator first, const_iterator last) {
+				auto count = std::distance(first, last);
+				iterator it(first.m_leaf, first.m_index);
+				for (; count > 0; --count)
+					it = erase(it);
+				return it;
+			}
+
+			size_type erase(const key_type& key) {
+				if (empty())
+					return 0;
+				path_type path;
+				leaf* l = descend(key, path);
+				size_type i = lower_index(l, key);
+				if (i == l->values.size() || m_kcmp(key, m_kext(l->values[i])))
+					return 0;
+				erase_at(path, l, i);
+				return 1;
+			}
+
+			void swap(btree& other) noexcept {
+				using std::swap;
+				swap(m_alloc, other.m_alloc);
+				swap(m_root, other.m_root);
+				swap(m_first, other.m_first);
+				swap(m_last, other.m_last);
+				swap(m_size, other.m_size);
+				swap(m_height, other.m_height);
+				swap(m_kcmp, other.m_kcmp);
+				swap(m_vcmp, other.m_vcmp);
+				swap(m_kext, other.m_kext);
+			}
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                     LOOKUP                                     //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			size_type count(const key_type& key) const { return contains(key); }
+
+			iterator find(const key_type& key) {
+				auto it = lower_bound(key);
+				return it != end() && !m_kcmp(key, m_kext(*it)) ? it : end();
+			}
+
+			const_iterator find(const key_type& key) const {
+				auto it = lower_bound(key);
+				return it != end() && !m_kcmp(key, m_kext(*it)) ? it : end();
+			}
+
+			bool contains(const key_type& key) const { return find(key) != end(); }
+
+			std::pair<iterator, iterator> equal_range(const key_type& key) {
+				auto it = lower_bound(key);
+				if (it == end() || m_kcmp(key, m_kext(*it)))
+					return { it, it };
+				return { it, std::next(it) };
+			}
+
+			std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+				auto it = lower_bound(key);
+				if (it == end() || m_kcmp(key, m_kext(*it)))
+					return { it, it };
+				return { it, std::next(it) };
+			}
+
+			iterator lower_bound(const key_type& key) {
+				if (empty())
+					return end();
+				leaf* l = descend(key);
+				return make_iterator(l, lower_index(l, key));
+			}
+
+			const_iterator lower_bound(const key_type& key) const {
+				return const_cast<btree*>(this)->lower_bound(key);
+			}
+
+			iterator upper_bound(const key_type& key) {
+				if (empty())
+					return end();
+				leaf* l = descend(key);
+				const auto& values = l->values;
+				return make_iterator(l, leaf_search::upper_bound(values, values.begin(), values.end(), key, m_kcmp, m_kext) - values.begin());
+			}
+
+			const_iterator upper_bound(const key_type& key) const {
+				return const_cast<btree*>(this)->upper_bound(key);
+			}
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                    OBSERVERS                                   //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			key_compare key_comp() const { return m_kcmp; }
+			value_compare value_comp() const { return m_vcmp; }
+
+		protected:
+
+			// Descends once for key and, only if it is absent, inserts the value returned by make()
+			template <class F>
+			std::pair<iterator, bool> emplace_key(const key_type& key, F make) {
+				if (empty()) {
+					m_root = m_first = m_last = new_leaf();
+					m_first->values.emplace_back(make());
+					m_size = 1;
+					return { begin(), true };
+				}
+				path_type path;
+				leaf* l = descend(key, path);
+				size_type i = lower_index(l, key);
+				if (i != l->values.size() && !m_kcmp(key, m_kext(l->values[i])))
+					return { make_iterator(l, i), false };
+				++m_size;
+				if (l->values.size() < leaf_slots) {
+					l->values.emplace(l->values.begin() + i, make());
+					return { iterator(l, i), true };
+				}
+				return { split_leaf(path, l, i, make()), true };
+			}
+
+		private:
+
+			leaf* new_leaf() {
+				leaf_allocator alloc(m_alloc);
+				leaf* l = std::allocator_traits<leaf_allocator>::allocate(alloc, 1);
+				::new (static_cast<void*>(l)) leaf(m_alloc);
+				return l;
+			}
+
+			inner* new_inner() {
+				inner_allocator alloc(m_alloc);
+				inner* n = std::allocator_traits<inner_allocator>::allocate(alloc, 1);
+				::new (static_cast<void*>(n)) inner();
+				return n;
+			}
+
+			void free_leaf(leaf* l) noexcept {
+				leaf_allocator alloc(m_alloc);
+				l->~leaf();
+				std::allocator_traits<leaf_allocator>::deallocate(alloc, l, 1);
+			}
+
+			void free_inner(inner* n) noexcept {
+				inner_allocator alloc(m_alloc);
+				n->~inner();
+				std::allocator_traits<inner_allocator>::deallocate(alloc, n, 1);
+			}
+
+			// Frees the subtree whose root sits `levels` inner levels above the leaves
+			void destroy(node* n, size_type levels) noexcept {
+				if (levels == 0) {
+					free_leaf(static_cast<leaf*>(n));
+					return;
+				}
+				inner* in = static_cast<inner*>(n);
+				for (size_type c = 0; c <= in->keys.size(); ++c)
+					destroy(in->children[c], levels - 1);
+				free_inner(in);
+			}
+
+			void steal(btree& other) noexcept {
+				m_root = std::exchange(other.m_root, nullptr);
+				m_first = std::exchange(other.m_first, nullptr);
+				m_last = std::exchange(other.m_last, nullptr);
+				m_size = std::exchange(other.m_size, 0);
+				m_height = std::exchange(other.m_height, 0);
+			}
+
+			// Past-the-end positions of a leaf other than the last map to the next leaf
+			iterator make_iterator(leaf* l, size_type i) const noexcept {
+				if (i == l->values.size() && l->next)
+					return iterator(l->next, 0);
+				return iterator(l, i);
+			}
+
+			size_type lower_index(const leaf* l, const key_type& key) const {
+				const auto& values = l->values;
+				return leaf_search::lower_bound(values, values.begin(), values.end(), key, m_kcmp, m_kext) - values.begin();
+			}
+
+			size_type child_index(const inner* n, const key_type& key) const {
+				const auto& keys = n->keys;
+				return inner_search::upper_bound(keys, keys.begin(), keys.end(), key, m_kcmp, identity<key_type>()) - keys.begin();
+			}
+
+			leaf* descend(const key_type& key) const {
+				node* n = m_root;
+				for (size_type level = m_height; level > 0; --level) {
+					inner* in = static_cast<inner*>(n);
+					n = in->children[child_index(in, key)];
+					prefetch(n);
+				}
+				return static_cast<leaf*>(n);
+			}
+
+			// Same as descend(key), recording the inner node and child index of every level
+			leaf* descend(const key_type& key, path_type& path) const {
+				node* n = m_root;
+				for (size_type depth = 0; depth < m_height; ++depth) {
+					inner* in = static_cast<inner*>(n);
+					size_type c = child_index(in, key);
+					path[depth] = { in, c };
+					n = in->children[c];
+				}
+				return static_cast<leaf*>(n);
+			}
+
+			template <class V>
+			iterator split_leaf(path_type& path, leaf* l, size_type i, V&& value) {
+				leaf* right = new_leaf();
+				iterator result;
+				if (i == l->values.size() && !l->next) {
+					right->values.emplace_back(std::forward<V>(value));
+					result = iterator(right, 0);
+				}
+				else {
+					const size_type half = l->values.size() / 2;
+					right->values.insert(right->values.end(),
+						std::make_move_iterator(l->values.begin() + half), std::make_move_iterator(l->values.end()));
+					l->values.erase(l->values.begin() + half, l->values.end());
+					if (i < half) {
+						l->values.emplace(l->values.begin() + i, std::forward<V>(value));
+						result = iterator(l, i);
+					}
+					else {
+						right->values.emplace(right->values.begin() + (i - half), std::forward<V>(value));
+						result = iterator(right, i - half);
+					}
+				}
+				right->prev = l;
+				right->next = l->next;
+				if (l->next)
+					l->next->prev = right;
+				else
+					m_last = right;
+				l->next = right;
+				insert_child(path, m_height, m_kext(right->values.front()), right);
+				return result;
+			}
+
+			// Adds child, whose least key is key, right after the node reached at the given
+			// depth of path, splitting full inner nodes on the way up
+			void insert_child(path_type& path, size_type depth, key_type key, node* child) {
+				while (depth > 0) {
+					auto [parent, c] = path[--depth];
+					auto& keys = parent->keys;
+					auto& children = parent->children;
+					if (keys.size() < inner_slots) {
+						std::move_backward(children.begin() + c + 1, children.begin() + keys.size() + 1, children.begin() + keys.size() + 2);
+						children[c + 1] = child;
+						keys.insert(keys.begin() + c, std::move(key));
+						return;
+					}
+					// Split the inner_slots + 1 keys around the middle one, which moves up
+					small_vector<key_type, inner_slots + 1> all_keys(std::make_move_iterator(keys.begin()), std::make_move_iterator(keys.end()));
+					std::array<node*, inner_slots + 2> all_children;
+					std::copy(children.begin(), children.begin() + c + 1, all_children.begin());
+					all_children[c + 1] = child;
+					std::copy(children.begin() + c + 1, children.end(), all_children.begin() + c + 2);
+					all_keys.insert(all_keys.begin() + c, std::move(key));
+
+					const size_type half = (inner_slots + 1) / 2;
+					inner* right = new_inner();
+					keys.assign(std::make_move_iterator(all_keys.begin()), std::make_move_iterator(all_keys.begin() + half));
+					std::copy(all_children.begin(), all_children.begin() + half + 1, children.begin());
+					right->keys.assign(std::make_move_iterator(all_keys.begin() + half + 1), std::make_move_iterator(all_keys.end()));
+					std::copy(all_children.begin() + half + 1, all_children.end(), right->children.begin());
+					key = std::move(all_keys[half]);
+					child = right;
+				}
+				inner* root = new_inner();
+				root->keys.push_back(std::move(key));
+				root->children[0] = m_root;
+				root->children[1] = child;
+				m_root = root;
+				++m_height;
+			}
+
+			iterator erase_at(path_type& path, leaf* l, size_type i) {
+				l->values.erase(l->values.begin() + i);
+				--m_size;
+				if (l->values.empty()) {
+					leaf* next = l->next;
+					unlink(path, l);
+					return next ? iterator(next, 0) : end();
+				}
+				if (m_height == 0 || l->values.size() >= leaf_slots / 4)
+					return make_iterator(l, i);
+				auto [parent, c] = path[m_height - 1];
+				const size_type merged_limit = leaf_slots * 3 / 4;
+				if (c < parent->keys.size()) {
+					leaf* right = static_cast<leaf*>(parent->children[c + 1]);
+					if (l->values.size() + right->values.size() <= merged_limit) {
+						absorb(l, right);
+						path[m_height - 1].child = c + 1;
+						unlink(path, right);
+						return make_iterator(l, i);
+					}
+				}
+				if (c > 0) {
+					leaf* left = static_cast<leaf*>(parent->children[c - 1]);
+					if (left->values.size() + l->values.size() <= merged_limit) {
+						size_type offset = left->values.size();
+						absorb(left, l);
+						unlink(path, l);
+						return make_iterator(left, offset + i);
+					}
+				}
+				return make_iterator(l, i);
+			}
+
+			// Moves the elements of the next leaf onto the end of l
+			void absorb(leaf* l, leaf* next) {
+				l->values.insert(l->values.end(),
+					std::make_move_iterator(next->values.begin()), std::make_move_iterator(next->values.end()));
+				next->values.clear();
+			}
+
+			// Removes the leaf at the end of path from the chain and from the tree
+			void unlink(path_type& path, leaf* l) {
+				if (l->prev)
+					l->prev->next = l->next;
+				else
+					m_first = l->next;
+				if (l->next)
+					l->next->prev = l->prev;
+				else
+					m_last = l->prev;
+				free_leaf(l);
+				if (m_height == 0) {
+					m_root = nullptr;
+					return;
+				}
+				remove_child(path, m_height - 1);
+			}
+
+			// Removes the child at path[depth] from its parent, removing parents left without children
+			void remove_child(path_type& path, size_type depth) {
+				for (;;) {
+					auto [parent, c] = path[depth];
+					auto& keys = parent->keys;
+					auto& children = parent->children;
+					if (!keys.empty()) {
+						std::move(children.begin() + c + 1, children.begin() + keys.size() + 1, children.begin() + c);
+						keys.erase(keys.begin() + (c > 0 ? c - 1 : 0));
+						break;
+					}
+					free_inner(parent);
+					if (depth == 0) {
+						m_root = nullptr;
+						m_height = 0;
+						return;
+					}
+					--depth;
+				}
+				// A root with a single child is redundant
+				while (m_height > 0 && static_cast<inner*>(m_root)->keys.empty()) {
+					inner* root = static_cast<inner*>(m_root);
+					m_root = root->children[0];
+					free_inner(root);
+					--m_height;
+				}
+			}
+
+			// Replaces the contents with sorted, unique values, filling leaves and inner nodes
+			// to three quarters so that the next inserts do not split every node
+			void bulk_load(std::vector<value_type>&& values) {
+				clear();
+				if (values.empty())
+					return;
+				const size_type leaf_fill = std::max<size_type>(1, leaf_slots * 3 / 4);
+				std::vector<node*> level;
+				std::vector<key_type> lows;
+				for (size_type first = 0; first < values.size(); first += leaf_fill) {
+					leaf* l = new_leaf();
+					auto last = values.begin() + std::min(values.size(), first + leaf_fill);
+					l->values.insert(l->values.end(), std::make_move_iterator(values.begin() + first), std::make_move_iterator(last));
+					l->prev = m_last;
+					if (m_last)
+						m_last->next = l;
+					else
+						m_first = l;
+					m_last = l;
+					level.push_back(l);
+					lows.push_back(m_kext(l->values.front()));
+				}
+				m_size = values.size();
+				const size_type fanout = std::max<size_type>(2, (inner_slots + 1) * 3 / 4);
+				while (level.size() > 1) {
+					std::vector<node*> parents;
+					std::vector<key_type> parent_lows;
+					for (size_type first = 0; first < level.size(); first += fanout) {
+						size_type last = std::min(level.size(), first + fanout);
+						// Avoid leaving a single child for the last node
+						if (level.size() - last == 1)
+							--last;
+						inner* n = new_inner();
+						n->children[0] = level[first];
+						for (size_type c = first + 1; c < last; ++c) {
+							n->keys.push_back(lows[c]);
+							n->children[c - first] = level[c];
+						}
+						parents.push_back(n);
+						parent_lows.push_back(lows[first]);
+						first = last - fanout;
+					}
+					level = std::move(parents);
+					lows = std::move(parent_lows);
+					++m_height;
+				}
+				m_root = level.front();
+			}
+
+			allocator_type m_alloc;
+			node*          m_root = nullptr;  // Leaf if m_height is zero, inner node otherwise
+			leaf*          m_first = nullptr; // Leftmost leaf
+			leaf*          m_last = nullptr;  // Rightmost leaf
+			size_type      m_size = 0;
+			size_type      m_height = 0;      // Number of inner levels
+			key_compare    m_kcmp;            // Key comparison
+			value_compare  m_vcmp;            // Value comparison
+			key_extract    m_kext;            // Key extraction
+
+		};
+
+		template <class Val, class Comp, class Alloc, class ExtKey, class Search>
+		bool operator==(
+			const btree<Val, Comp, Alloc, ExtKey, Search>& lhs,
+			const btree<Val, Comp, Alloc, ExtKey, Search>& rhs)
+		{
+			return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+		}
+
+		template <class Val, class Comp, class Alloc, class ExtKey, class Search>
+		bool operator!=(
+			const btree<Val, Comp, Alloc, ExtKey, Search>& lhs,
+			const btree<Val, Comp, Alloc, ExtKey, Search>& rhs)
+		{
+			return !(lhs == rhs);
+		}
+
+	}
+}
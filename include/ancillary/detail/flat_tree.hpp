@@ -3,8 +3,22 @@
 #include <vector>
 #include <cassert>
 #include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include "gallop.hpp"
+#include "sequence.hpp"
+#include "batch_search.hpp"
+#include "search_policy.hpp"
+#include "../algorithm/parallel_sort.hpp"
 
 namespace ancillary {
+
+	struct sorted_unique_t { explicit sorted_unique_t() = default; };
+	inline constexpr sorted_unique_t sorted_unique{};
+
+	struct sorted_equivalent_t { explicit sorted_equivalent_t() = default; };
+	inline constexpr sorted_equivalent_t sorted_equivalent{};
+
 	namespace detail {
 
 		template <
@@ -66,20 +80,24 @@ namespace ancillary {
 			class Compare,
 			class Allocator,
 			class ExtractKey,
-			bool isMulti
+			bool isMulti,
+			class SearchPolicy = binary_search_policy,
+			class Container = std::vector<Value, Allocator>
 		> class flat_tree {
+			static_assert(std::is_same_v<typename Container::value_type, Value>, "The container must hold the tree's value_type!");
 		public:
 
-			using container_type         = std::vector<Value, Allocator>;
+			using container_type         = Container;
 			using key_type               = typename ExtractKey::type;
 			using value_type             = typename container_type::value_type;
 			using key_compare            = Compare;
 			using value_compare          = FTValueCompare<Value, Compare, ExtractKey>;
 			using key_equal              = FTCompareEqual<key_type, Compare>;
 			using key_extract            = ExtractKey;
+			using search_policy          = SearchPolicy;
 			using size_type              = typename container_type::size_type;
 			using difference_type        = typename container_type::difference_type;
-			using allocator_type         = typename container_type::allocator_type;
+			using allocator_type         = sequence_allocator_t<container_type, Allocator>;
 			using reference              = typename container_type::reference;
 			using const_reference        = typename container_type::const_reference;
 			using pointer                = typename container_type::pointer;
@@ -96,27 +114,34 @@ namespace ancillary {
 											std::pair<iterator, bool>
 										>;
 
+			using sorted_tag = std::conditional_t
+								<
+									isMulti,
+									sorted_equivalent_t,
+									sorted_unique_t
+								>;
+
 			////////////////////////////////////////////////////////////////////////////////////
 			//                                  CONSTRUCTORS                                  //
 			////////////////////////////////////////////////////////////////////////////////////
 
 			flat_tree()
-				: flat_tree(Compare(), Allocator()) {}
+				: flat_tree(Compare(), allocator_type()) {}
 
-			explicit flat_tree(const Compare& comp, const Allocator& alloc = Allocator())
-				: m_data(alloc)
+			explicit flat_tree(const Compare& comp, const allocator_type& alloc = allocator_type())
+				: m_data(make_sequence<container_type>(alloc))
 				, m_kcmp(comp)
 				, m_vcmp(comp)
 				, m_keq(comp)
 				, m_kext() {}
 
-			explicit flat_tree(const Allocator& alloc)
+			explicit flat_tree(const allocator_type& alloc)
 				: flat_tree(Compare(), alloc) {}
 
 			template <class InIt>
 			flat_tree(InIt first, InIt last,
 				const Compare& comp = Compare(),
-				const Allocator& alloc = Allocator())
+				const allocator_type& alloc = allocator_type())
 				: flat_tree(comp, alloc)
 			{
 				insert(first, last);
@@ -124,20 +149,49 @@ namespace ancillary {
 
 			template <class InIt>
 			flat_tree(InIt first, InIt last,
-				const Allocator& alloc)
-				: flat_tree(first, last, Compare, alloc) {}
+				const allocator_type& alloc)
+				: flat_tree(first, last, Compare(), alloc) {}
+
+			template <class InIt>
+			flat_tree(const execution::parallel_policy& policy, InIt first, InIt last,
+				const Compare& comp = Compare(),
+				const allocator_type& alloc = allocator_type())
+				: flat_tree(comp, alloc)
+			{
+				insert(policy, first, last);
+			}
+
+			template <class InIt>
+			flat_tree(const execution::parallel_policy& policy, InIt first, InIt last,
+				const allocator_type& alloc)
+				: flat_tree(policy, first, last, Compare(), alloc) {}
+
+			template <class InIt>
+			flat_tree(sorted_tag, InIt first, InIt last,
+				const Compare& comp = Compare(),
+				const allocator_type& alloc = allocator_type())
+				: flat_tree(comp, alloc)
+			{
+				m_data.assign(first, last);
+				assert(is_ordered(begin(), end()) && "Range is not sorted!");
+			}
+
+			template <class InIt>
+			flat_tree(sorted_tag tag, InIt first, InIt last,
+				const allocator_type& alloc)
+				: flat_tree(tag, first, last, Compare(), alloc) {}
 
 			flat_tree(const flat_tree&) = default;
-			flat_tree(const flat_tree& other, const Allocator& alloc)
-				: m_data(other.m_data, alloc)
+			flat_tree(const flat_tree& other, const allocator_type& alloc)
+				: m_data(make_sequence<container_type>(alloc, other.m_data))
 				, m_kcmp(other.m_kcmp)
 				, m_vcmp(other.m_vcmp)
 				, m_keq(other.m_keq)
 				, m_kext(other.m_kext) {}
 
 			flat_tree(flat_tree&&) = default;
-			flat_tree(flat_tree&& other, const Allocator& alloc)
-				: m_data(std::move(other.m_data), alloc)
+			flat_tree(flat_tree&& other, const allocator_type& alloc)
+				: m_data(make_sequence<container_type>(alloc, std::move(other.m_data)))
 				, m_kcmp(std::move(other.m_kcmp))
 				, m_vcmp(std::move(other.m_vcmp))
 				, m_keq(std::move(other.m_keq))
@@ -145,13 +199,22 @@ namespace ancillary {
 
 			flat_tree(std::initializer_list<value_type> list,
 				const Compare& comp = Compare(),
-				const Allocator& alloc = Allocator())
+				const allocator_type& alloc = allocator_type())
 				: flat_tree(list.begin(), list.end(), comp, alloc) {}
 
 			flat_tree(std::initializer_list<value_type> list,
-				const Allocator& alloc)
+				const allocator_type& alloc)
 				: flat_tree(list.begin(), list.end(), Compare(), alloc) {}
 
+			flat_tree(sorted_tag tag, std::initializer_list<value_type> list,
+				const Compare& comp = Compare(),
+				const allocator_type& alloc = allocator_type())
+				: flat_tree(tag, list.begin(), list.end(), comp, alloc) {}
+
+			flat_tree(sorted_tag tag, std::initializer_list<value_type> list,
+				const allocator_type& alloc)
+				: flat_tree(tag, list.begin(), list.end(), Compare(), alloc) {}
+
 			////////////////////////////////////////////////////////////////////////////////////
 			//                                   DESTRUCTOR                                   //
 			////////////////////////////////////////////////////////////////////////////////////
@@ -170,7 +233,7 @@ namespace ancillary {
 				return *this;
 			}
 
-			allocator_type get_allocator() const noexcept { return m_data.get_allocator(); }
+			allocator_type get_allocator() const noexcept { return sequence_get_allocator<allocator_type>(m_data); }
 
 			////////////////////////////////////////////////////////////////////////////////////
 			//                                    ITERATORS                                   //
@@ -199,9 +262,9 @@ namespace ancillary {
 			bool empty() const noexcept { return m_data.empty(); }
 			size_type size() const noexcept { return m_data.size(); }
 			size_type max_size() const noexcept { return m_data.max_size(); }
-			size_type capacity() const noexcept { return m_data.capacity(); }
-			void reserve(size_type new_cap) { m_data.reserve(new_cap); }
-			void shrink_to_fit() { m_data.shrink_to_fit(); }
+			size_type capacity() const noexcept { return sequence_capacity(m_data); }
+			void reserve(size_type new_cap) { sequence_reserve(m_data, new_cap); }
+			void shrink_to_fit() { sequence_shrink_to_fit(m_data); }
 
 			////////////////////////////////////////////////////////////////////////////////////
 			//                                    MODIFIERS                                   //
@@ -217,14 +280,35 @@ namespace ancillary {
 
 			template <class InIt>
 			void insert(InIt first, InIt last) {
-				for (auto it = first; it != last; ++it)
-					insert(cend(), *it);
+				difference_type prefix = size();
+				m_data.insert(m_data.end(), first, last);
+				merge_tail(begin() + prefix);
 			}
 
 			void insert(std::initializer_list<value_type> list) {
 				insert(list.begin(), list.end());
 			}
 
+			// Same as insert(first, last), but sorts the new elements on several threads
+			template <class InIt>
+			void insert(const execution::parallel_policy& policy, InIt first, InIt last) {
+				difference_type prefix = size();
+				m_data.insert(m_data.end(), first, last);
+				parallel_stable_sort(policy, begin() + prefix, end(), m_vcmp);
+				merge_sorted_tail(begin() + prefix);
+			}
+
+			template <class InIt>
+			void insert(sorted_tag, InIt first, InIt last) {
+				difference_type prefix = size();
+				m_data.insert(m_data.end(), first, last);
+				merge_sorted_tail(begin() + prefix);
+			}
+
+			void insert(sorted_tag tag, std::initializer_list<value_type> list) {
+				insert(tag, list.begin(), list.end());
+			}
+
 			template <class... Args>
 			emplace_ret_type emplace(Args&&... args) {
 				if constexpr (isMulti) {
@@ -251,13 +335,85 @@ namespace ancillary {
 				return m_data.erase(first, last);
 			}
 			size_type erase(const key_type& key) {
-				auto range = equal_range(key);
-				auto count = std::distance(range.first, range.second);
-				if (count > 0)
-					erase(range.first, range.second);
+				if constexpr (isMulti) {
+					auto range = equal_range(key);
+					auto count = std::distance(range.first, range.second);
+					if (count > 0)
+						erase(range.first, range.second);
+					return count;
+				}
+				else {
+					auto it = find(key);
+					if (it == end())
+						return 0;
+					erase(it);
+					return 1;
+				}
+			}
+
+			// Erases every element whose key is in the sorted range [first, last), in a single
+			// pass that gallops over the survivors between two keys and compacts them
+			template <class InIt>
+			size_type erase(sorted_tag, InIt first, InIt last) {
+				auto before = [this](const value_type& value, const auto& key) { return m_kcmp(m_kext(value), key); };
+				iterator out = begin();
+				iterator it = begin();
+				for (; first != last && it != end(); ++first) {
+					iterator lower = detail::gallop_lower_bound(it, end(), *first, before);
+					out = out != it ? std::move(it, lower, out) : lower;
+					it = lower;
+					while (it != end() && !m_kcmp(*first, m_kext(*it)))
+						++it;
+				}
+				out = out != it ? std::move(it, end(), out) : end();
+				size_type count = end() - out;
+				m_data.erase(out, end());
 				return count;
 			}
 
+			container_type extract() && {
+				container_type data = std::move(m_data);
+				m_data.clear();
+				return data;
+			}
+
+			void replace(container_type&& data) {
+				assert(is_ordered(data.begin(), data.end()) && "Container is not sorted!");
+				m_data = std::move(data);
+			}
+
+			// Moves the elements of other into this tree in one linear pass. For unique trees,
+			// elements whose key is already present stay behind in other.
+			void merge(flat_tree& other) {
+				if (this == &other || other.empty())
+					return;
+				auto merged = make_sequence<container_type>(get_allocator());
+				sequence_reserve(merged, size() + other.size());
+				auto append = [&merged](iterator first, iterator last) {
+					merged.insert(merged.end(), std::make_move_iterator(first), std::make_move_iterator(last));
+				};
+				if constexpr (isMulti) {
+					detail::gallop_merge(begin(), end(), other.begin(), other.end(), m_vcmp, append);
+					other.clear();
+				}
+				else {
+					iterator out = other.begin();
+					detail::gallop_set_walk(begin(), end(), other.begin(), other.end(), m_vcmp, append, append,
+						[&](iterator lhs, iterator rhs) {
+							merged.insert(merged.end(), std::move(*lhs));
+							if (out != rhs)
+								*out = std::move(*rhs);
+							++out;
+						});
+					other.m_data.erase(out, other.end());
+				}
+				m_data = std::move(merged);
+			}
+
+			void merge(flat_tree&& other) {
+				merge(other);
+			}
+
 			void swap(flat_tree& other) {
 				if (this != &other) {
 					std::swap(m_kcmp, other.m_kcmp);
@@ -273,14 +429,12 @@ namespace ancillary {
 			////////////////////////////////////////////////////////////////////////////////////
 
 			size_type count(const key_type& key) const {
-				auto range = equal_range(key);
-				return std::distance(range.first, range.second);
+				return count_impl(key);
 			}
 
 			template <class K, class = std::enable_if_t<is_transparent_v<Compare, K>>>
 			size_type count(const K& key) const {
-				auto range = equal_range(key);
-				return std::distance(range.first, range.second);
+				return count_impl(key);
 			}
 
 			iterator find(const key_type& key) {
@@ -314,22 +468,48 @@ namespace ancillary {
 				return find(key) != end();
 			}
 
+			// Writes the result of find for each key in [first, last) to out. Sorted keys are
+			// resolved in one galloping pass, others by searches interleaved in small groups.
+			template <class ForwardIt, class OutIt>
+			OutIt find_many(ForwardIt first, ForwardIt last, OutIt out) {
+				detail::batch_lower_bound(begin(), end(), first, last, m_kcmp, m_kext, [&](const auto& key, iterator lower) {
+					*out++ = lower != end() && m_keq(m_kext(*lower), key) ? lower : end();
+				});
+				return out;
+			}
+
+			template <class ForwardIt, class OutIt>
+			OutIt find_many(ForwardIt first, ForwardIt last, OutIt out) const {
+				detail::batch_lower_bound(begin(), end(), first, last, m_kcmp, m_kext, [&](const auto& key, const_iterator lower) {
+					*out++ = lower != end() && m_keq(m_kext(*lower), key) ? lower : end();
+				});
+				return out;
+			}
+
+			template <class ForwardIt, class OutIt>
+			OutIt contains_many(ForwardIt first, ForwardIt last, OutIt out) const {
+				detail::batch_lower_bound(begin(), end(), first, last, m_kcmp, m_kext, [&](const auto& key, const_iterator lower) {
+					*out++ = lower != end() && m_keq(m_kext(*lower), key);
+				});
+				return out;
+			}
+
 			std::pair<iterator, iterator> equal_range(const key_type& key) {
-				return { lower_bound(key), upper_bound(key) };
+				return equal_range_impl(begin(), end(), key);
 			}
 
 			std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
-				return { lower_bound(key), upper_bound(key) };
+				return equal_range_impl(begin(), end(), key);
 			}
 
 			template <class K, class = std::enable_if_t<is_transparent_v<Compare, K>>>
 			std::pair<iterator, iterator> equal_range(const K& key) {
-				return { lower_bound(key), upper_bound(key) };
+				return equal_range_impl(begin(), end(), key);
 			}
 
 			template <class K, class = std::enable_if_t<is_transparent_v<Compare, K>>>
 			std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
-				return { lower_bound(key), upper_bound(key) };
+				return equal_range_impl(begin(), end(), key);
 			}
 
 			iterator lower_bound(const key_type& key) { 
@@ -375,146 +555,193 @@ namespace ancillary {
 			key_compare key_comp() const { return m_kcmp; }
 			value_compare value_comp() const { return m_vcmp; }
 
+		protected:
+
+			// Returns the lower bound of key, only searching when hint is not already it
+			template <class K>
+			iterator lower_bound_hint(const_iterator hint, const K& key) {
+				assert(iterator_in_range(hint) && "Iterator out of range!");
+				iterator pos = begin() + (hint - cbegin());
+				if (pos != end() && m_kcmp(m_kext(*pos), key))
+					return lower_bound_impl(std::next(pos), end(), key);
+				if (pos != begin() && !m_kcmp(m_kext(*std::prev(pos)), key))
+					return lower_bound_impl(begin(), std::prev(pos), key);
+				return pos;
+			}
+
+			// Constructs an element in place at pos, shifting the elements after it by one
+			template <class... Args>
+			iterator emplace_at(const_iterator pos, Args&&... args) {
+				assert(iterator_in_range(pos) && "Iterator out of range!");
+				return m_data.emplace(pos, std::forward<Args>(args)...);
+			}
+
 		private:
 
 			bool iterator_in_range(const_iterator it) const {
 				return cbegin() <= it && it <= cend();
 			}
 
+			using search_type = detail::container_search<container_type, Compare, ExtractKey, SearchPolicy>;
+
 			template <class RndIt, class Key>
 			RndIt lower_bound_impl(RndIt first, RndIt last, const Key& key) const {
-				typename std::iterator_traits<RndIt>::difference_type len, step;
-				len = last - first;
-				RndIt mid;
-				while (len > 0) {
-					mid = first;
-					step = len / 2;
-					mid += step;
-					if (m_kcmp(m_kext(*mid), key)) {
-						first = ++mid;
-						len -= step + 1;
-					}
-					else
-						len = step;
-				}
-				return first;
+				return search_type::lower_bound(m_data, first, last, key, m_kcmp, m_kext);
 			}
 
 			template <class RndIt, class Key>
 			RndIt upper_bound_impl(RndIt first, RndIt last, const Key& key) const {
-				typename std::iterator_traits<RndIt>::difference_type len, step;
-				len = last - first;
-				RndIt mid;
-				while (len > 0) {
-					mid = first;
-					step = len / 2;
-					mid += step;
-					if (!m_kcmp(key, m_kext(*mid))) {
-						first = ++mid;
-						len -= step + 1;
+				return search_type::upper_bound(m_data, first, last, key, m_kcmp, m_kext);
+			}
+
+			// Both kinds of tree find the lower bound through the search policy. Multi trees
+			// then gallop forwards from it, which finds short runs of duplicates in a few
+			// comparisons and long ones in a logarithmic number.
+			template <class RndIt, class Key>
+			std::pair<RndIt, RndIt> equal_range_impl(RndIt first, RndIt last, const Key& key) const {
+				RndIt lower = lower_bound_impl(first, last, key);
+				if constexpr (isMulti) {
+					auto key_less = [this](const Key& key, const value_type& value) { return m_kcmp(key, m_kext(value)); };
+					return { lower, detail::gallop_upper_bound(lower, last, key, key_less) };
+				}
+				else {
+					return { lower, lower != last && m_keq(m_kext(*lower), key) ? std::next(lower) : lower };
+				}
+			}
+
+			template <class Key>
+			size_type count_impl(const Key& key) const {
+				if constexpr (isMulti) {
+					auto range = equal_range(key);
+					return std::distance(range.first, range.second);
+				}
+				else {
+					return contains(key);
+				}
+			}
+
+			template <class FwdIt>
+			bool is_ordered(FwdIt first, FwdIt last) const {
+				if constexpr (isMulti) {
+					return std::is_sorted(first, last, m_vcmp);
+				}
+				else {
+					return std::adjacent_find(first, last, [this](const value_type& lhs, const value_type& rhs) {
+						return !m_vcmp(lhs, rhs);
+					}) == last;
+				}
+			}
+
+			// Sorts the appended elements in [mid, end()) and merges them into the sorted 
+			// prefix [begin(), mid). Equivalent elements keep their insertion order and, 
+			// for unique trees, only the first occurrence of a key is kept.
+			void merge_tail(iterator mid) {
+				std::stable_sort(mid, end(), m_vcmp);
+				merge_sorted_tail(mid);
+			}
+
+			void merge_sorted_tail(iterator mid) {
+				assert(std::is_sorted(mid, end(), m_vcmp) && "Range is not sorted!");
+				if constexpr (!isMulti) {
+					iterator pos = begin();
+					iterator out = mid;
+					for (auto it = mid; it != end(); ++it) {
+						if (out != mid && m_keq(m_kext(*std::prev(out)), m_kext(*it)))
+							continue;
+						pos = lower_bound_impl(pos, mid, m_kext(*it));
+						if (pos != mid && m_keq(m_kext(*pos), m_kext(*it)))
+							continue;
+						if (out != it)
+							*out = std::move(*it);
+						++out;
 					}
-					else
-						len = step;
+					m_data.erase(out, end());
 				}
-				return first;
+				std::inplace_merge(begin(), mid, end(), m_vcmp);
 			}
 
+			// Emplacing a value_type needs no temporary, since its key can be read directly
+			template <class... Args>
+			static constexpr bool is_value_arg = sizeof...(Args) == 1 &&
+				std::conjunction_v<std::is_same<std::remove_cv_t<std::remove_reference_t<Args>>, value_type>...>;
+
 			template <class... Args>
 			emplace_ret_type emplace_unique(Args&&... args) {
-				m_data.emplace_back(std::forward<Args>(args)...);
-				auto last = std::prev(end());
-				auto lower = lower_bound_impl(begin(), last, m_kext(*last));
-				if (lower == last)
-					return { lower, true };
-				else if (m_keq(m_kext(*lower), m_kext(*last))) {
-					m_data.pop_back();
-					return { lower, false };
+				if constexpr (is_value_arg<Args...>) {
+					return insert_unique(std::forward<Args>(args)...);
 				}
 				else {
-					std::rotate(lower, last, end());
-					return { lower, true };
+					return insert_unique(value_type(std::forward<Args>(args)...));
 				}
 			}
 
+			template <class V>
+			std::pair<iterator, bool> insert_unique(V&& value) {
+				auto lower = lower_bound_impl(begin(), end(), m_kext(value));
+				if (lower != end() && m_keq(m_kext(*lower), m_kext(value)))
+					return { lower, false };
+				return { m_data.insert(lower, std::forward<V>(value)), true };
+			}
+
 			template <class... Args>
 			iterator emplace_hint_unique(const_iterator hint, Args&&... args) {
-				assert(iterator_in_range(hint) && "Iterator out of range!");
-				difference_type step = hint - cbegin();
-				m_data.emplace_back(std::forward<Args>(args)...);
-				iterator pos = begin() + step;
-				iterator last = std::prev(end());
-				if (pos == last || m_vcmp(*last, *pos)) {
-					if (pos == begin() || m_vcmp(*std::prev(pos), *last)) {
-						std::rotate(pos, last, end());
-						return pos;
-					}
-					iterator prev = std::prev(pos);
-					if (m_keq(m_kext(*prev), m_kext(*last))) {
-						m_data.pop_back();
-						return prev;
-					}
-					else {
-						auto lower = lower_bound_impl(begin(), prev, m_kext(*last));
-						if (m_keq(m_kext(*lower), m_kext(*last))) {
-							m_data.pop_back();
-							return lower;
-						}
-						else {
-							std::rotate(lower, last, end());
-							return lower;
-						}
-					}
+				if constexpr (is_value_arg<Args...>) {
+					return insert_hint_unique(hint, std::forward<Args>(args)...);
 				}
 				else {
-					auto lower = lower_bound_impl(pos, last, m_kext(*last));
-					if (lower == last)
-						return lower;
-					else if (m_keq(m_kext(*lower), m_kext(*last))) {
-						m_data.pop_back();
-						return lower;
-					}
-					else {
-						std::rotate(lower, last, end());
-						return lower;
-					}
+					return insert_hint_unique(hint, value_type(std::forward<Args>(args)...));
 				}
 			}
 
+			template <class V>
+			iterator insert_hint_unique(const_iterator hint, V&& value) {
+				auto lower = lower_bound_hint(hint, m_kext(value));
+				if (lower != end() && m_keq(m_kext(*lower), m_kext(value)))
+					return lower;
+				return m_data.insert(lower, std::forward<V>(value));
+			}
+
 			template <class... Args>
 			iterator emplace_multi(Args&&... args) {
-				m_data.emplace_back(std::forward<Args>(args)...);
-				iterator last = std::prev(end());
-				auto upper = upper_bound_impl(begin(), last, m_kext(*last));
-				std::rotate(upper, last, end());
-				return upper;
+				if constexpr (is_value_arg<Args...>) {
+					return insert_multi(std::forward<Args>(args)...);
+				}
+				else {
+					return insert_multi(value_type(std::forward<Args>(args)...));
+				}
+			}
+
+			template <class V>
+			iterator insert_multi(V&& value) {
+				auto upper = upper_bound_impl(begin(), end(), m_kext(value));
+				return m_data.insert(upper, std::forward<V>(value));
 			}
 
 			template <class... Args>
 			iterator emplace_hint_multi(const_iterator hint, Args&&... args) {
+				if constexpr (is_value_arg<Args...>) {
+					return insert_hint_multi(hint, std::forward<Args>(args)...);
+				}
+				else {
+					return insert_hint_multi(hint, value_type(std::forward<Args>(args)...));
+				}
+			}
+
+			// Inserts right before hint when that keeps the order, or else at the upper bound
+			// of the key within the side of hint that the key belongs to
+			template <class V>
+			iterator insert_hint_multi(const_iterator hint, V&& value) {
 				assert(iterator_in_range(hint) && "Iterator out of range!");
-				difference_type step = hint - cbegin();
-				m_data.emplace_back(std::forward<Args>(args)...);
-				iterator pos = begin() + step;
-				iterator last = std::prev(end());
-				if (pos == last || m_vcmp(*last, *pos)) {
-					if (pos == begin() ||
-						m_vcmp(*std::prev(pos), *last) ||
-						m_keq(m_kext(*std::prev(pos)), m_kext(*last)))
-					{
-						std::rotate(pos, last, end());
-						return pos;
-					}
-					else {
-						auto upper = upper_bound_impl(begin(), std::prev(pos), m_kext(*last));
-						std::rotate(upper, last, end());
-						return upper;
-					}
+				iterator pos = begin() + (hint - cbegin());
+				const auto& key = m_kext(value);
+				if (pos == end() || m_kcmp(key, m_kext(*pos))) {
+					if (pos != begin() && m_kcmp(key, m_kext(*std::prev(pos))))
+						pos = upper_bound_impl(begin(), std::prev(pos), key);
 				}
 				else {
-					auto upper = upper_bound_impl(pos, last, m_kext(*last));
-					std::rotate(upper, last, end());
-					return upper;
+					pos = upper_bound_impl(pos, end(), key);
 				}
+				return m_data.insert(pos, std::forward<V>(value));
 			}
 
 			key_compare    m_kcmp; // Key comparison
@@ -525,10 +752,10 @@ namespace ancillary {
 
 		};
 
-		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti>
+		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti, class Search, class Cont>
 		bool operator==(
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& lhs,
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& rhs)
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& lhs,
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& rhs)
 		{
 			auto equal = [comp = Comp(), ext_key = ExtKey()](const auto& lhs, const auto& rhs) {
 				return !comp(ext_key(lhs), ext_key(rhs)) && !comp(ext_key(rhs), ext_key(lhs));
@@ -536,18 +763,18 @@ namespace ancillary {
 			return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), equal);
 		}
 
-		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti>
+		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti, class Search, class Cont>
 		bool operator!=(
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& lhs,
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& rhs)
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& lhs,
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& rhs)
 		{
 			return !(lhs == rhs);
 		}
 
-		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti>
+		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti, class Search, class Cont>
 		bool operator<(
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& lhs,
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& rhs)
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& lhs,
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& rhs)
 		{
 			auto comp = [comp = Comp(), ext_key = ExtKey()](const auto& lhs, const auto& rhs) {
 				return comp(ext_key(lhs), ext_key(rhs));
@@ -555,28 +782,124 @@ namespace ancillary {
 			return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), comp);
 		}
 
-		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti>
+		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti, class Search, class Cont>
 		bool operator<=(
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& lhs,
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& rhs)
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& lhs,
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& rhs)
 		{
 			return !(rhs < lhs);
 		}
 
-		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti>
+		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti, class Search, class Cont>
 		bool operator>(
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& lhs,
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& rhs)
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& lhs,
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& rhs)
 		{
 			return rhs < lhs;
 		}
 
-		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti>
+		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti, class Search, class Cont>
 		bool operator>=(
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& lhs,
-			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti>& rhs)
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& lhs,
+			const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& rhs)
 		{
 			return !(lhs < rhs);
 		}
+
+		template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti, class Search, class Cont>
+		std::true_type is_flat_tree_test(const flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>*);
+		std::false_type is_flat_tree_test(...);
+
+		template <class Lhs, class Rhs>
+		constexpr bool is_flat_tree_pair_v =
+			std::is_same_v<std::decay_t<Lhs>, std::decay_t<Rhs>> &&
+			decltype(is_flat_tree_test(std::declval<std::decay_t<Lhs>*>()))::value;
+
+		template <class Lhs, class Rhs>
+		using enable_flat_tree_pair_t = std::enable_if_t<is_flat_tree_pair_v<Lhs, Rhs>, std::decay_t<Lhs>>;
+
+		// The elements of a set operand, which are moved out of it when it is an rvalue
+		template <class Tree>
+		auto set_operand(Tree&& tree, typename std::decay_t<Tree>::container_type& storage) {
+			if constexpr (std::is_lvalue_reference_v<Tree>) {
+				return std::make_pair(tree.cbegin(), tree.cend());
+			}
+			else {
+				storage = std::move(tree).extract();
+				return std::make_pair(std::make_move_iterator(storage.begin()), std::make_move_iterator(storage.end()));
+			}
+		}
+
+		// Combines two sorted trees into a new one with a single allocation, keeping the
+		// runs found only in lhs, the runs found only in rhs and the lhs element of each
+		// equivalent pair as requested
+		template <bool keepFirst, bool keepSecond, bool keepBoth, class Lhs, class Rhs>
+		std::decay_t<Lhs> set_operation(Lhs&& lhs, Rhs&& rhs, std::size_t capacity) {
+			using tree_type = std::decay_t<Lhs>;
+			using container_type = typename tree_type::container_type;
+			tree_type result(lhs.key_comp(), lhs.get_allocator());
+			auto comp = lhs.value_comp();
+			auto data = make_sequence<container_type>(lhs.get_allocator());
+			sequence_reserve(data, capacity);
+
+			container_type lhs_storage, rhs_storage;
+			auto [first1, last1] = set_operand(std::forward<Lhs>(lhs), lhs_storage);
+			auto [first2, last2] = set_operand(std::forward<Rhs>(rhs), rhs_storage);
+			gallop_set_walk(first1, last1, first2, last2, comp,
+				[&data](auto first, auto last) {
+					if constexpr (keepFirst)
+						data.insert(data.end(), first, last);
+				},
+				[&data](auto first, auto last) {
+					if constexpr (keepSecond)
+						data.insert(data.end(), first, last);
+				},
+				[&data](auto lhs, auto) {
+					if constexpr (keepBoth)
+						data.insert(data.end(), *lhs);
+				});
+			result.replace(std::move(data));
+			return result;
+		}
+	}
+
+	// Erases every element satisfying pred with one compaction pass, returning the count.
+	// Removal runs in place and keeps the survivors in order, so nothing is re-sorted, and
+	// if pred throws the container is left valid rather than emptied.
+	template <class Val, class Comp, class Alloc, class ExtKey, bool isMulti, class Search, class Cont, class Pred>
+	std::size_t erase_if(detail::flat_tree<Val, Comp, Alloc, ExtKey, isMulti, Search, Cont>& c, Pred pred) {
+		auto survivors = std::remove_if(c.begin(), c.end(), pred);
+		std::size_t count = c.end() - survivors;
+		c.erase(survivors, c.end());
+		return count;
+	}
+
+	// Set algebra between two flat containers of the same type. Both operands are sorted,
+	// so each result is built in one pass that gallops over runs belonging to only one
+	// side. Passing an operand as an rvalue moves its elements into the result. For the
+	// multi containers, equivalent elements are paired up as in the std:: algorithms.
+
+	template <class Lhs, class Rhs>
+	detail::enable_flat_tree_pair_t<Lhs, Rhs> set_union(Lhs&& lhs, Rhs&& rhs) {
+		const std::size_t capacity = lhs.size() + rhs.size();
+		return detail::set_operation<true, true, true>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs), capacity);
+	}
+
+	template <class Lhs, class Rhs>
+	detail::enable_flat_tree_pair_t<Lhs, Rhs> set_intersection(Lhs&& lhs, Rhs&& rhs) {
+		const std::size_t capacity = std::min(lhs.size(), rhs.size());
+		return detail::set_operation<false, false, true>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs), capacity);
+	}
+
+	template <class Lhs, class Rhs>
+	detail::enable_flat_tree_pair_t<Lhs, Rhs> set_difference(Lhs&& lhs, Rhs&& rhs) {
+		const std::size_t capacity = lhs.size();
+		return detail::set_operation<true, false, false>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs), capacity);
+	}
+
+	template <class Lhs, class Rhs>
+	detail::enable_flat_tree_pair_t<Lhs, Rhs> set_symmetric_difference(Lhs&& lhs, Rhs&& rhs) {
+		const std::size_t capacity = lhs.size() + rhs.size();
+		return detail::set_operation<true, true, false>(std::forward<Lhs>(lhs), std::forward<Rhs>(rhs), capacity);
 	}
-}
\ No newline at end of file
+}
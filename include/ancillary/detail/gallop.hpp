@@ -0,0 +1,78 @@
+#pragma once
+
+#include <iterator>
+#include <algorithm>
+
+namespace ancillary {
+	namespace detail {
+
+		// Finds the first element of [first, last) that is not less than value by probing
+		// first[1], first[3], first[7], ... and then searching the last stride. Costs
+		// O(log d) comparisons for a result d elements away from first.
+		template <class RndIt, class T, class Compare>
+		RndIt gallop_lower_bound(RndIt first, RndIt last, const T& value, const Compare& comp) {
+			if (first == last || !comp(*first, value))
+				return first;
+			typename std::iterator_traits<RndIt>::difference_type len, step;
+			len = last - first;
+			step = 1;
+			while (step < len && comp(first[step], value))
+				step = 2 * step + 1;
+			return std::lower_bound(first + (step / 2 + 1), first + std::min(step, len), value, comp);
+		}
+
+		template <class RndIt, class T, class Compare>
+		RndIt gallop_upper_bound(RndIt first, RndIt last, const T& value, const Compare& comp) {
+			if (first == last || comp(value, *first))
+				return first;
+			typename std::iterator_traits<RndIt>::difference_type len, step;
+			len = last - first;
+			step = 1;
+			while (step < len && !comp(value, first[step]))
+				step = 2 * step + 1;
+			return std::upper_bound(first + (step / 2 + 1), first + std::min(step, len), value, comp);
+		}
+
+		// Walks two sorted ranges, passing each run of elements found only in the first
+		// range to onlyFirst, each run found only in the second range to onlySecond and
+		// each pair of equivalent elements to both. Runs are skipped over by galloping,
+		// so the walk costs O(m log(n / m)) comparisons when the ranges are skewed.
+		template <class RndIt1, class RndIt2, class Compare, class OnlyFirst, class OnlySecond, class Both>
+		void gallop_set_walk(RndIt1 first1, RndIt1 last1, RndIt2 first2, RndIt2 last2, const Compare& comp,
+			OnlyFirst onlyFirst, OnlySecond onlySecond, Both both)
+		{
+			while (first1 != last1 && first2 != last2) {
+				RndIt1 run1 = gallop_lower_bound(first1, last1, *first2, comp);
+				onlyFirst(first1, run1);
+				if ((first1 = run1) == last1)
+					break;
+				RndIt2 run2 = gallop_lower_bound(first2, last2, *first1, comp);
+				onlySecond(first2, run2);
+				if ((first2 = run2) == last2)
+					break;
+				if (!comp(*first1, *first2))
+					both(first1++, first2++);
+			}
+			onlyFirst(first1, last1);
+			onlySecond(first2, last2);
+		}
+
+		// Stable merge of two sorted ranges that hands whole runs to append, taking
+		// equivalent elements from the first range before those of the second
+		template <class RndIt1, class RndIt2, class Compare, class Append>
+		void gallop_merge(RndIt1 first1, RndIt1 last1, RndIt2 first2, RndIt2 last2, const Compare& comp, Append append) {
+			while (first1 != last1 && first2 != last2) {
+				RndIt1 run1 = gallop_upper_bound(first1, last1, *first2, comp);
+				append(first1, run1);
+				if ((first1 = run1) == last1)
+					break;
+				RndIt2 run2 = gallop_lower_bound(first2, last2, *first1, comp);
+				append(first2, run2);
+				first2 = run2;
+			}
+			append(first1, last1);
+			append(first2, last2);
+		}
+
+	}
+}
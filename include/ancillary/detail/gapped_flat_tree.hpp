@@ -0,0 +1,708 @@
+#pragma once
+
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include "flat_tree.hpp"
+
+namespace ancillary {
+	namespace detail {
+
+		inline unsigned countr_zero64(std::uint64_t x) noexcept {
+			assert(x != 0);
+#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+			unsigned n = 0;
+			for (; !(x & 1); x >>= 1)
+				++n;
+			return n;
+#endif
+		}
+
+		inline unsigned countl_zero64(std::uint64_t x) noexcept {
+			assert(x != 0);
+#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<unsigned>(__builtin_clzll(x));
+#else
+			unsigned n = 0;
+			for (; !(x >> 63); x <<= 1)
+				++n;
+			return n;
+#endif
+		}
+
+		inline unsigned popcount64(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+			unsigned n = 0;
+			for (; x; x &= x - 1)
+				++n;
+			return n;
+#endif
+		}
+
+		// Occupancy bitmap of a gapped array, one bit per slot. Scans skip 64 slots per word.
+		struct slot_bitmap {
+			static constexpr std::size_t word_bits = 64;
+
+			static std::size_t words(std::size_t slots) noexcept {
+				return (slots + word_bits - 1) / word_bits;
+			}
+
+			static bool test(const std::uint64_t* bits, std::size_t i) noexcept {
+				return (bits[i / word_bits] >> (i % word_bits)) & 1;
+			}
+
+			static void set(std::uint64_t* bits, std::size_t i) noexcept {
+				bits[i / word_bits] |= std::uint64_t(1) << (i % word_bits);
+			}
+
+			static void reset(std::uint64_t* bits, std::size_t i) noexcept {
+				bits[i / word_bits] &= ~(std::uint64_t(1) << (i % word_bits));
+			}
+
+			// Returns the first set slot in [first, last), or last
+			static std::size_t next(const std::uint64_t* bits, std::size_t first, std::size_t last) noexcept {
+				if (first >= last)
+					return last;
+				std::size_t w = first / word_bits;
+				std::uint64_t word = bits[w] & (~std::uint64_t(0) << (first % word_bits));
+				while (word == 0) {
+					if (++w * word_bits >= last)
+						return last;
+					word = bits[w];
+				}
+				return std::min(last, w * word_bits + countr_zero64(word));
+			}
+
+			// Returns the last set slot in [first, last), or last
+			static std::size_t prev(const std::uint64_t* bits, std::size_t first, std::size_t last) noexcept {
+				if (first >= last)
+					return last;
+				std::size_t w = (last - 1) / word_bits;
+				std::uint64_t word = bits[w] & (~std::uint64_t(0) >> (word_bits - 1 - (last - 1) % word_bits));
+				while (word == 0) {
+					if (w-- * word_bits <= first)
+						return last;
+					word = bits[w];
+				}
+				std::size_t i = w * word_bits + (word_bits - 1 - countl_zero64(word));
+				return i >= first ? i : last;
+			}
+
+			// Returns the first clear slot in [first, last), or last
+			static std::size_t next_free(const std::uint64_t* bits, std::size_t first, std::size_t last) noexcept {
+				for (; first < last; ++first)
+					if (!test(bits, first))
+						return first;
+				return last;
+			}
+
+			// Returns the last clear slot in [first, last), or last
+			static std::size_t prev_free(const std::uint64_t* bits, std::size_t first, std::size_t last) noexcept {
+				for (std::size_t i = last; i > first; --i)
+					if (!test(bits, i - 1))
+						return i - 1;
+				return last;
+			}
+
+			// Returns the number of set slots in [first, last)
+			static std::size_t count(const std::uint64_t* bits, std::size_t first, std::size_t last) noexcept {
+				std::size_t n = 0;
+				for (std::size_t i = next(bits, first, last); i < last; i = next(bits, i + 1, last))
+					++n;
+				return n;
+			}
+		};
+
+		// Bidirectional iterator over the occupied slots of a gapped array
+		template <
+			class Value,
+			class Pointer
+		> class gapped_iterator {
+			template <class, class> friend class gapped_iterator;
+		public:
+
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type        = Value;
+			using difference_type   = std::ptrdiff_t;
+			using pointer           = Pointer;
+			using reference         = decltype(*std::declval<Pointer>());
+
+			gapped_iterator() = default;
+
+			gapped_iterator(pointer slots, const std::uint64_t* bits, std::size_t pos, std::size_t slot_count) noexcept
+				: m_slots(slots)
+				, m_bits(bits)
+				, m_pos(pos)
+				, m_slot_count(slot_count) {}
+
+			// Conversion from iterator to const_iterator
+			template <class P, class = std::enable_if_t<std::is_convertible_v<P, Pointer> && !std::is_same_v<P, Pointer>>>
+			gapped_iterator(const gapped_iterator<Value, P>& other) noexcept
+				: m_slots(other.m_slots)
+				, m_bits(other.m_bits)
+				, m_pos(other.m_pos)
+				, m_slot_count(other.m_slot_count) {}
+
+			reference operator*() const noexcept { return m_slots[m_pos]; }
+			pointer operator->() const noexcept { return m_slots + m_pos; }
+
+			gapped_iterator& operator++() noexcept {
+				m_pos = slot_bitmap::next(m_bits, m_pos + 1, m_slot_count);
+				return *this;
+			}
+
+			gapped_iterator operator++(int) noexcept {
+				auto copy = *this;
+				++*this;
+				return copy;
+			}
+
+			gapped_iterator& operator--() noexcept {
+				m_pos = slot_bitmap::prev(m_bits, 0, m_pos);
+				return *this;
+			}
+
+			gapped_iterator operator--(int) noexcept {
+				auto copy = *this;
+				--*this;
+				return copy;
+			}
+
+			// Index of the slot in the gapped array
+			std::size_t slot() const noexcept { return m_pos; }
+
+			template <class P>
+			bool operator==(const gapped_iterator<Value, P>& other) const noexcept { return m_pos == other.m_pos; }
+			template <class P>
+			bool operator!=(const gapped_iterator<Value, P>& other) const noexcept { return m_pos != other.m_pos; }
+
+		private:
+			pointer m_slots = nullptr;
+			const std::uint64_t* m_bits = nullptr;
+			std::size_t m_pos = 0;
+			std::size_t m_slot_count = 0;
+		};
+
+		// A sorted associative container of unique keys stored as a packed memory array:
+		// a sorted array with gaps spread evenly through it. The slots are grouped into
+		// power of two segments of about log2(capacity()) slots, and aligned runs of
+		// segments form an implicit binary tree of windows. An insertion shifts elements
+		// only up to the nearest gap in its segment. When the segment is full, the smallest
+		// enclosing window whose density stays under its threshold, 1 at the segments down
+		// to 3/4 at the root, is respread evenly; when none qualifies the array doubles.
+		// This gives O(log^2 n) amortized element moves per insertion instead of O(n).
+		//
+		// Searches are binary searches over the gapped array that skip gaps with an
+		// occupancy bitmap, and iteration visits occupied slots in order. Gap slots hold
+		// value-initialized elements, so value_type must be default constructible.
+		template <
+			class Value,
+			class Compare,
+			class Allocator,
+			class ExtractKey
+		> class gapped_flat_tree {
+		public:
+
+			using container_type         = std::vector<Value, Allocator>;
+			using key_type               = typename ExtractKey::type;
+			using value_type             = Value;
+			using key_compare            = Compare;
+			using value_compare          = FTValueCompare<Value, Compare, ExtractKey>;
+			using key_extract            = ExtractKey;
+			using size_type              = std::size_t;
+			using difference_type        = std::ptrdiff_t;
+			using allocator_type         = Allocator;
+			using reference              = Value&;
+			using const_reference        = const Value&;
+			using pointer                = Value*;
+			using const_pointer          = const Value*;
+			using iterator               = gapped_iterator<Value, Value*>;
+			using const_iterator         = gapped_iterator<Value, const Value*>;
+			using reverse_iterator       = std::reverse_iterator<iterator>;
+			using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+			static_assert(std::is_default_constructible_v<Value>, "Gap slots require a default constructible value_type!");
+
+			// Smallest number of slots allocated once the tree holds an element
+			static constexpr size_type min_capacity = 64;
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                  CONSTRUCTORS                                  //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			gapped_flat_tree()
+				: gapped_flat_tree(Compare(), allocator_type()) {}
+
+			explicit gapped_flat_tree(const Compare& comp, const allocator_type& alloc = allocator_type())
+				: m_slots(alloc)
+				, m_kcmp(comp)
+				, m_vcmp(comp)
+				, m_kext() {}
+
+			explicit gapped_flat_tree(const allocator_type& alloc)
+				: gapped_flat_tree(Compare(), alloc) {}
+
+			template <class InIt>
+			gapped_flat_tree(InIt first, InIt last,
+				const Compare& comp = Compare(),
+				const allocator_type& alloc = allocator_type())
+				: gapped_flat_tree(comp, alloc)
+			{
+				insert(first, last);
+			}
+
+			template <class InIt>
+			gapped_flat_tree(sorted_unique_t tag, InIt first, InIt last,
+				const Compare& comp = Compare(),
+				const allocator_type& alloc = allocator_type())
+				: gapped_flat_tree(comp, alloc)
+			{
+				insert(tag, first, last);
+			}
+
+			gapped_flat_tree(std::initializer_list<value_type> list,
+				const Compare& comp = Compare(),
+				const allocator_type& alloc = allocator_type())
+				: gapped_flat_tree(list.begin(), list.end(), comp, alloc) {}
+
+			gapped_flat_tree(const gapped_flat_tree&) = default;
+			gapped_flat_tree(gapped_flat_tree&&) = default;
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                   DESTRUCTOR                                   //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			~gapped_flat_tree() = default;
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                   ASSIGNMENT                                   //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			gapped_flat_tree& operator=(const gapped_flat_tree&) = default;
+			gapped_flat_tree& operator=(gapped_flat_tree&&) = default;
+			gapped_flat_tree& operator=(std::initializer_list<value_type> list) {
+				clear();
+				insert(list);
+				return *this;
+			}
+
+			allocator_type get_allocator() const noexcept { return m_slots.get_allocator(); }
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                    ITERATORS                                   //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			iterator begin() noexcept { return make_iterator(first_slot()); }
+			const_iterator begin() const noexcept { return make_iterator(first_slot()); }
+			const_iterator cbegin() const noexcept { return begin(); }
+
+			iterator end() noexcept { return make_iterator(capacity()); }
+			const_iterator end() const noexcept { return make_iterator(capacity()); }
+			const_iterator cend() const noexcept { return end(); }
+
+			reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+			const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+			const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+			reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+			const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+			const_reverse_iterator crend() const noexcept { return rend(); }
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                    CAPACITY                                    //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			bool empty() const noexcept { return m_size == 0; }
+			size_type size() const noexcept { return m_size; }
+			size_type max_size() const noexcept { return m_slots.max_size(); }
+
+			// Number of slots, occupied or not
+			size_type capacity() const noexcept { return m_slots.size(); }
+
+			// Number of slots per segment
+			size_type segment_size() const noexcept { return m_segment; }
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                    MODIFIERS                                   //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			void clear() noexcept {
+				m_slots.clear();
+				m_bits.clear();
+				m_counts.clear();
+				m_size = 0;
+				m_segment = 0;
+			}
+
+			std::pair<iterator, bool> insert(const value_type& x) { return insert_unique(x); }
+			std::pair<iterator, bool> insert(value_type&& x) { return insert_unique(std::move(x)); }
+
+			// Sorts the new elements, merges them with the current ones in one pass and
+			// spreads the result over a freshly sized array
+			template <class InIt>
+			void insert(InIt first, InIt last) {
+				container_type tail(first, last, get_allocator());
+				std::stable_sort(tail.begin(), tail.end(), m_vcmp);
+				merge_sorted(std::move(tail));
+			}
+
+			template <class InIt>
+			void insert(sorted_unique_t, InIt first, InIt last) {
+				container_type tail(first, last, get_allocator());
+				assert(std::is_sorted(tail.begin(), tail.end(), m_vcmp) && "Range is not sorted!");
+				merge_sorted(std::move(tail));
+			}
+
+			void insert(std::initializer_list<value_type> list) {
+				insert(list.begin(), list.end());
+			}
+
+			template <class... Args>
+			std::pair<iterator, bool> emplace(Args&&... args) {
+				return insert_unique(value_type(std::forward<Args>(args)...));
+			}
+
+			iterator erase(const_iterator pos) {
+				assert(pos != cend() && "Iterator out of range!");
+				size_type i = pos.slot();
+				release(i);
+				if (!should_shrink())
+					return make_iterator(slot_bitmap::next(m_bits.data(), i + 1, capacity()));
+				size_type rank = slot_bitmap::count(m_bits.data(), 0, i);
+				return make_iterator(rebuild(capacity_for(m_size), rank));
+			}
+
+			iterator erase(const_iterator first, const_iterator last) {
+				size_type i = first.slot();
+				size_type end_slot = last.slot();
+				for (i = slot_bitmap::next(m_bits.data(), i, end_slot); i < end_slot; i = slot_bitmap::next(m_bits.data(), i + 1, end_slot))
+					release(i);
+				if (!should_shrink())
+					return make_iterator(slot_bitmap::next(m_bits.data(), end_slot, capacity()));
+				size_type rank = slot_bitmap::count(m_bits.data(), 0, end_slot);
+				return make_iterator(rebuild(capacity_for(m_size), rank));
+			}
+
+			size_type erase(const key_type& key) {
+				auto it = find(key);
+				if (it == end())
+					return 0;
+				erase(it);
+				return 1;
+			}
+
+			void swap(gapped_flat_tree& other) {
+				if (this != &other) {
+					std::swap(m_slots, other.m_slots);
+					std::swap(m_bits, other.m_bits);
+					std::swap(m_counts, other.m_counts);
+					std::swap(m_size, other.m_size);
+					std::swap(m_segment, other.m_segment);
+					std::swap(m_kcmp, other.m_kcmp);
+					std::swap(m_vcmp, other.m_vcmp);
+					std::swap(m_kext, other.m_kext);
+				}
+			}
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                     LOOKUP                                     //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			size_type count(const key_type& key) const { return contains(key); }
+
+			iterator find(const key_type& key) { return make_iterator(find_slot(key)); }
+			const_iterator find(const key_type& key) const { return make_iterator(find_slot(key)); }
+
+			bool contains(const key_type& key) const { return find_slot(key) != capacity(); }
+
+			std::pair<iterator, iterator> equal_range(const key_type& key) {
+				size_type i = find_slot(key);
+				if (i == capacity())
+					return { lower_bound(key), lower_bound(key) };
+				return { make_iterator(i), std::next(make_iterator(i)) };
+			}
+
+			std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+				size_type i = find_slot(key);
+				if (i == capacity())
+					return { lower_bound(key), lower_bound(key) };
+				return { make_iterator(i), std::next(make_iterator(i)) };
+			}
+
+			iterator lower_bound(const key_type& key) { return make_iterator(lower_bound_slot(key)); }
+			const_iterator lower_bound(const key_type& key) const { return make_iterator(lower_bound_slot(key)); }
+
+			iterator upper_bound(const key_type& key) { return make_iterator(upper_bound_slot(key)); }
+			const_iterator upper_bound(const key_type& key) const { return make_iterator(upper_bound_slot(key)); }
+
+			////////////////////////////////////////////////////////////////////////////////////
+			//                                    OBSERVERS                                   //
+			////////////////////////////////////////////////////////////////////////////////////
+
+			key_compare key_comp() const { return m_kcmp; }
+			value_compare value_comp() const { return m_vcmp; }
+
+		protected:
+
+			// Constructs an element right before pos, which must be the lower bound of its key
+			template <class... Args>
+			iterator emplace_at(const_iterator pos, Args&&... args) {
+				return make_iterator(insert_at(pos.slot(), value_type(std::forward<Args>(args)...)));
+			}
+
+		private:
+
+			iterator make_iterator(size_type i) noexcept {
+				return iterator(m_slots.data(), m_bits.data(), i, capacity());
+			}
+
+			const_iterator make_iterator(size_type i) const noexcept {
+				return const_iterator(m_slots.data(), m_bits.data(), i, capacity());
+			}
+
+			size_type first_slot() const noexcept {
+				return slot_bitmap::next(m_bits.data(), 0, capacity());
+			}
+
+			const key_type& key_at(size_type i) const { return m_kext(m_slots[i]); }
+
+			// Binary search over the slots; a probe that lands in a gap moves right to the next
+			// occupied slot and, if there is none before the upper end, narrows to the left half.
+			// Returns the first occupied slot for which below(key) is false, or capacity().
+			template <class Below>
+			size_type partition_slot(Below below) const {
+				const std::uint64_t* bits = m_bits.data();
+				size_type lo = 0, hi = capacity(), found = capacity();
+				while (lo < hi) {
+					size_type mid = lo + (hi - lo) / 2;
+					size_type i = slot_bitmap::next(bits, mid, hi);
+					if (i == hi)
+						hi = mid;
+					else if (below(key_at(i)))
+						lo = i + 1;
+					else {
+						found = i;
+						hi = mid;
+					}
+				}
+				return found;
+			}
+
+			size_type lower_bound_slot(const key_type& key) const {
+				return partition_slot([&](const key_type& k) { return m_kcmp(k, key); });
+			}
+
+			size_type upper_bound_slot(const key_type& key) const {
+				return partition_slot([&](const key_type& k) { return !m_kcmp(key, k); });
+			}
+
+			size_type find_slot(const key_type& key) const {
+				size_type i = lower_bound_slot(key);
+				if (i != capacity() && m_kcmp(key, key_at(i)))
+					return capacity();
+				return i;
+			}
+
+			template <class V>
+			std::pair<iterator, bool> insert_unique(V&& value) {
+				size_type i = lower_bound_slot(m_kext(value));
+				if (i != capacity() && !m_kcmp(m_kext(value), key_at(i)))
+					return { make_iterator(i), false };
+				return { make_iterator(insert_at(i, value_type(std::forward<V>(value)))), true };
+			}
+
+			// Inserts value right before the occupied slot i, or at the end if i is capacity(),
+			// and returns the slot it ends up in
+			size_type insert_at(size_type i, value_type&& value) {
+				if (capacity() == 0)
+					return rebuild(capacity_for(1), 0, &value);
+				const size_type segment = (i == capacity() ? i - 1 : i) / m_segment;
+				if (m_counts[segment] < m_segment)
+					return shift_into_segment(segment, i, std::move(value));
+				const size_type segments = m_counts.size();
+				size_type height = 0;
+				while ((size_type(1) << height) < segments)
+					++height;
+				for (size_type level = 1; level <= height; ++level) {
+					const size_type width = size_type(1) << level;
+					const size_type first = segment & ~(width - 1);
+					size_type count = 0;
+					for (size_type s = first; s < first + width; ++s)
+						count += m_counts[s];
+					// The upper density threshold falls linearly from 1 at the segments to 3/4 at the root
+					const size_type slots = width * m_segment;
+					if (4 * height * (count + 1) <= slots * (4 * height - level))
+						return respread(first * m_segment, slots, i, std::move(value));
+				}
+				size_type rank = slot_bitmap::count(m_bits.data(), 0, i);
+				return rebuild(capacity_for(m_size + 1), rank, &value);
+			}
+
+			// Shifts the elements between slot i and the nearest gap of its segment by one slot
+			size_type shift_into_segment(size_type segment, size_type i, value_type&& value) {
+				std::uint64_t* bits = m_bits.data();
+				const size_type first = segment * m_segment;
+				const size_type last = first + m_segment;
+				size_type gap = slot_bitmap::next_free(bits, i, last);
+				if (gap != last) {
+					std::move_backward(m_slots.begin() + i, m_slots.begin() + gap, m_slots.begin() + gap + 1);
+				}
+				else {
+					gap = slot_bitmap::prev_free(bits, first, i);
+					assert(gap != i && "Segment is full!");
+					std::move(m_slots.begin() + gap + 1, m_slots.begin() + i, m_slots.begin() + gap);
+					--i;
+				}
+				m_slots[i] = std::move(value);
+				slot_bitmap::set(bits, gap);
+				++m_counts[segment];
+				++m_size;
+				return i;
+			}
+
+			// Spreads the elements of the window [first, first + slots) and the new value,
+			// which goes right before slot i, evenly over the window
+			size_type respread(size_type first, size_type slots, size_type i, value_type&& value) {
+				container_type buffer(get_allocator());
+				take(first, i, buffer);
+				size_type rank = buffer.size();
+				buffer.push_back(std::move(value));
+				take(i, first + slots, buffer);
+				spread(buffer, first, slots);
+				++m_size;
+				return first + rank * slots / buffer.size();
+			}
+
+			// Moves the elements out of the occupied slots in [first, last) and marks them free
+			void take(size_type first, size_type last, container_type& buffer) {
+				std::uint64_t* bits = m_bits.data();
+				for (size_type i = slot_bitmap::next(bits, first, last); i < last; i = slot_bitmap::next(bits, i + 1, last)) {
+					buffer.push_back(std::move(m_slots[i]));
+					slot_bitmap::reset(bits, i);
+				}
+			}
+
+			// Places the elements of buffer evenly over [first, first + slots)
+			void spread(container_type& buffer, size_type first, size_type slots) {
+				std::uint64_t* bits = m_bits.data();
+				const size_type n = buffer.size();
+				for (size_type s = first / m_segment; s < (first + slots) / m_segment; ++s)
+					m_counts[s] = 0;
+				for (size_type k = 0; k < n; ++k) {
+					size_type i = first + k * slots / n;
+					m_slots[i] = std::move(buffer[k]);
+					slot_bitmap::set(bits, i);
+					++m_counts[i / m_segment];
+				}
+			}
+
+			// Moves every element into an array of new_capacity slots, adding *value at the
+			// given rank if there is one, and returns the slot of the element at that rank
+			size_type rebuild(size_type new_capacity, size_type rank, value_type* value = nullptr) {
+				container_type buffer(get_allocator());
+				buffer.reserve(m_size + 1);
+				take(0, capacity(), buffer);
+				if (value)
+					buffer.insert(buffer.begin() + rank, std::move(*value));
+				assign(std::move(buffer), new_capacity);
+				return rank < m_size ? rank * new_capacity / m_size : capacity();
+			}
+
+			// Replaces the contents with the sorted, unique elements of buffer
+			void assign(container_type&& buffer, size_type new_capacity) {
+				m_size = buffer.size();
+				if (m_size == 0) {
+					clear();
+					return;
+				}
+				m_segment = segment_size_for(new_capacity);
+				m_slots = container_type(new_capacity, get_allocator());
+				m_bits.assign(slot_bitmap::words(new_capacity), 0);
+				m_counts.assign(new_capacity / m_segment, 0);
+				spread(buffer, 0, new_capacity);
+			}
+
+			// Merges a sorted range into the elements, keeping the first of equivalent ones
+			void merge_sorted(container_type&& tail) {
+				if (tail.empty())
+					return;
+				container_type buffer(get_allocator());
+				buffer.reserve(m_size + tail.size());
+				take(0, capacity(), buffer);
+				container_type merged(get_allocator());
+				merged.reserve(buffer.size() + tail.size());
+				std::merge(std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()),
+					std::make_move_iterator(tail.begin()), std::make_move_iterator(tail.end()),
+					std::back_inserter(merged), m_vcmp);
+				merged.erase(std::unique(merged.begin(), merged.end(), [&](const value_type& lhs, const value_type& rhs) {
+					return !m_vcmp(lhs, rhs);
+				}), merged.end());
+				assign(std::move(merged), capacity_for(merged.size()));
+			}
+
+			void release(size_type i) {
+				slot_bitmap::reset(m_bits.data(), i);
+				m_slots[i] = value_type();
+				--m_counts[i / m_segment];
+				--m_size;
+			}
+
+			bool should_shrink() const noexcept {
+				return capacity() > min_capacity && m_size < capacity() / 4;
+			}
+
+			// Smallest power of two number of slots that keeps n elements at most half dense
+			static size_type capacity_for(size_type n) noexcept {
+				size_type slots = min_capacity;
+				while (slots < 2 * n)
+					slots *= 2;
+				return slots;
+			}
+
+			// Power of two closest above log2(slots), at least 8 and at most slots
+			static size_type segment_size_for(size_type slots) noexcept {
+				size_type log = 0;
+				while ((size_type(1) << log) < slots)
+					++log;
+				size_type segment = 8;
+				while (segment < log)
+					segment *= 2;
+				return std::min(segment, slots);
+			}
+
+			container_type             m_slots;       // Gapped sorted array
+			std::vector<std::uint64_t> m_bits;        // Occupancy bitmap of m_slots
+			std::vector<size_type>     m_counts;      // Number of occupied slots in each segment
+			size_type                  m_size = 0;    // Number of occupied slots
+			size_type                  m_segment = 0; // Slots per segment
+			key_compare                m_kcmp;        // Key comparison
+			value_compare              m_vcmp;        // Value comparison
+			key_extract                m_kext;        // Key extraction
+
+		};
+
+		template <class Val, class Comp, class Alloc, class ExtKey>
+		bool operator==(
+			const gapped_flat_tree<Val, Comp, Alloc, ExtKey>& lhs,
+			const gapped_flat_tree<Val, Comp, Alloc, ExtKey>& rhs)
+		{
+			return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+		}
+
+		template <class Val, class Comp, class Alloc, class ExtKey>
+		bool operator!=(
+			const gapped_flat_tree<Val, Comp, Alloc, ExtKey>& lhs,
+			const gapped_flat_tree<Val, Comp, Alloc, ExtKey>& rhs)
+		{
+			return !(lhs == rhs);
+		}
+
+	}
+}
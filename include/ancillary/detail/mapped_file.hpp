@@ -0,0 +1,280 @@
+#pragma once
+
+#include <string>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <system_error>
+#include "prefetch.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace ancillary {
+	namespace detail {
+
+		// On-disk layout of a mapped flat container:
+		//
+		//   [mapped_header][padding][keys ...][padding][mapped values ...]
+		//
+		// Both arrays start on a cache line boundary and hold size() sorted elements
+		// in native byte order. Sets store no mapped values and have mapped_size 0.
+		struct mapped_header {
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t byte_order;
+			std::uint64_t size;
+			std::uint64_t key_size;
+			std::uint64_t mapped_size;
+			std::uint64_t keys_offset;
+			std::uint64_t values_offset;
+		};
+
+		inline constexpr char mapped_magic[8] = { 'A', 'N', 'C', 'F', 'L', 'A', 'T', '\0' };
+		inline constexpr std::uint32_t mapped_version = 1;
+		inline constexpr std::uint32_t mapped_byte_order = 0x01020304;
+
+		constexpr std::uint64_t mapped_align(std::uint64_t offset) noexcept {
+			return (offset + cache_line_size - 1) / cache_line_size * cache_line_size;
+		}
+
+		constexpr mapped_header make_mapped_header(std::uint64_t size, std::uint64_t key_size, std::uint64_t mapped_size) noexcept {
+			mapped_header header{};
+			for (std::size_t i = 0; i < sizeof(mapped_magic); ++i)
+				header.magic[i] = mapped_magic[i];
+			header.version = mapped_version;
+			header.byte_order = mapped_byte_order;
+			header.size = size;
+			header.key_size = key_size;
+			header.mapped_size = mapped_size;
+			header.keys_offset = mapped_align(sizeof(mapped_header));
+			header.values_offset = mapped_align(header.keys_offset + size * key_size);
+			return header;
+		}
+
+		template <class Key, class T>
+		constexpr void check_mappable() noexcept {
+			static_assert(std::is_trivially_copyable_v<Key>, "Mapped keys must be trivially copyable!");
+			static_assert(std::is_trivially_copyable_v<T>, "Mapped values must be trivially copyable!");
+			static_assert(alignof(Key) <= cache_line_size && alignof(T) <= cache_line_size,
+				"Mapped elements must not be over-aligned!");
+		}
+
+		// Read-only view of a contiguous array, shaped like a container so that
+		// container_search recognizes it as contiguous
+		template <
+			class T
+		> class array_view {
+		public:
+			using value_type = T;
+			using size_type = std::size_t;
+			using iterator = const T*;
+			using const_iterator = const T*;
+
+			array_view() noexcept = default;
+
+			array_view(const T* data, size_type size) noexcept
+				: m_data(data)
+				, m_size(size) {}
+
+			const T* data() const noexcept { return m_data; }
+			size_type size() const noexcept { return m_size; }
+			bool empty() const noexcept { return m_size == 0; }
+
+			const_iterator begin() const noexcept { return m_data; }
+			const_iterator end() const noexcept { return m_data + m_size; }
+
+			const T& operator[](size_type i) const noexcept { return m_data[i]; }
+
+		private:
+			const T* m_data = nullptr;
+			size_type m_size = 0;
+		};
+
+		// Maps a whole file read-only into memory for the lifetime of the object.
+		// Pages are loaded on first touch and shared with every other process
+		// mapping the same file.
+		class mapped_file {
+		public:
+			mapped_file() noexcept = default;
+
+			explicit mapped_file(const std::string& path) {
+#if defined(_WIN32)
+				HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+					OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (file == INVALID_HANDLE_VALUE)
+					throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), "Unable to open " + path);
+				LARGE_INTEGER size;
+				if (!::GetFileSizeEx(file, &size)) {
+					auto error = static_cast<int>(::GetLastError());
+					::CloseHandle(file);
+					throw std::system_error(error, std::system_category(), "Unable to stat " + path);
+				}
+				m_size = static_cast<std::size_t>(size.QuadPart);
+				if (m_size != 0) {
+					HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					if (mapping)
+						m_data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+					auto error = static_cast<int>(::GetLastError());
+					if (mapping)
+						::CloseHandle(mapping);
+					if (!m_data) {
+						::CloseHandle(file);
+						throw std::system_error(error, std::system_category(), "Unable to map " + path);
+					}
+				}
+				::CloseHandle(file);
+#else
+				int fd = ::open(path.c_str(), O_RDONLY);
+				if (fd < 0)
+					throw std::system_error(errno, std::generic_category(), "Unable to open " + path);
+				struct stat info;
+				if (::fstat(fd, &info) != 0) {
+					int error = errno;
+					::close(fd);
+					throw std::system_error(error, std::generic_category(), "Unable to stat " + path);
+				}
+				m_size = static_cast<std::size_t>(info.st_size);
+				if (m_size != 0) {
+					void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+					if (data == MAP_FAILED) {
+						int error = errno;
+						::close(fd);
+						throw std::system_error(error, std::generic_category(), "Unable to map " + path);
+					}
+					m_data = data;
+				}
+				::close(fd);
+#endif
+			}
+
+			mapped_file(const mapped_file&) = delete;
+
+			mapped_file(mapped_file&& other) noexcept
+				: m_data(std::exchange(other.m_data, nullptr))
+				, m_size(std::exchange(other.m_size, 0)) {}
+
+			~mapped_file() {
+				unmap();
+			}
+
+			mapped_file& operator=(const mapped_file&) = delete;
+
+			mapped_file& operator=(mapped_file&& other) noexcept {
+				if (this != &other) {
+					unmap();
+					m_data = std::exchange(other.m_data, nullptr);
+					m_size = std::exchange(other.m_size, 0);
+				}
+				return *this;
+			}
+
+			const char* data() const noexcept { return static_cast<const char*>(m_data); }
+			std::size_t size() const noexcept { return m_size; }
+
+			// Validates the header against the expected element sizes and returns it
+			const mapped_header& header(std::uint64_t key_size, std::uint64_t mapped_size) const {
+				if (m_size < sizeof(mapped_header))
+					throw std::runtime_error("Not a mapped flat container file!");
+				const auto& header = *reinterpret_cast<const mapped_header*>(m_data);
+				if (std::memcmp(header.magic, mapped_magic, sizeof(mapped_magic)) != 0)
+					throw std::runtime_error("Not a mapped flat container file!");
+				if (header.version != mapped_version || header.byte_order != mapped_byte_order)
+					throw std::runtime_error("Unsupported mapped flat container version or byte order!");
+				if (header.key_size != key_size || header.mapped_size != mapped_size)
+					throw std::runtime_error("Mapped element types do not match the file!");
+				if (header.size > m_size)
+					throw std::runtime_error("Truncated mapped flat container file!");
+				auto expected = make_mapped_header(header.size, key_size, mapped_size);
+				if (header.keys_offset != expected.keys_offset || header.values_offset != expected.values_offset
+					|| m_size < header.values_offset + header.size * mapped_size)
+					throw std::runtime_error("Truncated mapped flat container file!");
+				return header;
+			}
+
+		private:
+
+			void unmap() noexcept {
+				if (!m_data)
+					return;
+#if defined(_WIN32)
+				::UnmapViewOfFile(m_data);
+#else
+				::munmap(m_data, m_size);
+#endif
+				m_data = nullptr;
+				m_size = 0;
+			}
+
+			void* m_data = nullptr;
+			std::size_t m_size = 0;
+		};
+
+		// Writes a mapped flat container file. The caller supplies the elements in
+		// sorted order; keys are written first, then the mapped values.
+		class mapped_writer {
+		public:
+			mapped_writer(const std::string& path, const mapped_header& header)
+				: m_out(path, std::ios::binary | std::ios::trunc)
+				, m_path(path)
+				, m_header(header)
+			{
+				if (!m_out)
+					throw std::system_error(errno, std::generic_category(), "Unable to create " + path);
+				write(&m_header, sizeof(m_header));
+				pad_to(m_header.keys_offset);
+			}
+
+			template <class Key>
+			void write_key(const Key& key) {
+				write(&key, sizeof(Key));
+			}
+
+			void begin_values() {
+				pad_to(m_header.values_offset);
+			}
+
+			template <class T>
+			void write_value(const T& value) {
+				write(&value, sizeof(T));
+			}
+
+			void finish() {
+				m_out.flush();
+				if (!m_out)
+					throw std::runtime_error("Unable to write " + m_path);
+			}
+
+		private:
+
+			void write(const void* data, std::size_t size) {
+				m_out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+				m_offset += size;
+			}
+
+			void pad_to(std::uint64_t offset) {
+				const char zeros[cache_line_size] = {};
+				write(zeros, static_cast<std::size_t>(offset - m_offset));
+			}
+
+			std::ofstream m_out;
+			std::string m_path;
+			mapped_header m_header;
+			std::uint64_t m_offset = 0;
+		};
+
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+#if !defined(__GNUC__) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace ancillary {
+	namespace detail {
+
+		inline void prefetch(const void* addr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+			__builtin_prefetch(addr);
+#elif defined(_M_X64) || defined(_M_IX86)
+			_mm_prefetch(static_cast<const char*>(addr), _MM_HINT_T0);
+#else
+			(void)addr;
+#endif
+		}
+
+		constexpr std::size_t cache_line_size = 64;
+
+	}
+}
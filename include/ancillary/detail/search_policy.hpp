@@ -0,0 +1,240 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include "prefetch.hpp"
+#include "extract_key.hpp"
+#include "simd_search.hpp"
+
+namespace ancillary {
+
+	// Search policies decide how the flat containers locate a key within their sorted
+	// storage. A policy provides lower_bound and upper_bound over [first, last) given a
+	// key comparison and a key extraction functor. Policies that declare `vectorizable`
+	// let containers of arithmetic keys ordered by std::less, including maps whose pairs
+	// lead with such a key, use vector compares instead.
+
+	// Classic binary search, taking a data dependent branch at every step
+	struct binary_search_policy {
+		static constexpr bool vectorizable = true;
+
+		template <class RndIt, class Key, class Compare, class ExtractKey>
+		static RndIt lower_bound(RndIt first, RndIt last, const Key& key, const Compare& comp, const ExtractKey& ext) {
+			typename std::iterator_traits<RndIt>::difference_type len, step;
+			len = last - first;
+			RndIt mid;
+			while (len > 0) {
+				mid = first;
+				step = len / 2;
+				mid += step;
+				if (comp(ext(*mid), key)) {
+					first = ++mid;
+					len -= step + 1;
+				}
+				else
+					len = step;
+			}
+			return first;
+		}
+
+		template <class RndIt, class Key, class Compare, class ExtractKey>
+		static RndIt upper_bound(RndIt first, RndIt last, const Key& key, const Compare& comp, const ExtractKey& ext) {
+			typename std::iterator_traits<RndIt>::difference_type len, step;
+			len = last - first;
+			RndIt mid;
+			while (len > 0) {
+				mid = first;
+				step = len / 2;
+				mid += step;
+				if (!comp(key, ext(*mid))) {
+					first = ++mid;
+					len -= step + 1;
+				}
+				else
+					len = step;
+			}
+			return first;
+		}
+	};
+
+	// Binary search whose loop body compiles to a conditional move. Both candidate
+	// midpoints of the next step are prefetched, so the memory latency of a step
+	// overlaps with the comparison of the previous one.
+	struct branchless_search_policy {
+		static constexpr bool vectorizable = true;
+
+		template <class RndIt, class Key, class Compare, class ExtractKey>
+		static RndIt lower_bound(RndIt first, RndIt last, const Key& key, const Compare& comp, const ExtractKey& ext) {
+			return partition_point(first, last, [&](const auto& value) { return comp(ext(value), key); });
+		}
+
+		template <class RndIt, class Key, class Compare, class ExtractKey>
+		static RndIt upper_bound(RndIt first, RndIt last, const Key& key, const Compare& comp, const ExtractKey& ext) {
+			return partition_point(first, last, [&](const auto& value) { return !comp(key, ext(value)); });
+		}
+
+		template <class RndIt, class Pred>
+		static RndIt partition_point(RndIt first, RndIt last, Pred pred) {
+			typename std::iterator_traits<RndIt>::difference_type len, half;
+			len = last - first;
+			if (len == 0)
+				return first;
+			while (len > 1) {
+				half = len / 2;
+				detail::prefetch(std::addressof(first[(len - half) / 2]));
+				detail::prefetch(std::addressof(first[half + (len - half) / 2]));
+				first += pred(first[half]) ? half : 0;
+				len -= half;
+			}
+			return first + pred(*first);
+		}
+	};
+
+	// Interpolation search for arithmetic keys ordered by std::less. Every step guesses
+	// where the key lies from the keys at both ends of the remaining range, which takes
+	// O(log log n) steps when the keys are spread evenly. Once a guess misses, or after
+	// max_interpolations steps, the rest of the range is searched without branches, so
+	// skewed keys cost little more than a binary search. Other keys are binary searched.
+	struct interpolation_search_policy {
+		static constexpr std::size_t max_interpolations = 6;
+		static constexpr std::ptrdiff_t min_interpolation_length = 16;
+
+		template <class RndIt, class Key, class Compare, class ExtractKey>
+		static RndIt lower_bound(RndIt first, RndIt last, const Key& key, const Compare& comp, const ExtractKey& ext) {
+			if constexpr (is_interpolatable<RndIt, Key, Compare, ExtractKey>) {
+				narrow(first, last, key, ext, [&](const auto& value) { return value < key; });
+				return branchless_search_policy::lower_bound(first, last, key, comp, ext);
+			}
+			else {
+				return binary_search_policy::lower_bound(first, last, key, comp, ext);
+			}
+		}
+
+		template <class RndIt, class Key, class Compare, class ExtractKey>
+		static RndIt upper_bound(RndIt first, RndIt last, const Key& key, const Compare& comp, const ExtractKey& ext) {
+			if constexpr (is_interpolatable<RndIt, Key, Compare, ExtractKey>) {
+				narrow(first, last, key, ext, [&](const auto& value) { return !(key < value); });
+				return branchless_search_policy::upper_bound(first, last, key, comp, ext);
+			}
+			else {
+				return binary_search_policy::upper_bound(first, last, key, comp, ext);
+			}
+		}
+
+		template <class RndIt, class Key, class Compare, class ExtractKey>
+		static constexpr bool is_interpolatable =
+			std::is_arithmetic_v<Key> &&
+			std::is_arithmetic_v<std::decay_t<decltype(std::declval<const ExtractKey&>()(*std::declval<RndIt>()))>> &&
+			(std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>);
+
+		// Shrinks [first, last) around the partition point of before. Each step guesses
+		// the position from the end keys and probes sqrt(len) elements either side of it,
+		// which is where evenly spread keys land with high probability. A key outside the
+		// window means the guesses cannot be trusted, so the caller takes over from there.
+		template <class RndIt, class Key, class ExtractKey, class Before>
+		static void narrow(RndIt& first, RndIt& last, const Key& key, const ExtractKey& ext, Before before) {
+			using diff_t = typename std::iterator_traits<RndIt>::difference_type;
+			diff_t len;
+			for (std::size_t i = 0; i < max_interpolations && (len = last - first) > min_interpolation_length; ++i) {
+				const auto& low = ext(*first);
+				const auto& high = ext(*(last - 1));
+				if (!before(low)) {
+					last = first;
+					return;
+				}
+				if (before(high)) {
+					first = last;
+					return;
+				}
+				double fraction = (static_cast<double>(key) - static_cast<double>(low)) /
+					(static_cast<double>(high) - static_cast<double>(low));
+				if (!(fraction >= 0.0))
+					fraction = 0.0;
+				auto guess = static_cast<diff_t>(std::min(fraction, 1.0) * static_cast<double>(len - 1));
+				auto radius = static_cast<diff_t>(std::sqrt(static_cast<double>(len)));
+				RndIt lower = first + std::max<diff_t>(guess - radius, 0);
+				RndIt upper = first + std::min<diff_t>(guess + radius, len - 1);
+				bool after_lower = before(ext(*lower));
+				bool after_upper = before(ext(*upper));
+				if (!after_lower) {
+					last = lower;
+					return;
+				}
+				if (after_upper) {
+					first = upper + 1;
+					return;
+				}
+				first = lower + 1;
+				last = upper;
+			}
+		}
+	};
+
+	namespace detail {
+
+		// Containers whose iterators are raw pointers are contiguous by construction
+		template <class Container>
+		struct is_contiguous_container
+			: std::is_pointer<typename Container::iterator> {};
+
+		template <class T, class Allocator>
+		struct is_contiguous_container<std::vector<T, Allocator>>
+			: std::bool_constant<!std::is_same_v<T, bool>> {};
+
+		// Searches a sorted container with its search policy, or with vector compares when
+		// the container holds contiguous arithmetic keys, alone or leading a pair, ordered
+		// by std::less
+		template <
+			class Container,
+			class Compare,
+			class ExtractKey,
+			class SearchPolicy
+		> struct container_search {
+			using value_type = typename Container::value_type;
+			using key_type = typename ExtractKey::type;
+
+			template <class Key>
+			static constexpr bool vectorized =
+				is_simd_value_v<value_type, key_type> &&
+				(std::is_same_v<value_type, key_type> || std::is_same_v<ExtractKey, select1st<value_type>>) &&
+				std::is_same_v<Key, key_type> &&
+				is_simd_key_v<key_type> &&
+				is_default_less_v<Compare, key_type> &&
+				is_vectorizable_policy<SearchPolicy>::value &&
+				is_contiguous_container<Container>::value;
+
+			template <class RndIt, class Key>
+			static RndIt lower_bound(const Container& c, RndIt first, RndIt last, const Key& key,
+				const Compare& comp, const ExtractKey& ext)
+			{
+				if constexpr (vectorized<Key>) {
+					const value_type* data = c.data() + (first - c.begin());
+					return first + (simd_lower_bound(data, data + (last - first), key) - data);
+				}
+				else {
+					return SearchPolicy::lower_bound(first, last, key, comp, ext);
+				}
+			}
+
+			template <class RndIt, class Key>
+			static RndIt upper_bound(const Container& c, RndIt first, RndIt last, const Key& key,
+				const Compare& comp, const ExtractKey& ext)
+			{
+				if constexpr (vectorized<Key>) {
+					const value_type* data = c.data() + (first - c.begin());
+					return first + (simd_upper_bound(data, data + (last - first), key) - data);
+				}
+				else {
+					return SearchPolicy::upper_bound(first, last, key, comp, ext);
+				}
+			}
+		};
+
+	}
+
+}
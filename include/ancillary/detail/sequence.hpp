@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+namespace ancillary {
+	namespace detail {
+
+		// The flat containers store their elements in any random access sequence container
+		// that supports insert, emplace and erase at an iterator. Everything else a sequence
+		// may or may not offer, such as an allocator or reserved capacity, goes through the
+		// helpers below, which fall back to doing nothing when it is missing.
+
+		template <class Sequence, class = void>
+		struct has_reserve
+			: std::false_type {};
+
+		template <class Sequence>
+		struct has_reserve<Sequence, std::void_t<decltype(std::declval<Sequence&>().reserve(std::size_t()))>>
+			: std::true_type {};
+
+		template <class Sequence, class = void>
+		struct has_capacity
+			: std::false_type {};
+
+		template <class Sequence>
+		struct has_capacity<Sequence, std::void_t<decltype(std::declval<const Sequence&>().capacity())>>
+			: std::true_type {};
+
+		template <class Sequence, class = void>
+		struct has_shrink_to_fit
+			: std::false_type {};
+
+		template <class Sequence>
+		struct has_shrink_to_fit<Sequence, std::void_t<decltype(std::declval<Sequence&>().shrink_to_fit())>>
+			: std::true_type {};
+
+		template <class Sequence, class = void>
+		struct has_get_allocator
+			: std::false_type {};
+
+		template <class Sequence>
+		struct has_get_allocator<Sequence, std::void_t<decltype(std::declval<const Sequence&>().get_allocator())>>
+			: std::true_type {};
+
+		// The sequence's own allocator type, or Fallback for sequences without one
+		template <class Sequence, class Fallback, class = void>
+		struct sequence_allocator {
+			using type = Fallback;
+		};
+
+		template <class Sequence, class Fallback>
+		struct sequence_allocator<Sequence, Fallback, std::void_t<typename Sequence::allocator_type>> {
+			using type = typename Sequence::allocator_type;
+		};
+
+		template <class Sequence, class Fallback>
+		using sequence_allocator_t = typename sequence_allocator<Sequence, Fallback>::type;
+
+		template <class Sequence, class... Args, class Allocator>
+		Sequence make_sequence(const Allocator& alloc, Args&&... args) {
+			if constexpr (std::is_constructible_v<Sequence, Args..., const Allocator&>) {
+				return Sequence(std::forward<Args>(args)..., alloc);
+			}
+			else {
+				return Sequence(std::forward<Args>(args)...);
+			}
+		}
+
+		template <class Allocator, class Sequence>
+		Allocator sequence_get_allocator(const Sequence& seq) {
+			if constexpr (has_get_allocator<Sequence>::value) {
+				return seq.get_allocator();
+			}
+			else {
+				return Allocator();
+			}
+		}
+
+		template <class Sequence>
+		void sequence_reserve(Sequence& seq, std::size_t new_cap) {
+			if constexpr (has_reserve<Sequence>::value)
+				seq.reserve(new_cap);
+		}
+
+		template <class Sequence>
+		std::size_t sequence_capacity(const Sequence& seq) {
+			if constexpr (has_capacity<Sequence>::value) {
+				return seq.capacity();
+			}
+			else {
+				return seq.size();
+			}
+		}
+
+		template <class Sequence>
+		void sequence_shrink_to_fit(Sequence& seq) {
+			if constexpr (has_shrink_to_fit<Sequence>::value)
+				seq.shrink_to_fit();
+		}
+
+	}
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include "prefetch.hpp"
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#define ANCILLARY_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(ANCILLARY_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define ANCILLARY_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#else
+#define ANCILLARY_TARGET_AVX2
+#endif
+
+namespace ancillary {
+	namespace detail {
+
+		// Keys the vectorized search knows how to compare with std::less semantics
+		template <class Key>
+		constexpr bool is_simd_key_v =
+			std::is_same_v<Key, std::int32_t> || std::is_same_v<Key, std::uint32_t> ||
+			std::is_same_v<Key, std::int64_t> || std::is_same_v<Key, std::uint64_t> ||
+			std::is_same_v<Key, float> || std::is_same_v<Key, double>;
+
+		template <class Compare, class Key>
+		constexpr bool is_default_less_v =
+			std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>;
+
+		// Policies opt into the vectorized final stage by declaring a `vectorizable` member
+		template <class Policy, class = void>
+		struct is_vectorizable_policy
+			: std::false_type {};
+
+		template <class Policy>
+		struct is_vectorizable_policy<Policy, std::void_t<decltype(Policy::vectorizable)>>
+			: std::bool_constant<Policy::vectorizable> {};
+
+		// Elements the vectorized search can walk: the keys themselves, or pairs that
+		// lead with their key. A pair is compared as a run of keys of which only the
+		// lanes holding a first member count.
+		template <class Value, class Key>
+		struct is_simd_value
+			: std::is_same<Value, Key> {};
+
+		template <class Key, class T>
+		struct is_simd_value<std::pair<Key, T>, Key>
+			: std::bool_constant<std::is_standard_layout_v<std::pair<Key, T>>> {};
+
+		template <class Value, class Key>
+		constexpr bool is_simd_value_v = is_simd_value<Value, Key>::value;
+
+		template <class Key, class Value>
+		const Key& simd_key(const Value& value) noexcept {
+			if constexpr (std::is_same_v<Value, Key>)
+				return value;
+			else
+				return value.first;
+		}
+
+		template <class Value, class Key>
+		std::size_t count_less_scalar(const Value* first, std::size_t n, Key key) noexcept {
+			std::size_t count = 0;
+			for (std::size_t i = 0; i < n; ++i)
+				count += simd_key<Key>(first[i]) < key;
+			return count;
+		}
+
+		template <class Value, class Key>
+		std::size_t count_greater_scalar(const Value* first, std::size_t n, Key key) noexcept {
+			std::size_t count = 0;
+			for (std::size_t i = 0; i < n; ++i)
+				count += key < simd_key<Key>(first[i]);
+			return count;
+		}
+
+#if defined(ANCILLARY_SIMD_X86)
+
+		inline bool cpu_has_avx2() noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#else
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+				return false;
+			__cpuid(info, 1);
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool popcnt = (info[2] & (1 << 23)) != 0;
+			if (!osxsave || !popcnt || (_xgetbv(0) & 0x6) != 0x6)
+				return false;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#endif
+		}
+
+		inline const bool has_avx2 = cpu_has_avx2();
+
+		ANCILLARY_TARGET_AVX2 inline unsigned popcount_avx2(unsigned mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<unsigned>(__builtin_popcount(mask));
+#else
+			return __popcnt(mask);
+#endif
+		}
+
+		// Number of elements a 256-bit register holds, or zero when elements do not
+		// tile it evenly with their key at the front
+		template <class Value, class Key>
+		constexpr std::size_t avx2_elements = sizeof(Value) % sizeof(Key) == 0 && 32 % sizeof(Value) == 0 ? 32 / sizeof(Value) : 0;
+
+		// Movemask bits of the lanes that hold a key
+		template <class Value, class Key>
+		constexpr unsigned avx2_key_lanes() noexcept {
+			constexpr std::size_t lanes = 32 / sizeof(Key);
+			constexpr std::size_t stride = sizeof(Value) / sizeof(Key);
+			unsigned mask = 0;
+			for (std::size_t lane = 0; lane < lanes; lane += stride)
+				mask |= 1u << lane;
+			return mask;
+		}
+
+		// Counts the elements in [first, first + n) whose key compares greater than key
+		// when isGreater is set, or less than key otherwise, a register at a time.
+		template <bool isGreater, class Value, class Key>
+		ANCILLARY_TARGET_AVX2 std::size_t count_avx2(const Value* first, std::size_t n, Key key) noexcept {
+			constexpr std::size_t step = avx2_elements<Value, Key>;
+			constexpr unsigned keep = avx2_key_lanes<Value, Key>();
+			std::size_t count = 0;
+			std::size_t i = 0;
+			if constexpr (std::is_floating_point_v<Key>) {
+				constexpr int predicate = isGreater ? _CMP_GT_OQ : _CMP_LT_OQ;
+				if constexpr (std::is_same_v<Key, float>) {
+					const __m256 k = _mm256_set1_ps(key);
+					for (; i + step <= n; i += step) {
+						__m256 x = _mm256_loadu_ps(reinterpret_cast<const float*>(first + i));
+						count += popcount_avx2(static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(x, k, predicate))) & keep);
+					}
+				}
+				else {
+					const __m256d k = _mm256_set1_pd(key);
+					for (; i + step <= n; i += step) {
+						__m256d x = _mm256_loadu_pd(reinterpret_cast<const double*>(first + i));
+						count += popcount_avx2(static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(x, k, predicate))) & keep);
+					}
+				}
+			}
+			else if constexpr (sizeof(Key) == 4) {
+				// Unsigned keys are compared as signed ones after flipping their sign bit
+				const __m256i flip = _mm256_set1_epi32(std::is_signed_v<Key> ? 0 : INT32_MIN);
+				const __m256i k = _mm256_xor_si256(_mm256_set1_epi32(static_cast<std::int32_t>(key)), flip);
+				for (; i + step <= n; i += step) {
+					__m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i)), flip);
+					__m256i mask = isGreater ? _mm256_cmpgt_epi32(x, k) : _mm256_cmpgt_epi32(k, x);
+					count += popcount_avx2(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))) & keep);
+				}
+			}
+			else {
+				const __m256i flip = _mm256_set1_epi64x(std::is_signed_v<Key> ? 0 : INT64_MIN);
+				const __m256i k = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<std::int64_t>(key)), flip);
+				for (; i + step <= n; i += step) {
+					__m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i)), flip);
+					__m256i mask = isGreater ? _mm256_cmpgt_epi64(x, k) : _mm256_cmpgt_epi64(k, x);
+					count += popcount_avx2(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(mask))) & keep);
+				}
+			}
+			if constexpr (isGreater)
+				return count + count_greater_scalar(first + i, n - i, key);
+			else
+				return count + count_less_scalar(first + i, n - i, key);
+		}
+
+#endif
+
+		template <class Value, class Key>
+		std::size_t count_less(const Value* first, std::size_t n, Key key) noexcept {
+#if defined(ANCILLARY_SIMD_X86)
+			if (avx2_elements<Value, Key> != 0 && has_avx2)
+				return count_avx2<false>(first, n, key);
+#endif
+			return count_less_scalar(first, n, key);
+		}
+
+		template <class Value, class Key>
+		std::size_t count_greater(const Value* first, std::size_t n, Key key) noexcept {
+#if defined(ANCILLARY_SIMD_X86)
+			if (avx2_elements<Value, Key> != 0 && has_avx2)
+				return count_avx2<true>(first, n, key);
+#endif
+			return count_greater_scalar(first, n, key);
+		}
+
+		// Narrows [first, last) with a branchless binary search until the remaining
+		// candidates span two cache lines, then counts them with vector compares.
+		template <bool isUpper, class Value, class Key>
+		const Value* simd_bound(const Value* first, const Value* last, Key key) noexcept {
+			constexpr std::size_t window = sizeof(Value) < cache_line_size ? 2 * cache_line_size / sizeof(Value) : 2;
+			std::size_t len = static_cast<std::size_t>(last - first);
+			while (len > window) {
+				std::size_t half = len / 2;
+				prefetch(first + (len - half) / 2);
+				prefetch(first + half + (len - half) / 2);
+				if constexpr (isUpper)
+					first += !(key < simd_key<Key>(first[half])) ? half : 0;
+				else
+					first += simd_key<Key>(first[half]) < key ? half : 0;
+				len -= half;
+			}
+			if constexpr (isUpper)
+				return first + (len - count_greater(first, len, key));
+			else
+				return first + count_less(first, len, key);
+		}
+
+		template <class Value, class Key>
+		const Value* simd_lower_bound(const Value* first, const Value* last, Key key) noexcept {
+			return simd_bound<false>(first, last, key);
+		}
+
+		template <class Value, class Key>
+		const Value* simd_upper_bound(const Value* first, const Value* last, Key key) noexcept {
+			return simd_bound<true>(first, last, key);
+		}
+
+	}
+}
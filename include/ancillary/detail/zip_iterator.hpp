@@ -0,0 +1,96 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+
+namespace ancillary {
+	namespace detail {
+
+		// Holds a pair of references so that operator-> can be used on a zip_iterator
+		template <
+			class Reference
+		> struct arrow_proxy {
+			Reference ref;
+			Reference* operator->() noexcept { return std::addressof(ref); }
+		};
+
+		// Random access iterator over two parallel sequences that yields a pair of
+		// references to the elements at the same position in each of them
+		template <
+			class FirstIt,
+			class SecondIt
+		> class zip_iterator {
+		public:
+			using first_reference = typename std::iterator_traits<FirstIt>::reference;
+			using second_reference = typename std::iterator_traits<SecondIt>::reference;
+
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = std::pair
+				<
+					typename std::iterator_traits<FirstIt>::value_type,
+					typename std::iterator_traits<SecondIt>::value_type
+				>;
+			using difference_type = typename std::iterator_traits<FirstIt>::difference_type;
+			using reference = std::pair<first_reference, second_reference>;
+			using pointer = arrow_proxy<reference>;
+
+			template <class, class>
+			friend class zip_iterator;
+
+			zip_iterator() = default;
+
+			zip_iterator(FirstIt first, SecondIt second)
+				: m_first(first)
+				, m_second(second) {}
+
+			template <class OtherFirstIt, class OtherSecondIt, class = std::enable_if_t<
+				std::is_convertible_v<OtherFirstIt, FirstIt> && std::is_convertible_v<OtherSecondIt, SecondIt>>>
+			zip_iterator(const zip_iterator<OtherFirstIt, OtherSecondIt>& other)
+				: m_first(other.m_first)
+				, m_second(other.m_second) {}
+
+			FirstIt first() const { return m_first; }
+			SecondIt second() const { return m_second; }
+
+			reference operator*() const { return { *m_first, *m_second }; }
+			pointer operator->() const { return { **this }; }
+			reference operator[](difference_type n) const { return *(*this + n); }
+
+			zip_iterator& operator++() { ++m_first; ++m_second; return *this; }
+			zip_iterator operator++(int) { zip_iterator tmp(*this); ++*this; return tmp; }
+			zip_iterator& operator--() { --m_first; --m_second; return *this; }
+			zip_iterator operator--(int) { zip_iterator tmp(*this); --*this; return tmp; }
+
+			zip_iterator& operator+=(difference_type n) { m_first += n; m_second += n; return *this; }
+			zip_iterator& operator-=(difference_type n) { m_first -= n; m_second -= n; return *this; }
+			zip_iterator operator+(difference_type n) const { return zip_iterator(*this) += n; }
+			zip_iterator operator-(difference_type n) const { return zip_iterator(*this) -= n; }
+			friend zip_iterator operator+(difference_type n, const zip_iterator& it) { return it + n; }
+
+			template <class OtherFirstIt, class OtherSecondIt>
+			difference_type operator-(const zip_iterator<OtherFirstIt, OtherSecondIt>& other) const {
+				return m_first - other.m_first;
+			}
+
+			template <class OtherFirstIt, class OtherSecondIt>
+			bool operator==(const zip_iterator<OtherFirstIt, OtherSecondIt>& other) const { return m_first == other.m_first; }
+			template <class OtherFirstIt, class OtherSecondIt>
+			bool operator!=(const zip_iterator<OtherFirstIt, OtherSecondIt>& other) const { return m_first != other.m_first; }
+			template <class OtherFirstIt, class OtherSecondIt>
+			bool operator<(const zip_iterator<OtherFirstIt, OtherSecondIt>& other) const { return m_first < other.m_first; }
+			template <class OtherFirstIt, class OtherSecondIt>
+			bool operator>(const zip_iterator<OtherFirstIt, OtherSecondIt>& other) const { return m_first > other.m_first; }
+			template <class OtherFirstIt, class OtherSecondIt>
+			bool operator<=(const zip_iterator<OtherFirstIt, OtherSecondIt>& other) const { return m_first <= other.m_first; }
+			template <class OtherFirstIt, class OtherSecondIt>
+			bool operator>=(const zip_iterator<OtherFirstIt, OtherSecondIt>& other) const { return m_first >= other.m_first; }
+
+		private:
+			FirstIt m_first;
+			SecondIt m_second;
+		};
+
+	}
+}
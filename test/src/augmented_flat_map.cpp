@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <climits>
+#include <string>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include "../include/constants.hpp"
+#include <ancillary/container/augmented_flat_map.hpp>
+
+using sum_map_t = ancillary::augmented_flat_map<int, long long>;
+using min_map_t = ancillary::augmented_flat_map<int, int, ancillary::min_monoid<int>>;
+
+std::mt19937 gen{ std::random_device{}() };
+
+// Concatenation is associative but not commutative
+struct concat_monoid {
+	using value_type = std::string;
+	value_type identity() const { return {}; }
+	value_type operator()(const value_type& lhs, const value_type& rhs) const { return lhs + rhs; }
+};
+
+template <class Reference, class F>
+auto fold(const Reference& reference, int lo, int hi, typename std::decay_t<decltype(std::declval<F>()({}, {}))> init, F f) {
+	for (auto it = reference.lower_bound(lo); it != reference.end() && it->first < hi; ++it)
+		init = f(init, it->second);
+	return init;
+}
+
+TEST(AugmentedFlatMapTests, SumTests) {
+	sum_map_t map;
+	std::map<int, long long> reference;
+	auto plus = [](long long lhs, long long rhs) { return lhs + rhs; };
+	for (int round = 0; round < 20; ++round) {
+		for (int i = 0; i < static_cast<int>(N); ++i) {
+			int key = gen() % (20 * N);
+			long long value = gen() % 1000;
+			switch (gen() % 4) {
+			case 0:
+				ASSERT_EQ(reference.try_emplace(key, value).second, map.try_emplace(key, value).second);
+				break;
+			case 1:
+				ASSERT_EQ(reference.insert_or_assign(key, value).second, map.insert_or_assign(key, value).second);
+				break;
+			case 2:
+				ASSERT_EQ(reference.erase(key), map.erase(key));
+				break;
+			default:
+				ASSERT_EQ(reference.count(key) != 0, map.update(key, [&](long long& v) { v += value; }));
+				if (reference.count(key))
+					reference[key] += value;
+			}
+		}
+		ASSERT_TRUE(std::equal(map.begin(), map.end(), reference.begin(), reference.end(), [](const auto& lhs, const auto& rhs) {
+			return lhs.first == rhs.first && lhs.second == rhs.second;
+		}));
+		for (int lo = -3; lo < static_cast<int>(20 * N) + 3; lo += 7)
+			for (int hi = lo - 1; hi < static_cast<int>(20 * N) + 3; hi += 13)
+				ASSERT_EQ(fold(reference, lo, hi, 0LL, plus), map.aggregate(lo, hi));
+		ASSERT_FALSE(map.stale());
+		ASSERT_EQ(fold(reference, INT_MIN, INT_MAX, 0LL, plus), std::as_const(map).aggregate());
+	}
+}
+
+TEST(AugmentedFlatMapTests, AssignmentTests) {
+	std::vector<std::pair<int, int>> pairs;
+	for (int i = 0; i < 1000; ++i)
+		pairs.emplace_back(i, 1000 - i);
+	min_map_t map(pairs.begin(), pairs.end());
+	ASSERT_TRUE(map.stale());
+	ASSERT_EQ(1, map.aggregate());
+	ASSERT_EQ(500, map.aggregate(0, 501));
+	ASSERT_EQ(std::numeric_limits<int>::max(), map.aggregate(10, 10));
+
+	// Assignments to existing keys keep the index current
+	ASSERT_FALSE(map.insert_or_assign(250, -7).second);
+	ASSERT_FALSE(map.stale());
+	ASSERT_EQ(-7, std::as_const(map).aggregate(0, 501));
+	ASSERT_EQ(500, std::as_const(map).aggregate(251, 501));
+	ASSERT_TRUE(map.update(999, [](int& v) { v = -9; }));
+	ASSERT_EQ(-9, std::as_const(map).aggregate());
+
+	map.erase(999);
+	ASSERT_TRUE(map.stale());
+	// A const aggregate over a stale index folds the values directly
+	ASSERT_EQ(-7, std::as_const(map).aggregate());
+	ASSERT_EQ(500, std::as_const(map).aggregate(251, 501));
+	ASSERT_TRUE(map.try_emplace(-1, -20).second);
+	ASSERT_EQ(-20, std::as_const(map).aggregate(-1, 0));
+	ASSERT_TRUE(map.stale());
+	ASSERT_EQ(-7, map.aggregate(0, 1000));
+	ASSERT_FALSE(map.stale());
+	map.erase(-1);
+	ASSERT_EQ(-7, map.aggregate());
+	map.clear();
+	ASSERT_TRUE(map.empty());
+	ASSERT_EQ(std::numeric_limits<int>::max(), std::as_const(map).aggregate());
+}
+
+TEST(AugmentedFlatMapTests, NonCommutativeTests) {
+	ancillary::augmented_flat_map<int, std::string, concat_monoid> map;
+	std::string letters = "abcdefghijklmnopqrstuvwxyz";
+	std::vector<int> keys(letters.size());
+	std::iota(keys.begin(), keys.end(), 0);
+	std::shuffle(keys.begin(), keys.end(), gen);
+	for (int key : keys)
+		map.try_emplace(key, std::string(1, letters[key]));
+	for (int lo = 0; lo <= 26; ++lo)
+		for (int hi = lo; hi <= 26; ++hi)
+			ASSERT_EQ(letters.substr(lo, hi - lo), map.aggregate(lo, hi));
+	map.insert_or_assign(3, "D");
+	ASSERT_EQ("abcDe", std::as_const(map).aggregate(0, 5));
+}
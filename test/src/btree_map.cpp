@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <set>
+#include <random>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include "../include/constants.hpp"
+#include <ancillary/container/btree_set.hpp>
+#include <ancillary/container/btree_map.hpp>
+
+using set_t = ancillary::btree_set<int>;
+using map_t = ancillary::btree_map<int, std::string>;
+
+std::mt19937 gen{ std::random_device{}() };
+
+template <class Container, class Reference>
+bool same_elements(const Container& container, const Reference& reference) {
+	return container.size() == reference.size()
+		&& std::equal(container.begin(), container.end(), reference.begin(), reference.end(), [](const auto& lhs, const auto& rhs) {
+			return lhs == typename Container::value_type(rhs);
+		});
+}
+
+TEST(BTreeSetTests, ConstructorTests) {
+	set_t s1;
+	ASSERT_TRUE(s1.empty());
+	ASSERT_EQ(s1.begin(), s1.end());
+
+	std::vector<int> values(2000 * N);
+	std::generate(values.begin(), values.end(), [] { return static_cast<int>(gen() % (1000 * N)); });
+	set_t s2(values.begin(), values.end());
+	std::set<int> reference(values.begin(), values.end());
+	ASSERT_TRUE(same_elements(s2, reference));
+	ASSERT_LT(0, s2.height());
+
+	set_t s3{ 3, 1, 2, 1 };
+	ASSERT_EQ(3, s3.size());
+	set_t s4(ancillary::sorted_unique, reference.begin(), reference.end());
+	ASSERT_EQ(s2, s4);
+
+	set_t copier(s4);
+	ASSERT_EQ(s4, copier);
+	set_t thief(std::move(copier));
+	ASSERT_EQ(s4, thief);
+	ASSERT_TRUE(copier.empty());
+	copier = thief;
+	ASSERT_EQ(thief, copier);
+	s3 = { 5, 4 };
+	ASSERT_EQ((std::vector<int>{ 4, 5 }), std::vector<int>(s3.begin(), s3.end()));
+}
+
+TEST(BTreeSetTests, ModifierTests) {
+	set_t set;
+	std::set<int> reference;
+	for (int i = 0; i < 1000 * static_cast<int>(N); ++i) {
+		int value = gen() % (500 * N);
+		auto [it, inserted] = set.insert(value);
+		ASSERT_EQ(reference.insert(value).second, inserted);
+		ASSERT_EQ(value, *it);
+	}
+	ASSERT_TRUE(same_elements(set, reference));
+	ASSERT_TRUE(std::equal(set.rbegin(), set.rend(), reference.rbegin(), reference.rend()));
+
+	// Ascending and descending runs keep splitting the outermost leaves
+	for (int i = 0; i < 20000; ++i) {
+		ASSERT_EQ(reference.insert(1000000 + i).second, set.insert(1000000 + i).second);
+		ASSERT_EQ(reference.insert(-i).second, set.insert(-i).second);
+	}
+	ASSERT_TRUE(same_elements(set, reference));
+
+	while (!reference.empty()) {
+		auto ref = std::next(reference.begin(), gen() % std::min<std::size_t>(reference.size(), 64));
+		if (gen() % 2)
+			ref = std::prev(reference.end(), 1 + gen() % std::min<std::size_t>(reference.size(), 64));
+		auto next = set.erase(set.find(*ref));
+		ref = reference.erase(ref);
+		if (ref == reference.end()) {
+			ASSERT_EQ(set.end(), next);
+		}
+		else {
+			ASSERT_EQ(*ref, *next);
+		}
+		if (reference.size() % 997 == 0) {
+			ASSERT_TRUE(same_elements(set, reference));
+		}
+	}
+	ASSERT_TRUE(set.empty());
+	ASSERT_EQ(set.begin(), set.end());
+	ASSERT_EQ(0, set.height());
+	ASSERT_EQ(0, set.erase(5));
+
+	for (int i = 0; i < 5000; ++i)
+		set.insert(i);
+	auto it = set.erase(set.find(100), set.find(4900));
+	ASSERT_EQ(4900, *it);
+	ASSERT_EQ(200, set.size());
+	for (int i = 0; i < 5000; ++i)
+		ASSERT_EQ(i < 100 || i >= 4900, set.erase(i) == 1);
+	ASSERT_TRUE(set.empty());
+}
+
+TEST(BTreeSetTests, LookupTests) {
+	set_t set;
+	for (int i = 0; i < 100000; ++i)
+		set.insert(3 * ((i * 7919) % 100000));
+	for (int key = -5; key < 300005; key += 7) {
+		auto lower = set.lower_bound(key);
+		int expected_lower = key <= 0 ? 0 : (key + 2) / 3 * 3;
+		if (expected_lower > 299997) {
+			ASSERT_EQ(set.end(), lower);
+		}
+		else {
+			ASSERT_EQ(expected_lower, *lower);
+		}
+		auto upper = set.upper_bound(key);
+		int expected_upper = key < 0 ? 0 : key / 3 * 3 + 3;
+		if (expected_upper > 299997) {
+			ASSERT_EQ(set.end(), upper);
+		}
+		else {
+			ASSERT_EQ(expected_upper, *upper);
+		}
+		ASSERT_EQ(key >= 0 && key % 3 == 0 && key <= 299997, set.contains(key));
+		auto [first, last] = set.equal_range(key);
+		ASSERT_EQ(set.count(key), static_cast<std::size_t>(std::distance(first, last)));
+	}
+}
+
+TEST(BTreeMapTests, MapTests) {
+	map_t map;
+	std::map<int, std::string> reference;
+	for (int i = 0; i < 1000 * static_cast<int>(N); ++i) {
+		int key = gen() % (500 * N);
+		switch (i % 3) {
+		case 0:
+			ASSERT_EQ(reference.try_emplace(key, std::to_string(i)).second, map.try_emplace(key, std::to_string(i)).second);
+			break;
+		case 1:
+			ASSERT_EQ(reference.insert_or_assign(key, std::to_string(i)).second, map.insert_or_assign(key, std::to_string(i)).second);
+			break;
+		default:
+			reference[key] += "x";
+			map[key] += "x";
+		}
+	}
+	ASSERT_TRUE(same_elements(map, reference));
+	ASSERT_EQ(reference.begin()->second, map.at(reference.begin()->first));
+	ASSERT_THROW(map.at(-1), std::out_of_range);
+
+	map_t other(reference.begin(), reference.end());
+	ASSERT_EQ(map, other);
+	other.begin()->second = "changed";
+	ASSERT_NE(map, other);
+	std::swap(map, other);
+	ASSERT_EQ("changed", map.begin()->second);
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "../include/constants.hpp"
+#include <ancillary/container/buffered_flat_map.hpp>
+
+using map_t = ancillary::buffered_flat_map<int, std::string>;
+using flat_map_t = ancillary::flat_map<int, std::string>;
+using pair_t = std::pair<int, std::string>;
+
+std::mt19937 gen{ std::random_device{}() };
+
+std::vector<int> shuffled_keys(int size) {
+	std::vector<int> keys(size);
+	std::generate(keys.begin(), keys.end(), [n = 0]() mutable { return 2 * n++; });
+	std::shuffle(keys.begin(), keys.end(), gen);
+	return keys;
+}
+
+TEST(BufferedFlatMapTests, ConstructorTests) {
+	map_t m1;
+	ASSERT_TRUE(m1.empty());
+	ASSERT_EQ(0, m1.pending());
+	ASSERT_EQ(m1.begin(), m1.end());
+
+	map_t m2{ {3, "c"}, {1, "a"}, {2, "b"}, {1, "z"} };
+	ASSERT_EQ(3, m2.size());
+	ASSERT_EQ(0, m2.pending());
+	ASSERT_EQ("a", m2.at(1));
+
+	map_t m3(flat_map_t{ {1, "a"}, {2, "b"}, {3, "c"} }, 4);
+	ASSERT_EQ(4, m3.min_buffer_size());
+	ASSERT_EQ(4, m3.buffer_size());
+	ASSERT_EQ(m2, m3);
+
+	map_t copier(m3);
+	ASSERT_EQ(m3, copier);
+	map_t thief(std::move(copier));
+	ASSERT_EQ(m3, thief);
+}
+
+TEST(BufferedFlatMapTests, InsertionTests) {
+	map_t map(std::less<int>(), std::allocator<pair_t>(), 4 * N);
+	flat_map_t reference;
+	for (int key : shuffled_keys(10 * N)) {
+		ASSERT_TRUE(map.insert({ key, std::to_string(key) }));
+		reference.insert({ key, std::to_string(key) });
+		ASSERT_FALSE(map.insert({ key, "duplicate" }));
+		ASSERT_LE(map.pending(), map.buffer_size());
+	}
+	ASSERT_EQ(reference.size(), map.size());
+	ASSERT_GT(map.pending(), 0);
+	for (const auto& [key, value] : reference) {
+		ASSERT_TRUE(map.contains(key));
+		ASSERT_EQ(value, map.at(key));
+	}
+	ASSERT_FALSE(map.contains(1));
+	ASSERT_THROW(map.at(1), std::out_of_range);
+
+	map.flush();
+	ASSERT_EQ(0, map.pending());
+	ASSERT_EQ(reference, map.body());
+	ASSERT_TRUE(std::equal(map.begin(), map.end(), reference.begin(), reference.end()));
+}
+
+TEST(BufferedFlatMapTests, UpsertTests) {
+	map_t map;
+	ASSERT_TRUE(map.try_emplace(5, 3, 'x'));
+	ASSERT_FALSE(map.try_emplace(5, "five"));
+	ASSERT_EQ("xxx", map[5]);
+	ASSERT_FALSE(map.insert_or_assign(5, "five"));
+	ASSERT_TRUE(map.insert_or_assign(6, "six"));
+	ASSERT_TRUE(map.emplace(7, "seven"));
+	map[8] = "eight";
+	map[5] += "!";
+	ASSERT_EQ(4, map.size());
+	ASSERT_EQ(4, map.pending());
+	ASSERT_EQ("five!", map.at(5));
+
+	map.flush();
+	map[5] = "cinq";
+	ASSERT_TRUE(map.insert_or_assign(9, "nine"));
+	ASSERT_EQ("cinq", map.at(5));
+	ASSERT_EQ("nine", map.at(9));
+	ASSERT_EQ(5, (map.end() - map.begin()));
+}
+
+TEST(BufferedFlatMapTests, ErasureTests) {
+	map_t map;
+	for (int key : shuffled_keys(N))
+		map.insert({ key, std::to_string(key) });
+	map.flush();
+	map.insert({ 1, "one" });
+	map.insert({ 3, "three" });
+	ASSERT_EQ(2, map.pending());
+
+	ASSERT_EQ(1, map.erase(1));
+	ASSERT_EQ(0, map.erase(1));
+	ASSERT_EQ(1, map.pending());
+	ASSERT_EQ(1, map.erase(0));
+	ASSERT_FALSE(map.contains(0));
+	ASSERT_TRUE(map.contains(3));
+	ASSERT_EQ(N, map.size());
+
+	map.clear();
+	ASSERT_TRUE(map.empty());
+}
+
+TEST(BufferedFlatMapTests, ConstIterationTests) {
+	map_t map(std::less<int>(), std::allocator<pair_t>(), N);
+	flat_map_t reference;
+	for (int key : shuffled_keys(3 * N / 2)) {
+		map.insert({ key, std::to_string(key) });
+		reference.insert({ key, std::to_string(key) });
+	}
+	ASSERT_GT(map.pending(), 0);
+	const map_t& cmap = map;
+	ASSERT_TRUE(std::equal(cmap.begin(), cmap.end(), reference.begin(), reference.end()));
+	ASSERT_TRUE(std::equal(cmap.rbegin(), cmap.rend(), reference.rbegin(), reference.rend()));
+	ASSERT_EQ(reference.size(), std::distance(cmap.begin(), cmap.end()));
+
+	// Equal bodies with different pending elements
+	map_t lhs(flat_map_t{ {1, "a"}, {2, "b"} });
+	map_t rhs(lhs);
+	lhs.insert({ 3, "c" });
+	rhs.insert({ 4, "d" });
+	ASSERT_EQ(lhs.body(), rhs.body());
+	ASSERT_NE(lhs, rhs);
+	rhs.erase(4);
+	rhs.insert({ 3, "c" });
+	rhs.flush();
+	ASSERT_EQ(lhs, rhs);
+}
+
+TEST(BufferedFlatMapTests, BufferGrowthTests) {
+	// The flush threshold follows the square root of the body once past the minimum
+	map_t map(std::less<int>(), std::allocator<pair_t>(), 4);
+	for (int key : shuffled_keys(100 * N)) {
+		map.insert({ key, std::to_string(key) });
+		ASSERT_LE(map.pending(), map.buffer_size());
+	}
+	map.flush();
+	ASSERT_EQ(4, map.min_buffer_size());
+	ASSERT_GT(map.buffer_size(), map.min_buffer_size());
+	ASSERT_GE(map.buffer_size() * map.buffer_size(), map.size());
+}
+
+TEST(BufferedFlatMapTests, LookupTests) {
+	map_t map(std::less<int>(), std::allocator<pair_t>(), N);
+	flat_map_t reference;
+	for (int key : shuffled_keys(3 * N / 2)) {
+		map.insert({ 2 * key, std::to_string(key) });
+		reference.insert({ 2 * key, std::to_string(key) });
+	}
+	ASSERT_GT(map.pending(), 0);
+	const map_t& cmap = map;
+	for (int key = -1; key <= 3 * static_cast<int>(N) + 1; ++key) {
+		auto it = cmap.find(key);
+		auto ref = reference.find(key);
+		ASSERT_EQ(ref == reference.end(), it == cmap.cend());
+		if (ref != reference.end()) {
+			ASSERT_EQ(*ref, *it);
+		}
+		ASSERT_EQ(reference.lower_bound(key) - reference.begin(), std::distance(cmap.begin(), cmap.lower_bound(key)));
+		ASSERT_EQ(reference.upper_bound(key) - reference.begin(), std::distance(cmap.begin(), cmap.upper_bound(key)));
+		auto [first, last] = cmap.equal_range(key);
+		ASSERT_EQ(cmap.lower_bound(key), first);
+		ASSERT_EQ(cmap.upper_bound(key), last);
+		ASSERT_TRUE(std::equal(first, cmap.end(), reference.lower_bound(key), reference.end()));
+	}
+}
+
+TEST(BufferedFlatMapTests, TransparentCompareTests) {
+	ancillary::buffered_flat_map<std::string, int, std::less<>> map;
+	map.insert({ "a", 1 });
+	ASSERT_TRUE(map.contains("a"));
+	ASSERT_EQ(1, map.count("a"));
+	ASSERT_FALSE(map.contains("b"));
+	ASSERT_EQ(1, map.find("a")->second);
+	ASSERT_EQ(map.cend(), map.find("b"));
+	ASSERT_EQ(map.cend(), map.lower_bound("b"));
+}
@@ -2,6 +2,8 @@
 #include <deque>
 #include <vector>
 #include <random>
+#include <sstream>
+#include <iterator>
 #include <algorithm>
 #include "../include/constants.hpp"
 #include <ancillary/container/deque.hpp>
@@ -357,6 +359,51 @@ TEST(DequeTests, ErasureTests) {
 	ASSERT_EQ(deque[0], 4);
 	ASSERT_EQ(deque[1], 5);
 	ASSERT_EQ(deque[2], 6);
+
+	it = deque.erase(deque.begin(), deque.end());
+	ASSERT_EQ(it, deque.end());
+	ASSERT_TRUE(deque.empty());
+	ASSERT_EQ(deque.begin(), deque.end());
+
+	deque = { 1, 2 };
+	deque.pop_front();
+	deque.pop_back();
+	ASSERT_TRUE(deque.empty());
+	ASSERT_EQ(deque.begin(), deque.end());
+}
+
+TEST(DequeTests, RangeInsertionTests) {
+	std::istringstream input("3 4 5");
+	deque_t deque{ 1, 2, 6, 7 };
+
+	auto it = deque.insert(deque.begin() + 2, std::istream_iterator<int>(input), std::istream_iterator<int>());
+	ASSERT_EQ(*it, 3);
+	ASSERT_EQ(deque.size(), 7);
+	for (int i = 0; i < 7; ++i)
+		ASSERT_EQ(deque[i], i + 1);
+
+	deque.erase(deque.begin() + 1, deque.begin() + 6);
+	ASSERT_EQ(deque.size(), 2);
+	ASSERT_EQ(deque.front(), 1);
+	ASSERT_EQ(deque.back(), 7);
+
+	// Ranges inserted near either end, including single-pass ones grown from the front
+	for (int off = 0; off <= N; ++off) {
+		deque_t grown;
+		std::deque<int> reference;
+		for (int i = 0; i < N; ++i) {
+			grown.push_back(i);
+			reference.push_back(i);
+		}
+		std::vector<int> values{ -1, -2, -3, -4, -5 };
+		std::ostringstream text;
+		std::copy(values.begin(), values.end(), std::ostream_iterator<int>(text, " "));
+		std::istringstream range(text.str());
+		it = grown.insert(grown.begin() + off, std::istream_iterator<int>(range), std::istream_iterator<int>());
+		reference.insert(reference.begin() + off, values.begin(), values.end());
+		ASSERT_EQ(off, it - grown.begin());
+		ASSERT_TRUE(std::equal(grown.begin(), grown.end(), reference.begin(), reference.end()));
+	}
 }
 
 TEST(DequeTests, ResizingTests) {
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <random>
+#include <string>
 #include <vector>
+#include <cstdint>
 #include <algorithm>
 #include "../include/constants.hpp"
 #include <ancillary/container/flat_map.hpp>
@@ -293,6 +295,100 @@ TEST(FlatMapTests, InsertOrAssignTests) {
 	}
 }
 
+struct counted {
+	static inline int constructions = 0;
+	int value;
+	counted(int v) : value(v) { ++constructions; }
+	counted(const counted& other) : value(other.value) {}
+	counted(counted&& other) noexcept : value(other.value) {}
+	counted& operator=(const counted&) = default;
+	counted& operator=(counted&&) = default;
+};
+
+TEST(FlatMapTests, UpsertConstructionTests) {
+	ancillary::flat_map<int, counted> map;
+	for (int i = 0; i < N; ++i)
+		map.try_emplace(2 * i, i);
+	ASSERT_EQ(N, counted::constructions);
+
+	// Existing keys never construct a mapped value
+	for (int i = 0; i < N; ++i) {
+		ASSERT_FALSE(map.try_emplace(2 * i, -1).second);
+		ASSERT_FALSE(map.try_emplace(map.begin(), 2 * i, -1)->second.value < 0);
+		ASSERT_EQ(i, map.at(2 * i).value);
+	}
+	ASSERT_EQ(N, counted::constructions);
+
+	auto ret = map.insert_or_assign(1, counted(7));
+	ASSERT_TRUE(ret.second);
+	ASSERT_EQ(1, ret.first->first);
+	ASSERT_EQ(7, map.at(1).value);
+	ASSERT_EQ(N + 1, counted::constructions);
+	ASSERT_FALSE(map.insert_or_assign(1, counted(8)).second);
+	ASSERT_EQ(8, map.at(1).value);
+	ASSERT_TRUE(std::is_sorted(map.begin(), map.end(), map.value_comp()));
+}
+
+TEST(FlatMapTests, ParallelConstructionTests) {
+	// Every key appears four times, and the first occurrence must win
+	const int n = 1 << 16;
+	std::vector<pair_t> pairs;
+	for (int i = 0; i < 4 * n; ++i)
+		pairs.emplace_back(i % n, i);
+	std::shuffle(pairs.begin(), pairs.end(), gen);
+
+	map_t expected(pairs.begin(), pairs.end());
+	map_t map(ancillary::execution::parallel_policy{ 4 }, pairs.begin(), pairs.end());
+	ASSERT_EQ(std::size_t(n), map.size());
+	ASSERT_EQ(expected, map);
+	std::vector<int> firsts(n, -1);
+	for (const auto& pair : pairs)
+		if (firsts[pair.first] < 0)
+			firsts[pair.first] = pair.second;
+	for (int i = 0; i < n; ++i)
+		ASSERT_EQ(firsts[i], map.at(i));
+}
+
+TEST(FlatMapTests, SortedUniqueTests) {
+	std::vector<pair_t> pairs(N);
+	std::generate(pairs.begin(), pairs.end(), [n = 0]() mutable {
+		auto value = n++;
+		return std::make_pair(value, value);
+	});
+
+	map_t m1(ancillary::sorted_unique, pairs.begin(), pairs.end());
+	ASSERT_EQ(N, m1.size());
+	ASSERT_TRUE(std::equal(m1.begin(), m1.end(), pairs.begin(), pairs.end()));
+
+	// Keys already in the map keep their mapped value
+	std::vector<pair_t> more{ {0, -1}, {N, N}, {N + 1, N + 1} };
+	m1.insert(ancillary::sorted_unique, more.begin(), more.end());
+	ASSERT_EQ(N + 2, m1.size());
+	ASSERT_EQ(0, m1.at(0));
+	ASSERT_EQ(N + 1, m1.at(N + 1));
+	ASSERT_TRUE(std::is_sorted(m1.begin(), m1.end(), m1.value_comp()));
+}
+
+TEST(FlatMapTests, ExtractReplaceTests) {
+	std::vector<pair_t> pairs(N);
+	std::generate(pairs.begin(), pairs.end(), [n = 0]() mutable {
+		auto value = n++;
+		return std::make_pair(value, value);
+	});
+	map_t m1(pairs.begin(), pairs.end());
+
+	// Build the replacement storage elsewhere and install it with a move
+	map_t::container_type next(m1.begin(), m1.end());
+	for (auto& pair : next)
+		pair.second *= 2;
+	auto old = std::move(m1).extract();
+	m1.replace(std::move(next));
+	ASSERT_EQ(pairs, old);
+	ASSERT_EQ(N, m1.size());
+	for (int i = 0; i < N; ++i)
+		ASSERT_EQ(2 * i, m1.at(i));
+}
+
 TEST(FlatMapTests, ErasureTests) {
 	map_t map;
 	std::vector<int> integers;
@@ -332,6 +428,38 @@ TEST(FlatMapTests, LookupTests) {
 	}
 }
 
+template <class Map>
+void check_bounds(const Map& map, typename Map::key_type key) {
+	auto comp = map.value_comp();
+	typename Map::value_type probe{ key, {} };
+	ASSERT_EQ(std::lower_bound(map.begin(), map.end(), probe, comp), map.lower_bound(key));
+	ASSERT_EQ(std::upper_bound(map.begin(), map.end(), probe, comp), map.upper_bound(key));
+	ASSERT_EQ(std::binary_search(map.begin(), map.end(), probe, comp), map.contains(key));
+}
+
+TEST(FlatMapTests, SimdSearchTests) {
+	// Pairs that tile a vector register two or four at a time, padded pairs and pairs
+	// too wide to tile it at all
+	for (int size = 0; size < 8 * static_cast<int>(N); size += 7) {
+		ancillary::flat_map<std::uint64_t, std::uint64_t> u64;
+		ancillary::flat_map<std::uint32_t, std::uint32_t, std::less<>> u32;
+		ancillary::flat_map<std::int32_t, double> i32;
+		ancillary::flat_map<double, std::string> f64;
+		for (int i = 0; i < size; ++i) {
+			u64.emplace((std::uint64_t(1) << 63) + 3 * (i - size / 2), i);
+			u32.emplace(std::uint32_t(1u << 31) + 3 * (i - size / 2), i);
+			i32.emplace(3 * (i - size / 2), i);
+			f64.emplace(1.5 * (i - size / 2), std::to_string(i));
+		}
+		for (int i = -2 - size / 2; i < size; ++i) {
+			check_bounds(u64, (std::uint64_t(1) << 63) + i);
+			check_bounds(u32, std::uint32_t(1u << 31) + i);
+			check_bounds(i32, i);
+			check_bounds(f64, 0.5 * i);
+		}
+	}
+}
+
 TEST(FlatMapTests, LexicographicalTests) {
 	ASSERT_EQ(map_t({ {1, 1}, {2, 2}, {3, 3} }), map_t({ {1, 1}, {2, 2}, {3, 3} }));
 	ASSERT_LE(map_t({ {1, 1}, {2, 2}, {3, 3} }), map_t({ {2, 3}, {3, 8}, {4, 3} }));
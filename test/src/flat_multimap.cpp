@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <random>
 #include <vector>
+#include <numeric>
 #include <algorithm>
 #include "../include/constants.hpp"
 #include <ancillary/container/flat_multimap.hpp>
@@ -215,6 +216,52 @@ TEST(FlatMultimapTests, InsertionTests) {
 	}
 }
 
+TEST(FlatMultimapTests, RangeInsertionTests) {
+	// Setup
+	std::vector<pair_t> pairs;
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < N; ++j) {
+			pairs.emplace_back(std::make_pair(i, j));
+		}
+	}
+	std::vector<pair_t> first(pairs.begin(), pairs.begin() + pairs.size() / 2);
+	std::vector<pair_t> second(pairs.begin() + pairs.size() / 2, pairs.end());
+	std::shuffle(first.begin(), first.end(), gen);
+	std::shuffle(second.begin(), second.end(), gen);
+	for (auto& pair : first)
+		std::swap(pair.first, pair.second);
+	for (auto& pair : second)
+		std::swap(pair.first, pair.second);
+
+	// Values with equivalent keys inserted by a later range follow the earlier ones
+	multimap_t multimap(first.begin(), first.end());
+	multimap.insert(second.begin(), second.end());
+	ASSERT_EQ(pairs.size(), multimap.size());
+	ASSERT_TRUE(std::is_sorted(multimap.begin(), multimap.end(), multimap.value_comp()));
+	for (int i = 0; i < N; ++i) {
+		auto range = multimap.equal_range(i);
+		ASSERT_EQ(N, range.second - range.first);
+		ASSERT_TRUE(std::all_of(range.first, range.first + N / 2, [](const pair_t& p) { return p.second < N / 2; }));
+		ASSERT_TRUE(std::all_of(range.first + N / 2, range.second, [](const pair_t& p) { return p.second >= N / 2; }));
+	}
+}
+
+TEST(FlatMultimapTests, SortedEquivalentTests) {
+	std::vector<pair_t> pairs(N);
+	std::generate(pairs.begin(), pairs.end(), [n = 0]() mutable { return std::make_pair(0, n++); });
+
+	multimap_t mm(ancillary::sorted_equivalent, pairs.begin(), pairs.end());
+	ASSERT_EQ(N, mm.count(0));
+	ASSERT_TRUE(std::equal(mm.begin(), mm.end(), pairs.begin(), pairs.end()));
+
+	// Equivalent elements from the inserted range follow the existing ones
+	std::vector<pair_t> more(N);
+	std::generate(more.begin(), more.end(), [n = N]() mutable { return std::make_pair(0, n++); });
+	mm.insert(ancillary::sorted_equivalent, more.begin(), more.end());
+	ASSERT_EQ(2 * N, mm.count(0));
+	ASSERT_TRUE(std::is_sorted(mm.begin(), mm.end(), secondary_compare()));
+}
+
 TEST(FlatMultimapTests, ErasureTests) {
 	// setup
 	std::vector<pair_t> pairs;
@@ -266,6 +313,113 @@ TEST(FlatMultimapTests, LookupTests) {
 	}
 }
 
+TEST(FlatMultimapTests, BranchlessSearchTests) {
+	using branchless_multimap_t = ancillary::flat_multimap<int, int, std::less<int>,
+		std::allocator<pair_t>, ancillary::branchless_search_policy>;
+	std::vector<pair_t> pairs;
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < i % 4; ++j) {
+			pairs.emplace_back(std::make_pair(2 * i, j));
+		}
+	}
+	std::shuffle(pairs.begin(), pairs.end(), gen);
+	branchless_multimap_t multimap(pairs.begin(), pairs.end());
+	ASSERT_EQ(pairs.size(), multimap.size());
+	ASSERT_TRUE(std::is_sorted(multimap.begin(), multimap.end(), multimap.value_comp()));
+	for (int i = -1; i <= 2 * N; ++i) {
+		auto range = multimap.equal_range(i);
+		ASSERT_EQ(i >= 0 && i % 2 == 0 ? (i / 2) % 4 : 0, range.second - range.first);
+		ASSERT_EQ(static_cast<std::size_t>(range.second - range.first), multimap.count(i));
+		ASSERT_TRUE(std::all_of(range.first, range.second, [i](const pair_t& p) { return p.first == i; }));
+		ASSERT_EQ(range.first - multimap.begin(), std::count_if(multimap.begin(), multimap.end(), [i](const pair_t& p) { return p.first < i; }));
+	}
+}
+
+TEST(FlatMultimapTests, FindManyTests) {
+	std::vector<pair_t> pairs;
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < i % 4; ++j) {
+			pairs.emplace_back(std::make_pair(2 * i, j));
+		}
+	}
+	std::shuffle(pairs.begin(), pairs.end(), gen);
+	multimap_t multimap(pairs.begin(), pairs.end());
+
+	std::vector<int> probes(2 * N + 2);
+	std::iota(probes.begin(), probes.end(), -1);
+	std::vector<multimap_t::iterator> found(probes.size());
+	ASSERT_EQ(found.end(), multimap.find_many(probes.begin(), probes.end(), found.begin()));
+	for (std::size_t i = 0; i < probes.size(); ++i)
+		ASSERT_EQ(multimap.find(probes[i]), found[i]);
+
+	std::shuffle(probes.begin(), probes.end(), gen);
+	std::vector<bool> contained;
+	multimap.contains_many(probes.begin(), probes.end(), std::back_inserter(contained));
+	for (std::size_t i = 0; i < probes.size(); ++i)
+		ASSERT_EQ(multimap.contains(probes[i]), contained[i]);
+}
+
+TEST(FlatMultimapTests, MergeTests) {
+	std::vector<pair_t> lhs_pairs, rhs_pairs;
+	for (int i = 0; i < N; ++i) {
+		lhs_pairs.emplace_back(std::make_pair(i % 7, i));
+		rhs_pairs.emplace_back(std::make_pair(i % 5, -i));
+	}
+	multimap_t lhs(lhs_pairs.begin(), lhs_pairs.end());
+	multimap_t rhs(rhs_pairs.begin(), rhs_pairs.end());
+
+	std::vector<pair_t> expected;
+	std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected), lhs.value_comp());
+	lhs.merge(rhs);
+	ASSERT_TRUE(rhs.empty());
+	ASSERT_TRUE(std::equal(lhs.begin(), lhs.end(), expected.begin(), expected.end()));
+
+	multimap_t small{ {3, 1}, {3, 2}, {9, 0} };
+	expected.clear();
+	std::set_intersection(lhs.begin(), lhs.end(), small.begin(), small.end(), std::back_inserter(expected), lhs.value_comp());
+	auto result = ancillary::set_intersection(lhs, small);
+	ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+}
+
+TEST(FlatMultimapTests, BulkErasureTests) {
+	std::vector<pair_t> pairs;
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < i % 4; ++j) {
+			pairs.emplace_back(std::make_pair(i, j));
+		}
+	}
+	std::shuffle(pairs.begin(), pairs.end(), gen);
+	multimap_t multimap(pairs.begin(), pairs.end());
+
+	std::vector<int> keys;
+	for (int i = 0; i < N; i += 3)
+		keys.push_back(i);
+	std::size_t expected = std::count_if(pairs.begin(), pairs.end(), [](const pair_t& p) { return p.first % 3 == 0; });
+	ASSERT_EQ(expected, multimap.erase(ancillary::sorted_equivalent, keys.begin(), keys.end()));
+	ASSERT_EQ(pairs.size() - expected, multimap.size());
+	ASSERT_TRUE(std::none_of(multimap.begin(), multimap.end(), [](const pair_t& p) { return p.first % 3 == 0; }));
+	ASSERT_TRUE(std::is_sorted(multimap.begin(), multimap.end(), multimap.value_comp()));
+
+	std::size_t seconds = std::count_if(multimap.begin(), multimap.end(), [](const pair_t& p) { return p.second == 1; });
+	ASSERT_EQ(seconds, ancillary::erase_if(multimap, [](const pair_t& p) { return p.second == 1; }));
+	ASSERT_EQ(2, multimap.count(7));
+}
+
+TEST(FlatMultimapTests, ParallelConstructionTests) {
+	// Equivalent keys must keep their insertion order
+	const int n = 1 << 18;
+	std::vector<pair_t> pairs(n);
+	for (int i = 0; i < n; ++i)
+		pairs[i] = { i % 1000, i };
+	std::shuffle(pairs.begin(), pairs.end(), gen);
+
+	multimap_t expected(pairs.begin(), pairs.end());
+	for (std::size_t threads : { 2, 5, 8 }) {
+		multimap_t multimap(ancillary::execution::parallel_policy{ threads }, pairs.begin(), pairs.end());
+		ASSERT_EQ(expected, multimap);
+	}
+}
+
 TEST(FlatMultimapTests, LexicographicalTests) {
 	ASSERT_EQ(multimap_t({ {0, 0}, {1, 1}, {2, 2} }), multimap_t({ {0, 0}, {1, 1}, {2, 2} }));
 	ASSERT_LE(multimap_t({ {0, 0}, {1, 1}, {2, 2} }), multimap_t({ {1, 2}, {2, 5} }));
@@ -206,6 +206,32 @@ TEST(FlatMultisetTests, InsertionTests) {
 		ASSERT_EQ(N, multiset.count(std::pair(i, i)));
 }
 
+TEST(FlatMultisetTests, SortedEquivalentTests) {
+	std::vector<pair_t> pairs;
+	for (int i = 1; i <= N; ++i) {
+		for (int j = 1; j <= N; ++j) {
+			pairs.emplace_back(std::pair(i, j));
+		}
+	}
+
+	multiset_t ms(ancillary::sorted_equivalent, pairs.begin(), pairs.end());
+	ASSERT_EQ(pairs.size(), ms.size());
+	ASSERT_TRUE(std::equal(ms.begin(), ms.end(), pairs.begin(), pairs.end()));
+
+	// Equivalent elements from the inserted range follow the existing ones
+	std::vector<pair_t> more;
+	for (int i = 1; i <= N; ++i)
+		more.emplace_back(std::pair(i, N + 1));
+	ms.insert(ancillary::sorted_equivalent, more.begin(), more.end());
+	ASSERT_EQ(pairs.size() + more.size(), ms.size());
+	ASSERT_TRUE(std::is_sorted(ms.begin(), ms.end(), ms.value_comp()));
+	for (int i = 1; i <= N; ++i) {
+		auto range = ms.equal_range(std::pair(i, 0));
+		ASSERT_EQ(N + 1, range.second - range.first);
+		ASSERT_TRUE(std::is_sorted(range.first, range.second, secondary_compare()));
+	}
+}
+
 TEST(FlatMultisetTests, ErasureTests) {
 	std::vector<pair_t> pairs;
 	for (int i = 1; i <= N; ++i) {
@@ -255,6 +281,56 @@ TEST(FlatMultisetTests, LookupTests) {
 	}
 }
 
+// Forwards to binary search while counting the searches it serves
+struct counting_search_policy {
+	static inline std::size_t searches = 0;
+
+	template <class RndIt, class Key, class Compare, class ExtractKey>
+	static RndIt lower_bound(RndIt first, RndIt last, const Key& key, const Compare& comp, const ExtractKey& ext) {
+		++searches;
+		return ancillary::binary_search_policy::lower_bound(first, last, key, comp, ext);
+	}
+
+	template <class RndIt, class Key, class Compare, class ExtractKey>
+	static RndIt upper_bound(RndIt first, RndIt last, const Key& key, const Compare& comp, const ExtractKey& ext) {
+		++searches;
+		return ancillary::binary_search_policy::upper_bound(first, last, key, comp, ext);
+	}
+};
+
+template <class SearchPolicy>
+void check_equal_ranges() {
+	// Runs of every length from none to long ones, so the upper bound gallops past its first stride
+	std::vector<int> values;
+	for (int key = 0; key < 3 * N; ++key)
+		values.insert(values.end(), key % 40, key);
+	std::shuffle(values.begin(), values.end(), gen);
+	ancillary::flat_multiset<int, std::less<int>, std::allocator<int>, SearchPolicy> multiset(values.begin(), values.end());
+	for (int key = -1; key <= 3 * N; ++key) {
+		auto expected = std::equal_range(multiset.begin(), multiset.end(), key);
+		auto range = multiset.equal_range(key);
+		ASSERT_EQ(expected.first, range.first);
+		ASSERT_EQ(expected.second, range.second);
+		ASSERT_EQ(static_cast<std::size_t>(expected.second - expected.first), multiset.count(key));
+	}
+	ASSERT_EQ(39, multiset.erase(39));
+	ASSERT_FALSE(multiset.contains(39));
+}
+
+TEST(FlatMultisetTests, EqualRangeTests) {
+	check_equal_ranges<ancillary::binary_search_policy>();
+	check_equal_ranges<ancillary::branchless_search_policy>();
+	check_equal_ranges<ancillary::interpolation_search_policy>();
+
+	// The search policy serves equal_range, count and erase by key
+	ancillary::flat_multiset<int, std::less<int>, std::allocator<int>, counting_search_policy> multiset{ 1, 2, 2, 3 };
+	counting_search_policy::searches = 0;
+	ASSERT_EQ(2, multiset.count(2));
+	ASSERT_EQ(1, multiset.equal_range(3).second - multiset.equal_range(3).first);
+	ASSERT_EQ(2, multiset.erase(2));
+	ASSERT_EQ(4, counting_search_policy::searches);
+}
+
 TEST(FlatMultisetTests, LexicographicalTests) {
 	ASSERT_EQ(multiset_t({ {0, 0}, {1, 1}, {2, 2} }), multiset_t({ {0, 0}, {1, 1}, {2, 2} }));
 	ASSERT_LE(multiset_t({ {0, 0}, {1, 1}, {2, 2} }), multiset_t({ {1, 2}, {2, 5} }));
@@ -1,10 +1,19 @@
 #include <gtest/gtest.h>
 #include <random>
+#include <cstdint>
+#include <deque>
 #include <vector>
+#include <memory_resource>
+#include <numeric>
 #include <string>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <functional>
 #include <algorithm>
 #include "../include/employee.hpp"
 #include "../include/constants.hpp"
+#include <ancillary/container/deque.hpp>
 #include <ancillary/container/flat_set.hpp>
 
 using set_t = ancillary::flat_set<int>;
@@ -178,6 +187,102 @@ TEST(FlatSetTests, InsertionTests) {
 	ASSERT_EQ(std::unique(set.begin(), set.end()), set.end());
 }
 
+TEST(FlatSetTests, RangeInsertionTests) {
+	std::vector<int> values(2 * N);
+	std::iota(values.begin(), values.end(), 0);
+	std::shuffle(values.begin(), values.end(), gen);
+
+	// Insert the even values into an empty set
+	std::vector<int> evens;
+	std::copy_if(values.begin(), values.end(), std::back_inserter(evens), [](int i) { return i % 2 == 0; });
+	set_t set;
+	set.insert(evens.begin(), evens.end());
+	ASSERT_EQ(N, set.size());
+	ASSERT_TRUE(std::is_sorted(set.begin(), set.end()));
+
+	// Insert every value, twice, into a non-empty set
+	auto copy(values);
+	values.insert(values.end(), copy.begin(), copy.end());
+	std::shuffle(values.begin(), values.end(), gen);
+	set.insert(values.begin(), values.end());
+	ASSERT_EQ(2 * N, set.size());
+	ASSERT_TRUE(std::is_sorted(set.begin(), set.end()));
+	ASSERT_EQ(std::unique(set.begin(), set.end()), set.end());
+	for (int i = 0; i < 2 * N; ++i)
+		ASSERT_TRUE(set.contains(i));
+
+	// Inserting an empty range leaves the set untouched
+	set.insert(values.end(), values.end());
+	ASSERT_EQ(2 * N, set.size());
+}
+
+TEST(FlatSetTests, ParallelConstructionTests) {
+	// Large enough for every thread to sort a chunk of its own
+	const int n = 1 << 17;
+	std::vector<int> values(n);
+	std::iota(values.begin(), values.end(), 0);
+	auto copy(values);
+	values.insert(values.end(), copy.begin(), copy.end());
+	std::shuffle(values.begin(), values.end(), gen);
+
+	for (std::size_t threads : { 1, 3, 4 }) {
+		set_t set(ancillary::execution::parallel_policy{ threads }, values.begin(), values.end());
+		ASSERT_EQ(std::size_t(n), set.size());
+		ASSERT_TRUE(std::equal(set.begin(), set.end(), copy.begin()));
+	}
+
+	// Insert the odd values into a set holding the even ones
+	std::vector<int> odds;
+	std::copy_if(values.begin(), values.end(), std::back_inserter(odds), [](int i) { return i % 2 == 1; });
+	set_t set;
+	for (int i = 0; i < n; i += 2)
+		set.insert(set.cend(), i);
+	set.insert(ancillary::execution::par, odds.begin(), odds.end());
+	ASSERT_EQ(std::size_t(n), set.size());
+	ASSERT_TRUE(std::equal(set.begin(), set.end(), copy.begin()));
+}
+
+TEST(FlatSetTests, SortedUniqueTests) {
+	std::vector<int> values(N);
+	std::iota(values.begin(), values.end(), 0);
+
+	set_t s1(ancillary::sorted_unique, values.begin(), values.end());
+	ASSERT_EQ(N, s1.size());
+	ASSERT_TRUE(std::equal(s1.begin(), s1.end(), values.begin(), values.end()));
+
+	set_t s2(ancillary::sorted_unique, { 1, 2, 3, 4 });
+	ASSERT_EQ(4, s2.size());
+	ASSERT_TRUE(std::is_sorted(s2.begin(), s2.end()));
+
+	// Sorted insertion merges with the existing elements and skips duplicates
+	std::vector<int> more(2 * N);
+	std::iota(more.begin(), more.end(), N / 2);
+	s1.insert(ancillary::sorted_unique, more.begin(), more.end());
+	ASSERT_EQ(N / 2 + 2 * N, s1.size());
+	ASSERT_TRUE(std::is_sorted(s1.begin(), s1.end()));
+	ASSERT_EQ(std::unique(s1.begin(), s1.end()), s1.end());
+
+	s2.insert(ancillary::sorted_unique, { 0, 2, 5 });
+	ASSERT_EQ(6, s2.size());
+	ASSERT_TRUE(std::is_sorted(s2.begin(), s2.end()));
+}
+
+TEST(FlatSetTests, ExtractReplaceTests) {
+	std::vector<int> values(N);
+	std::iota(values.begin(), values.end(), 0);
+	set_t set(values.begin(), values.end());
+
+	auto data = std::move(set).extract();
+	ASSERT_TRUE(set.empty());
+	ASSERT_EQ(values, data);
+
+	const int* storage = data.data();
+	set.replace(std::move(data));
+	ASSERT_EQ(N, set.size());
+	ASSERT_EQ(storage, &*set.begin());
+	ASSERT_TRUE(set.contains(N - 1));
+}
+
 TEST(FlatSetTests, ErasureTests) {
 	set_t set;
 	std::vector<int> integers;
@@ -198,6 +303,37 @@ TEST(FlatSetTests, ErasureTests) {
 	}
 }
 
+TEST(FlatSetTests, BulkErasureTests) {
+	std::vector<int> values(10 * N);
+	std::iota(values.begin(), values.end(), 0);
+	std::shuffle(values.begin(), values.end(), gen);
+	set_t set(values.begin(), values.end());
+
+	ASSERT_EQ(5 * N, ancillary::erase_if(set, [](int x) { return x % 2 == 1; }));
+	ASSERT_EQ(5 * N, set.size());
+	ASSERT_TRUE(std::all_of(set.begin(), set.end(), [](int x) { return x % 2 == 0; }));
+	ASSERT_EQ(0, ancillary::erase_if(set, [](int x) { return x < 0; }));
+
+	// A throwing predicate leaves the elements it has not reached in place
+	set_t copy(set);
+	ASSERT_THROW(ancillary::erase_if(copy, [](int x) { if (x == 8 * N) throw std::runtime_error("Predicate failed!"); return false; }), std::runtime_error);
+	ASSERT_EQ(set, copy);
+
+	// Keys that are absent, repeated, or outside the range of the set
+	std::vector<int> keys{ -3, 0, 1, 2, 2, 3, 4 * N, 4 * N + 1, 10 * N - 2, 20 * N };
+	ASSERT_EQ(4, set.erase(ancillary::sorted_unique, keys.begin(), keys.end()));
+	ASSERT_EQ(5 * N - 4, set.size());
+	for (int key : keys)
+		ASSERT_FALSE(set.contains(key));
+	ASSERT_TRUE(set.contains(4));
+	ASSERT_TRUE(std::is_sorted(set.begin(), set.end()));
+
+	keys.assign(set.begin(), set.end());
+	ASSERT_EQ(keys.size(), set.erase(ancillary::sorted_unique, keys.begin(), keys.end()));
+	ASSERT_TRUE(set.empty());
+	ASSERT_EQ(0, set.erase(ancillary::sorted_unique, keys.begin(), keys.end()));
+}
+
 TEST(FlatSetTests, LookupTests) {
 	std::vector<int> integers;
 	set_t set;
@@ -214,6 +350,281 @@ TEST(FlatSetTests, LookupTests) {
 	}
 }
 
+TEST(FlatSetTests, BranchlessSearchTests) {
+	using branchless_set_t = ancillary::flat_set<int, std::less<int>, std::allocator<int>, ancillary::branchless_search_policy>;
+	for (int size = 0; size < 2 * N; ++size) {
+		std::vector<int> values(size);
+		std::generate(values.begin(), values.end(), [n = 0]() mutable { return 2 * n++; });
+		std::shuffle(values.begin(), values.end(), gen);
+		set_t set(values.begin(), values.end());
+		branchless_set_t branchless(values.begin(), values.end());
+		ASSERT_TRUE(std::equal(set.begin(), set.end(), branchless.begin(), branchless.end()));
+		for (int key = -1; key <= 2 * size; ++key) {
+			ASSERT_EQ(set.lower_bound(key) - set.begin(), branchless.lower_bound(key) - branchless.begin());
+			ASSERT_EQ(set.upper_bound(key) - set.begin(), branchless.upper_bound(key) - branchless.begin());
+			ASSERT_EQ(set.find(key) - set.begin(), branchless.find(key) - branchless.begin());
+			ASSERT_EQ(set.contains(key), branchless.contains(key));
+			ASSERT_EQ(set.count(key), branchless.count(key));
+		}
+	}
+}
+
+TEST(FlatSetTests, InterpolationSearchTests) {
+	using interpolation_set_t = ancillary::flat_set<int, std::less<int>, std::allocator<int>, ancillary::interpolation_search_policy>;
+	// Evenly spread, clustered and heavily skewed keys
+	std::vector<std::function<int(int)>> spreads = {
+		[](int i) { return 2 * i; },
+		[](int i) { return (i / 10) * 1000 + i % 10; },
+		[](int i) { return i * i * i; }
+	};
+	for (const auto& spread : spreads) {
+		for (int size = 0; size < 20 * N; size += 7) {
+			std::vector<int> values(size);
+			for (int i = 0; i < size; ++i)
+				values[i] = spread(i);
+			std::shuffle(values.begin(), values.end(), gen);
+			set_t set(values.begin(), values.end());
+			interpolation_set_t interpolation(values.begin(), values.end());
+			ASSERT_TRUE(std::equal(set.begin(), set.end(), interpolation.begin(), interpolation.end()));
+			std::vector<int> keys = { std::numeric_limits<int>::min(), std::numeric_limits<int>::max() };
+			for (int value : values) {
+				keys.push_back(value - 1);
+				keys.push_back(value);
+				keys.push_back(value + 1);
+			}
+			for (int key : keys) {
+				ASSERT_EQ(set.lower_bound(key) - set.begin(), interpolation.lower_bound(key) - interpolation.begin());
+				ASSERT_EQ(set.upper_bound(key) - set.begin(), interpolation.upper_bound(key) - interpolation.begin());
+				ASSERT_EQ(set.contains(key), interpolation.contains(key));
+			}
+		}
+	}
+
+	// Floating point keys, each given three times
+	std::vector<double> reals(10 * N);
+	for (std::size_t i = 0; i < reals.size(); ++i)
+		reals[i] = std::sqrt(double(i / 3));
+	ancillary::flat_set<double, std::less<>, std::allocator<double>, ancillary::interpolation_search_policy> real_set(reals.begin(), reals.end());
+	for (double key : reals)
+		ASSERT_EQ(key, *real_set.find(key));
+	ASSERT_EQ(real_set.end(), real_set.find(-1.0));
+	ASSERT_EQ(real_set.end(), real_set.find(1e9));
+}
+
+TEST(FlatSetTests, FindManyTests) {
+	for (int size = 0; size < 4 * N; size += 3) {
+		std::vector<int> values(size);
+		std::generate(values.begin(), values.end(), [n = 0]() mutable { return 2 * n++; });
+		set_t set(values.begin(), values.end());
+
+		std::vector<int> probes(3 * size + 40);
+		std::uniform_int_distribution<int> dist(-2, 2 * size + 2);
+		std::generate(probes.begin(), probes.end(), [&] { return dist(gen); });
+		for (int sorted = 0; sorted < 2; ++sorted) {
+			if (sorted)
+				std::sort(probes.begin(), probes.end());
+			std::vector<set_t::const_iterator> found;
+			std::vector<bool> contained;
+			const set_t& cset = set;
+			cset.find_many(probes.begin(), probes.end(), std::back_inserter(found));
+			set.contains_many(probes.begin(), probes.end(), std::back_inserter(contained));
+			ASSERT_EQ(probes.size(), found.size());
+			ASSERT_EQ(probes.size(), contained.size());
+			for (std::size_t i = 0; i < probes.size(); ++i) {
+				ASSERT_EQ(set.find(probes[i]), found[i]);
+				ASSERT_EQ(set.contains(probes[i]), contained[i]);
+			}
+		}
+	}
+}
+
+TEST(FlatSetTests, MergeTests) {
+	std::vector<int> lhs_values(N), rhs_values(N);
+	std::generate(lhs_values.begin(), lhs_values.end(), [n = 0]() mutable { return 2 * n++; });
+	std::generate(rhs_values.begin(), rhs_values.end(), [n = 0]() mutable { return 3 * n++; });
+	set_t lhs(lhs_values.begin(), lhs_values.end());
+	set_t rhs(rhs_values.begin(), rhs_values.end());
+
+	std::vector<int> merged, left;
+	std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(merged));
+	std::set_intersection(rhs.begin(), rhs.end(), lhs.begin(), lhs.end(), std::back_inserter(left));
+	lhs.merge(rhs);
+	ASSERT_TRUE(std::equal(lhs.begin(), lhs.end(), merged.begin(), merged.end()));
+	ASSERT_TRUE(std::equal(rhs.begin(), rhs.end(), left.begin(), left.end()));
+
+	set_t empty;
+	empty.merge(std::move(lhs));
+	ASSERT_TRUE(lhs.empty());
+	ASSERT_TRUE(std::equal(empty.begin(), empty.end(), merged.begin(), merged.end()));
+	empty.merge(empty);
+	ASSERT_EQ(merged.size(), empty.size());
+}
+
+TEST(FlatSetTests, SetAlgebraTests) {
+	// Skewed and balanced operands, including empty ones
+	for (int size : { 0, 1, 10, int(N), int(10 * N) }) {
+		std::vector<int> lhs_values(10 * N), rhs_values(size);
+		std::generate(lhs_values.begin(), lhs_values.end(), [n = 0]() mutable { return 2 * n++; });
+		std::uniform_int_distribution<int> dist(-5, 25 * N);
+		std::generate(rhs_values.begin(), rhs_values.end(), [&] { return dist(gen); });
+		set_t lhs(lhs_values.begin(), lhs_values.end());
+		set_t rhs(rhs_values.begin(), rhs_values.end());
+
+		std::vector<int> expected;
+		std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+		auto result = ancillary::set_union(lhs, rhs);
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+		result = ancillary::set_union(rhs, lhs);
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+
+		expected.clear();
+		std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+		result = ancillary::set_intersection(lhs, rhs);
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+
+		expected.clear();
+		std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+		result = ancillary::set_difference(lhs, rhs);
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+
+		expected.clear();
+		std::set_difference(rhs.begin(), rhs.end(), lhs.begin(), lhs.end(), std::back_inserter(expected));
+		result = ancillary::set_difference(rhs, lhs);
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+
+		expected.clear();
+		std::set_symmetric_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+		result = ancillary::set_symmetric_difference(lhs, std::move(rhs));
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+		ASSERT_TRUE(rhs.empty());
+	}
+}
+
+TEST(FlatSetTests, SetAlgebraMoveTests) {
+	using string_set_t = ancillary::flat_set<std::string>;
+	string_set_t lhs{ "a", "b", "c" };
+	string_set_t rhs{ "b", "c", "d" };
+	auto result = ancillary::set_union(std::move(lhs), std::move(rhs));
+	ASSERT_EQ(string_set_t({ "a", "b", "c", "d" }), result);
+	ASSERT_TRUE(lhs.empty());
+	ASSERT_TRUE(rhs.empty());
+}
+
+template <class Set>
+void check_bounds(const Set& set, typename Set::key_type key) {
+	ASSERT_EQ(std::lower_bound(set.begin(), set.end(), key), set.lower_bound(key));
+	ASSERT_EQ(std::upper_bound(set.begin(), set.end(), key), set.upper_bound(key));
+	ASSERT_EQ(std::binary_search(set.begin(), set.end(), key), set.contains(key));
+}
+
+TEST(FlatSetTests, SimdSearchTests) {
+	// Unsigned keys on both sides of the sign bit and signed keys on both sides of zero
+	for (int size = 0; size < 8 * N; size += 7) {
+		ancillary::flat_set<std::uint64_t> u64;
+		ancillary::flat_set<std::uint32_t, std::less<>> u32;
+		ancillary::flat_set<std::int64_t, std::less<std::int64_t>, std::allocator<std::int64_t>, ancillary::branchless_search_policy> i64;
+		ancillary::flat_set<double> f64;
+		for (int i = 0; i < size; ++i) {
+			u64.insert((std::uint64_t(1) << 63) + 3 * (i - size / 2));
+			u32.insert(std::uint32_t(1u << 31) + 3 * (i - size / 2));
+			i64.insert(3 * (i - size / 2));
+			f64.insert(1.5 * (i - size / 2));
+		}
+		for (int i = -2 - size / 2; i < size; ++i) {
+			check_bounds(u64, (std::uint64_t(1) << 63) + i);
+			check_bounds(u32, std::uint32_t(1u << 31) + i);
+			check_bounds(i64, i);
+			check_bounds(f64, 0.5 * i);
+		}
+	}
+}
+
+// A sequence without an allocator or a capacity, like a fixed capacity vector
+template <class T>
+class unallocated_vector : private std::vector<T> {
+	using base = std::vector<T>;
+public:
+	using typename base::value_type;
+	using typename base::size_type;
+	using typename base::difference_type;
+	using typename base::reference;
+	using typename base::const_reference;
+	using typename base::pointer;
+	using typename base::const_pointer;
+	using typename base::iterator;
+	using typename base::const_iterator;
+	using typename base::reverse_iterator;
+	using typename base::const_reverse_iterator;
+	using base::begin;
+	using base::cbegin;
+	using base::end;
+	using base::cend;
+	using base::rbegin;
+	using base::crbegin;
+	using base::rend;
+	using base::crend;
+	using base::empty;
+	using base::size;
+	using base::max_size;
+	using base::clear;
+	using base::assign;
+	using base::insert;
+	using base::emplace;
+	using base::erase;
+};
+
+template <class Set>
+void check_backing_container() {
+	std::vector<int> values(4 * N);
+	std::iota(values.begin(), values.end(), 0);
+	std::shuffle(values.begin(), values.end(), gen);
+	std::vector<int> evens, odds;
+	std::partition_copy(values.begin(), values.end(), std::back_inserter(evens), std::back_inserter(odds),
+		[](int i) { return i % 2 == 0; });
+
+	Set set(evens.begin(), evens.end());
+	for (int i : odds)
+		set.insert(i);
+	set_t reference(values.begin(), values.end());
+	ASSERT_TRUE(std::equal(set.begin(), set.end(), reference.begin(), reference.end()));
+	ASSERT_EQ(std::size_t(4 * N), set.size());
+	ASSERT_GE(set.capacity(), set.size());
+	for (int key = -1; key <= 4 * N; ++key) {
+		ASSERT_EQ(reference.lower_bound(key) - reference.begin(), set.lower_bound(key) - set.begin());
+		ASSERT_EQ(reference.count(key), set.count(key));
+	}
+
+	ASSERT_EQ(1, set.erase(7));
+	ASSERT_EQ(std::size_t(N), ancillary::erase_if(set, [](int i) { return i % 4 == 0; }));
+	Set other{ 0, 4, 7 };
+	set.merge(other);
+	ASSERT_TRUE(other.empty());
+	ASSERT_EQ(std::size_t(3 * N + 2), set.size());
+	ASSERT_EQ(set, ancillary::set_union(set, other));
+
+	Set copy(set, set.get_allocator());
+	ASSERT_EQ(set, copy);
+	Set moved(std::move(copy), set.get_allocator());
+	ASSERT_EQ(set, moved);
+	std::swap(moved, other);
+	ASSERT_EQ(set, other);
+}
+
+TEST(FlatSetTests, BackingContainerTests) {
+	using policy = ancillary::binary_search_policy;
+	check_backing_container<ancillary::flat_set<int, std::less<int>, std::allocator<int>, policy, std::deque<int>>>();
+	check_backing_container<ancillary::flat_set<int, std::less<int>, std::allocator<int>, policy, ancillary::deque<int>>>();
+	check_backing_container<ancillary::flat_set<int, std::less<int>, std::allocator<int>, policy, unallocated_vector<int>>>();
+
+	// The allocator comes from the container, so a memory resource reaches every element
+	std::pmr::monotonic_buffer_resource resource;
+	using pmr_set_t = ancillary::flat_set<int, std::less<int>, std::allocator<int>, policy, std::pmr::vector<int>>;
+	check_backing_container<pmr_set_t>();
+	pmr_set_t set({ 3, 1, 2 }, &resource);
+	ASSERT_EQ(&resource, set.get_allocator().resource());
+	ASSERT_EQ(&resource, std::move(set).extract().get_allocator().resource());
+}
+
 TEST(FlatSetTests, LexicographicalTests) {
 	ASSERT_EQ(set_t({ 1, 2, 3, 4 }), set_t({ 1, 2, 3, 4 }));
 	ASSERT_LE(set_t({ 1, 2, 3, 4 }), set_t({ 2, 3, 4, 5 }));
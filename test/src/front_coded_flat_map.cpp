@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include "../include/constants.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/front_coded_flat_map.hpp>
+
+using map_t = ancillary::front_coded_flat_map<int, 4>;
+using flat_map_t = ancillary::flat_map<std::string, int>;
+using pair_t = std::pair<std::string, int>;
+
+std::vector<pair_t> make_paths(int size) {
+	std::vector<pair_t> pairs;
+	for (int i = 0; i < size; ++i)
+		pairs.emplace_back("/usr/share/" + std::to_string(i % 7) + "/file" + std::to_string(i), i);
+	pairs.emplace_back("", -1);
+	pairs.emplace_back("/usr", -2);
+	pairs.emplace_back("/usr/share/\xff", -3);
+	std::shuffle(pairs.begin(), pairs.end(), std::mt19937{ std::random_device{}() });
+	return pairs;
+}
+
+template <class Map, class Other>
+bool same_elements(const Map& map, const Other& other) {
+	return std::equal(map.begin(), map.end(), other.begin(), other.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.first == rhs.first && lhs.second == rhs.second;
+	});
+}
+
+TEST(FrontCodedFlatMapTests, ConstructorTests) {
+	map_t m1;
+	ASSERT_TRUE(m1.empty());
+	ASSERT_EQ(m1.begin(), m1.end());
+	ASSERT_FALSE(m1.contains(""));
+
+	auto pairs = make_paths(N);
+	map_t m2(pairs.begin(), pairs.end());
+	flat_map_t reference(pairs.begin(), pairs.end());
+	ASSERT_EQ(reference.size(), m2.size());
+	ASSERT_TRUE(same_elements(m2, reference));
+
+	map_t m3{ {"b", 2}, {"a", 1}, {"b", 3} };
+	ASSERT_EQ(2, m3.size());
+	ASSERT_EQ(2, m3.at("b"));
+
+	map_t m4(reference);
+	ASSERT_EQ(m2, m4);
+	map_t m5(ancillary::sorted_unique, { {"a", 1}, {"b", 2} });
+	ASSERT_EQ(m3, m5);
+	ASSERT_NE(m4, m5);
+}
+
+TEST(FrontCodedFlatMapTests, IteratorTests) {
+	auto pairs = make_paths(N);
+	map_t map(pairs.begin(), pairs.end());
+	flat_map_t reference(pairs.begin(), pairs.end());
+	ASSERT_EQ(map.size(), static_cast<std::size_t>(map.end() - map.begin()));
+
+	// Walking backwards restores each key from its block head
+	auto it = map.end();
+	auto ref = reference.end();
+	while (it != map.begin()) {
+		--it;
+		--ref;
+		ASSERT_EQ(ref->first, it->first);
+	}
+
+	for (auto it = map.begin(); it != map.end(); ++it)
+		it->second += 1000;
+	for (auto [key, value] : map)
+		ASSERT_EQ(reference.at(std::string(key)) + 1000, value);
+
+	map_t::const_iterator cit = map.begin() + 5;
+	ASSERT_EQ(reference.begin()[5].first, cit->first);
+	ASSERT_EQ(map.begin() + 5, cit);
+	ASSERT_EQ(std::next(reference.begin(), 9)->first, (cit + 4)->first);
+	ASSERT_EQ(reference.begin()[9].first, cit[4].first);
+}
+
+TEST(FrontCodedFlatMapTests, KeyLifetimeTests) {
+	// Keys are yielded by value, so they outlive the iterator that restored them
+	static_assert(std::is_same_v<map_t::iterator::iterator_category, std::input_iterator_tag>);
+	auto pairs = make_paths(N);
+	map_t map(pairs.begin(), pairs.end());
+	flat_map_t reference(pairs.begin(), pairs.end());
+
+	std::vector<std::string> keys;
+	for (auto it = map.begin(); it != map.end(); ++it)
+		keys.push_back(it->first);
+	std::vector<std::pair<std::string, int>> copied(map.begin(), map.end());
+	ASSERT_EQ(reference.size(), keys.size());
+	for (std::size_t i = 0; i < keys.size(); ++i) {
+		ASSERT_EQ(reference.begin()[i].first, keys[i]);
+		ASSERT_EQ(reference.begin()[i], copied[i]);
+	}
+}
+
+TEST(FrontCodedFlatMapTests, LookupTests) {
+	auto pairs = make_paths(N);
+	map_t map(pairs.begin(), pairs.end());
+	flat_map_t reference(pairs.begin(), pairs.end());
+
+	std::vector<std::string> probes{ "", "/", "/usq", "/usr", "/usr/", "/usr/share/", "/usr/share/\xff", "/usr/share/\xff\xff", "\xff" };
+	for (const auto& pair : reference) {
+		probes.push_back(pair.first);
+		probes.push_back(pair.first + "0");
+		probes.push_back(pair.first.substr(0, pair.first.size() - 1));
+	}
+	for (const auto& probe : probes) {
+		ASSERT_EQ(reference.contains(probe), map.contains(probe)) << probe;
+		ASSERT_EQ(reference.count(probe), map.count(probe));
+		ASSERT_EQ(reference.lower_bound(probe) - reference.begin(), map.lower_bound(probe) - map.begin()) << probe;
+		ASSERT_EQ(reference.upper_bound(probe) - reference.begin(), map.upper_bound(probe) - map.begin()) << probe;
+		auto [first, last] = map.equal_range(probe);
+		ASSERT_EQ(map.lower_bound(probe), first);
+		ASSERT_EQ(map.upper_bound(probe), last);
+		if (reference.contains(probe)) {
+			ASSERT_EQ(probe, map.find(probe)->first);
+			ASSERT_EQ(reference.at(probe), map.at(probe));
+		}
+		else {
+			ASSERT_EQ(map.end(), map.find(probe));
+			ASSERT_THROW(map.at(probe), std::out_of_range);
+		}
+	}
+
+	const char* literal = "/usr";
+	ASSERT_EQ(-2, map.at(literal));
+	map.at(std::string_view("/usr")) = 7;
+	ASSERT_EQ(7, map.find("/usr")->second);
+}
+
+TEST(FrontCodedFlatMapTests, CompressionTests) {
+	flat_map_t reference;
+	for (int i = 0; i < 1000; ++i)
+		reference.try_emplace("https://example.com/catalog/products/item-" + std::to_string(i), i);
+	ancillary::front_coded_flat_map<int> map(reference);
+	map.shrink_to_fit();
+
+	std::size_t string_bytes = 0;
+	for (const auto& pair : reference)
+		string_bytes += sizeof(std::string) + pair.first.capacity();
+	ASSERT_LT(3 * map.key_bytes(), string_bytes);
+	ASSERT_TRUE(same_elements(map, reference));
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "../include/employee.hpp"
+#include "../include/constants.hpp"
+#include <ancillary/container/frozen_flat_map.hpp>
+
+using map_t = ancillary::flat_map<int, int>;
+using frozen_map_t = ancillary::frozen_flat_map<int, int>;
+using pair_t = std::pair<int, int>;
+
+std::mt19937 gen{ std::random_device{}() };
+
+map_t make_map(int size) {
+	std::vector<pair_t> pairs(size);
+	std::generate(pairs.begin(), pairs.end(), [n = 0]() mutable {
+		auto value = 2 * n++;
+		return std::make_pair(value, value);
+	});
+	std::shuffle(pairs.begin(), pairs.end(), gen);
+	return map_t(pairs.begin(), pairs.end());
+}
+
+TEST(FrozenFlatMapTests, ConstructorTests) {
+	frozen_map_t f1;
+	ASSERT_TRUE(f1.empty());
+	ASSERT_EQ(f1.begin(), f1.end());
+
+	auto map = make_map(N);
+	frozen_map_t f2(map);
+	ASSERT_EQ(map.size(), f2.size());
+	ASSERT_TRUE(std::equal(f2.begin(), f2.end(), map.begin(), map.end()));
+
+	frozen_map_t f3(std::move(map));
+	ASSERT_TRUE(map.empty());
+	ASSERT_EQ(f2, f3);
+
+	frozen_map_t f4{ {3, 3}, {1, 1}, {2, 2} };
+	ASSERT_EQ(3, f4.size());
+	ASSERT_TRUE(std::is_sorted(f4.begin(), f4.end(), f4.value_comp()));
+
+	frozen_map_t copier(f4);
+	ASSERT_EQ(f4, copier);
+	frozen_map_t thief(std::move(copier));
+	ASSERT_EQ(f4, thief);
+}
+
+TEST(FrozenFlatMapTests, CopyLookupTests) {
+	// Copies lay their keys out for their own storage, so lookups must survive every copy and move
+	frozen_map_t original(make_map(N));
+	frozen_map_t copy(original);
+	frozen_map_t assigned;
+	assigned = copy;
+	frozen_map_t moved;
+	moved = std::move(copy);
+	for (const frozen_map_t* map : { &original, &assigned, &moved }) {
+		for (int key = 0; key < static_cast<int>(2 * N); ++key)
+			ASSERT_EQ(key % 2 == 0, map->contains(key));
+	}
+
+	ancillary::frozen_flat_map<std::string, int> strings{ {"b", 2}, {"a", 1}, {"c", 3} };
+	auto string_copy = strings;
+	ASSERT_EQ(2, string_copy.at("b"));
+	ASSERT_FALSE(string_copy.contains("d"));
+}
+
+TEST(FrozenFlatMapTests, IteratorTests) {
+	for (int size = 0; size < static_cast<int>(2 * N); ++size) {
+		auto map = make_map(size);
+		frozen_map_t frozen(map);
+		ASSERT_EQ(map.size(), static_cast<std::size_t>(std::distance(frozen.begin(), frozen.end())));
+		ASSERT_TRUE(std::equal(frozen.begin(), frozen.end(), map.begin(), map.end()));
+		ASSERT_TRUE(std::equal(frozen.rbegin(), frozen.rend(), map.rbegin(), map.rend()));
+	}
+}
+
+TEST(FrozenFlatMapTests, LookupTests) {
+	for (int size = 0; size < static_cast<int>(2 * N); ++size) {
+		auto map = make_map(size);
+		frozen_map_t frozen(map);
+		for (int key = -1; key <= 2 * size; ++key) {
+			ASSERT_EQ(map.contains(key), frozen.contains(key));
+			ASSERT_EQ(map.count(key), frozen.count(key));
+
+			auto lower = frozen.lower_bound(key);
+			auto map_lower = map.lower_bound(key);
+			ASSERT_EQ(map_lower == map.end(), lower == frozen.end());
+			if (lower != frozen.end()) {
+				ASSERT_EQ(*map_lower, *lower);
+			}
+
+			auto upper = frozen.upper_bound(key);
+			auto map_upper = map.upper_bound(key);
+			ASSERT_EQ(map_upper == map.end(), upper == frozen.end());
+			if (upper != frozen.end()) {
+				ASSERT_EQ(*map_upper, *upper);
+			}
+
+			auto it = frozen.find(key);
+			if (map.contains(key)) {
+				ASSERT_EQ(key, it->first);
+				ASSERT_EQ(map.at(key), frozen.at(key));
+			}
+			else {
+				ASSERT_EQ(frozen.end(), it);
+				ASSERT_THROW(frozen.at(key), std::out_of_range);
+			}
+		}
+	}
+}
+
+TEST(FrozenFlatMapTests, TransparentCompareTests) {
+	std::vector<std::pair<Employee, int>> employees(N);
+	ancillary::frozen_flat_map<Employee, int, EmployeeCompare> frozen(employees.begin(), employees.end());
+	for (const auto& employee : employees) {
+		ASSERT_TRUE(frozen.contains(employee.first.get_id()));
+		ASSERT_EQ(employee.first.get_id(), frozen.find(employee.first.get_id())->first.get_id());
+	}
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "../include/constants.hpp"
+#include <ancillary/container/hashed_flat_map.hpp>
+
+using map_t = ancillary::hashed_flat_map<int, int>;
+
+std::mt19937 gen{ std::random_device{}() };
+
+// Every key in the reference must be found through the index at its sorted position
+template <class Map, class Reference>
+void expect_same(const Map& map, const Reference& reference) {
+	ASSERT_EQ(map.size(), reference.size());
+	EXPECT_TRUE(std::equal(map.begin(), map.end(), reference.begin(), reference.end(),
+		[](const auto& lhs, const auto& rhs) { return lhs.first == rhs.first && lhs.second == rhs.second; }));
+	for (auto it = map.begin(); it != map.end(); ++it)
+		EXPECT_EQ(map.find(it->first), it);
+}
+
+TEST(HashedFlatMapTests, InsertionEraseTests) {
+	map_t map;
+	std::map<int, int> reference;
+	for (int round = 0; round < 20; ++round) {
+		for (int i = 0; i < static_cast<int>(N); ++i) {
+			int key = gen() % (20 * N);
+			int value = gen() % 1000;
+			switch (gen() % 4) {
+			case 0:
+				EXPECT_EQ(map.insert({ key, value }).second, reference.insert({ key, value }).second);
+				break;
+			case 1:
+				map.insert_or_assign(key, value);
+				reference.insert_or_assign(key, value);
+				break;
+			case 2:
+				EXPECT_EQ(map.erase(key), reference.erase(key));
+				break;
+			default:
+				if (!map.empty()) {
+					auto offset = gen() % map.size();
+					auto it = map.erase(map.begin() + offset);
+					auto ref = reference.erase(std::next(reference.begin(), offset));
+					EXPECT_EQ(it == map.end(), ref == reference.end());
+				}
+			}
+		}
+		expect_same(map, reference);
+		EXPECT_LE(2 * map.size(), map.index_capacity());
+	}
+}
+
+TEST(HashedFlatMapTests, LookupTests) {
+	std::vector<std::pair<int, int>> values;
+	for (int i = 0; i < static_cast<int>(N); ++i)
+		values.emplace_back(2 * i, i);
+	std::shuffle(values.begin(), values.end(), gen);
+	map_t map(values.begin(), values.end());
+	const map_t& cmap = map;
+	for (int key = -1; key <= 2 * static_cast<int>(N); ++key) {
+		bool present = key >= 0 && key % 2 == 0 && key < 2 * static_cast<int>(N);
+		EXPECT_EQ(map.contains(key), present);
+		EXPECT_EQ(map.count(key), present ? 1u : 0u);
+		EXPECT_EQ(cmap.find(key) != cmap.end(), present);
+		auto range = map.equal_range(key);
+		EXPECT_EQ(range.first, map.lower_bound(key));
+		EXPECT_EQ(range.second, map.upper_bound(key));
+		if (present)
+			EXPECT_EQ(cmap.at(key), key / 2);
+		else
+			EXPECT_THROW(cmap.at(key), std::out_of_range);
+	}
+}
+
+TEST(HashedFlatMapTests, ElementAccessTests) {
+	map_t map;
+	for (int i = static_cast<int>(N); i > 0; --i)
+		map[i] = i;
+	for (int i = 1; i <= static_cast<int>(N); ++i) {
+		map.at(i) *= 2;
+		map.find(i)->second += 1;
+		EXPECT_EQ(map[i], 2 * i + 1);
+	}
+	EXPECT_TRUE(std::is_sorted(map.begin(), map.end()));
+}
+
+TEST(HashedFlatMapTests, RangeOperationTests) {
+	map_t map;
+	std::map<int, int> reference;
+	std::vector<std::pair<int, int>> values;
+	for (int i = 0; i < static_cast<int>(N); ++i)
+		values.emplace_back(gen() % (4 * N), i);
+	map.insert(values.begin(), values.end());
+	reference.insert(values.begin(), values.end());
+	expect_same(map, reference);
+
+	auto first = map.lower_bound(N);
+	auto last = map.lower_bound(2 * N);
+	map.erase(first, last);
+	reference.erase(reference.lower_bound(N), reference.lower_bound(2 * N));
+	expect_same(map, reference);
+
+	map.clear();
+	EXPECT_TRUE(map.empty());
+	EXPECT_FALSE(map.contains(0));
+	EXPECT_EQ(map.index_capacity(), 0u);
+}
+
+TEST(HashedFlatMapTests, CollidingHashTests) {
+	// Every key lands in the same probe sequence
+	struct constant_hash { std::size_t operator()(const std::string&) const { return 42; } };
+	ancillary::hashed_flat_map<std::string, int, constant_hash> map;
+	std::map<std::string, int> reference;
+	for (int i = 0; i < static_cast<int>(N); ++i) {
+		auto key = std::to_string(gen() % (2 * N));
+		if (gen() % 3 == 0) {
+			EXPECT_EQ(map.erase(key), reference.erase(key));
+		}
+		else {
+			map[key] = i;
+			reference[key] = i;
+		}
+	}
+	expect_same(map, reference);
+}
+
+TEST(HashedFlatMapTests, CopySwapTests) {
+	map_t lhs{ {1, 1}, {2, 2}, {3, 3} };
+	map_t rhs{ {4, 4} };
+	map_t copy(lhs);
+	EXPECT_EQ(copy, lhs);
+	std::swap(lhs, rhs);
+	EXPECT_EQ(rhs, copy);
+	EXPECT_TRUE(lhs.contains(4));
+	EXPECT_FALSE(lhs.contains(1));
+	EXPECT_TRUE(rhs.contains(3));
+	EXPECT_NE(lhs, rhs);
+}
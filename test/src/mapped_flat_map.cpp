@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+#include "../include/constants.hpp"
+#include <ancillary/container/mapped_flat_map.hpp>
+#include <ancillary/container/mapped_flat_set.hpp>
+
+struct point {
+	int x;
+	double y;
+};
+
+using flat_map_t = ancillary::flat_map<std::uint64_t, point>;
+using map_t = ancillary::mapped_flat_map<std::uint64_t, point>;
+using flat_set_t = ancillary::flat_set<int>;
+using set_t = ancillary::mapped_flat_set<int>;
+
+std::string temp_path(const std::string& name) {
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+flat_map_t make_map(std::size_t size) {
+	flat_map_t map;
+	for (std::size_t i = 0; i < size; ++i)
+		map.try_emplace(3 * i, point{ static_cast<int>(i), 0.5 * i });
+	return map;
+}
+
+TEST(MappedFlatMapTests, RoundTripTests) {
+	auto path = temp_path("ancillary_mapped_flat_map.bin");
+	auto reference = make_map(1000);
+	ancillary::write_mapped(reference, path);
+
+	map_t map(path);
+	ASSERT_EQ(reference.size(), map.size());
+	ASSERT_TRUE(std::equal(map.begin(), map.end(), reference.begin(), reference.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.first == rhs.first && lhs.second.x == rhs.second.x && lhs.second.y == rhs.second.y;
+	}));
+	ASSERT_EQ(map.size(), static_cast<std::size_t>(map.end() - map.begin()));
+	ASSERT_EQ(reference.rbegin()->first, map.rbegin()->first);
+	ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(map.keys().data()) % ancillary::detail::cache_line_size);
+	ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(map.values().data()) % ancillary::detail::cache_line_size);
+
+	map_t thief(std::move(map));
+	ASSERT_TRUE(map.empty());
+	ASSERT_EQ(map.begin(), map.end());
+	ASSERT_EQ(reference.size(), thief.size());
+	map = std::move(thief);
+	ASSERT_EQ(reference.size(), map.size());
+
+	std::filesystem::remove(path);
+}
+
+TEST(MappedFlatMapTests, LookupTests) {
+	auto path = temp_path("ancillary_mapped_flat_map_lookup.bin");
+	auto reference = make_map(1000);
+	ancillary::write_mapped(reference, path);
+	map_t map(path);
+
+	for (std::uint64_t key = 0; key < 3001; ++key) {
+		ASSERT_EQ(reference.contains(key), map.contains(key));
+		ASSERT_EQ(reference.count(key), map.count(key));
+		ASSERT_EQ(reference.lower_bound(key) - reference.begin(), map.lower_bound(key) - map.begin());
+		ASSERT_EQ(reference.upper_bound(key) - reference.begin(), map.upper_bound(key) - map.begin());
+		auto [first, last] = map.equal_range(key);
+		ASSERT_EQ(map.lower_bound(key), first);
+		ASSERT_EQ(map.upper_bound(key), last);
+		if (reference.contains(key)) {
+			ASSERT_EQ(key, map.find(key)->first);
+			ASSERT_EQ(static_cast<int>(key / 3), map.at(key).x);
+		}
+		else {
+			ASSERT_EQ(map.end(), map.find(key));
+			ASSERT_THROW(map.at(key), std::out_of_range);
+		}
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST(MappedFlatMapTests, BadFileTests) {
+	ASSERT_THROW(map_t(temp_path("ancillary_no_such_file.bin")), std::system_error);
+
+	auto path = temp_path("ancillary_mapped_flat_map_bad.bin");
+	{
+		std::ofstream out(path, std::ios::binary);
+		out << "not a mapped flat container";
+	}
+	ASSERT_THROW(map_t{ path }, std::runtime_error);
+
+	ancillary::write_mapped(make_map(N), path);
+	ASSERT_THROW((ancillary::mapped_flat_map<std::uint32_t, point>(path)), std::runtime_error);
+	ASSERT_THROW(set_t{ path }, std::runtime_error);
+
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+	ASSERT_THROW(map_t{ path }, std::runtime_error);
+
+	ancillary::write_mapped(flat_map_t(), path);
+	map_t empty(path);
+	ASSERT_TRUE(empty.empty());
+	ASSERT_EQ(empty.end(), empty.find(0));
+
+	std::filesystem::remove(path);
+}
+
+TEST(MappedFlatSetTests, RoundTripTests) {
+	auto path = temp_path("ancillary_mapped_flat_set.bin");
+	flat_set_t reference;
+	for (int i = 0; i < static_cast<int>(N); ++i)
+		reference.insert(2 * i);
+	ancillary::write_mapped(reference, path);
+
+	set_t set(path);
+	ASSERT_TRUE(std::equal(set.begin(), set.end(), reference.begin(), reference.end()));
+	for (int key = -1; key <= static_cast<int>(2 * N); ++key) {
+		ASSERT_EQ(reference.contains(key), set.contains(key));
+		ASSERT_EQ(reference.lower_bound(key) - reference.begin(), set.lower_bound(key) - set.begin());
+		ASSERT_EQ(reference.upper_bound(key) - reference.begin(), set.upper_bound(key) - set.begin());
+	}
+
+	set_t other(path);
+	ASSERT_EQ(set, other);
+
+	std::filesystem::remove(path);
+}
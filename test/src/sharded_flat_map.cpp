@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <climits>
+#include <vector>
+#include <algorithm>
+#include "../include/constants.hpp"
+#include <ancillary/container/sharded_flat_map.hpp>
+
+using map_t = ancillary::sharded_flat_map<int, int>;
+using pairs_t = std::vector<std::pair<int, int>>;
+
+template <class Map>
+pairs_t elements(const Map& map) {
+	pairs_t result;
+	map.for_each([&](const auto& element) { result.push_back(element); });
+	return result;
+}
+
+TEST(ShardedFlatMapTests, ModifierTests) {
+	map_t map(4);
+	ASSERT_TRUE(map.empty());
+	ASSERT_EQ(4, map.shard_count());
+
+	std::map<int, int> reference;
+	std::mt19937 gen{ std::random_device{}() };
+	for (int i = 0; i < 20 * static_cast<int>(N); ++i) {
+		int key = gen() % (10 * N);
+		ASSERT_EQ(reference.emplace(key, i).second, map.try_emplace(key, i));
+	}
+	ASSERT_EQ(reference.size(), map.size());
+	ASSERT_EQ(pairs_t(reference.begin(), reference.end()), elements(map));
+
+	ASSERT_FALSE(map.insert_or_assign(reference.begin()->first, -1));
+	ASSERT_EQ(-1, map.get(reference.begin()->first));
+	ASSERT_TRUE(map.update(reference.begin()->first, [](int& value) { value = -2; }));
+	ASSERT_FALSE(map.update(-5, [](int& value) { value = -2; }));
+	ASSERT_TRUE(map.visit(reference.begin()->first, [](int value) { ASSERT_EQ(-2, value); }));
+	ASSERT_FALSE(map.get(-5).has_value());
+
+	ASSERT_EQ(1, map.erase(reference.begin()->first));
+	ASSERT_EQ(0, map.erase(reference.begin()->first));
+	ASSERT_FALSE(map.contains(reference.begin()->first));
+	reference.erase(reference.begin());
+	ASSERT_EQ(reference.size(), map.size());
+
+	map.clear();
+	ASSERT_TRUE(map.empty());
+	ASSERT_TRUE(elements(map).empty());
+}
+
+TEST(ShardedFlatMapTests, RebalanceTests) {
+	// Ascending keys all land in the last shard until the boundaries are recomputed
+	map_t map(4);
+	const int count = 16 * map_t::min_rebalance_size;
+	for (int i = 0; i < count; ++i)
+		ASSERT_TRUE(map.insert({ i, i }));
+	auto sizes = map.shard_sizes();
+	ASSERT_EQ(static_cast<std::size_t>(count), map.size());
+	ASSERT_LE(*std::max_element(sizes.begin(), sizes.end()), 2 * (count / 4) + 1);
+
+	auto all = elements(map);
+	ASSERT_EQ(static_cast<std::size_t>(count), all.size());
+	for (int i = 0; i < count; ++i)
+		ASSERT_EQ(i, all[i].first);
+
+	map.rebalance();
+	sizes = map.shard_sizes();
+	for (auto size : sizes)
+		ASSERT_EQ(static_cast<std::size_t>(count / 4), size);
+	for (int i = 0; i < count; i += 97)
+		ASSERT_TRUE(map.contains(i));
+
+	map_t tiny(8);
+	tiny.insert({ 1, 1 });
+	tiny.insert({ 2, 2 });
+	tiny.rebalance();
+	ASSERT_TRUE(tiny.contains(1));
+	ASSERT_TRUE(tiny.contains(2));
+	ASSERT_FALSE(tiny.contains(0));
+	ASSERT_FALSE(tiny.contains(3));
+	ASSERT_TRUE(tiny.insert({ 0, 0 }));
+	ASSERT_TRUE(tiny.insert({ 3, 3 }));
+	ASSERT_EQ((pairs_t{ {0, 0}, {1, 1}, {2, 2}, {3, 3} }), elements(tiny));
+}
+
+TEST(ShardedFlatMapTests, RangeTests) {
+	pairs_t pairs;
+	for (int i = 0; i < 1000; ++i)
+		pairs.emplace_back(3 * i, i);
+	map_t map(pairs.begin(), pairs.end(), 5);
+	ASSERT_EQ(pairs, elements(map));
+	ASSERT_EQ(1000, map.to_flat_map().size());
+
+	for (int first = -3; first < 3005; first += 37) {
+		for (int last = first; last < 3005; last += 211) {
+			pairs_t visited;
+			map.for_each(first, last, [&](const auto& element) { visited.push_back(element); });
+			auto lo = std::lower_bound(pairs.begin(), pairs.end(), std::make_pair(first, INT_MIN));
+			auto hi = std::lower_bound(pairs.begin(), pairs.end(), std::make_pair(last, INT_MIN));
+			ASSERT_EQ(pairs_t(lo, hi), visited);
+		}
+	}
+}
+
+TEST(ShardedFlatMapTests, ConcurrencyTests) {
+	map_t map(4);
+	const int writers = 4;
+	const int per_writer = 4 * map_t::min_rebalance_size;
+	std::vector<std::thread> threads;
+	for (int w = 0; w < writers; ++w) {
+		threads.emplace_back([&, w] {
+			// Interleaved ascending keys keep the last shard growing and force rebalancing
+			for (int i = 0; i < per_writer; ++i) {
+				int key = i * writers + w;
+				map.insert({ key, key });
+				if (i % 3 == 0)
+					map.erase(key);
+			}
+		});
+	}
+	threads.emplace_back([&] {
+		for (int i = 0; i < 50; ++i) {
+			auto all = elements(map);
+			ASSERT_TRUE(std::is_sorted(all.begin(), all.end()));
+		}
+	});
+	for (auto& thread : threads)
+		thread.join();
+
+	auto all = elements(map);
+	std::size_t expected = 0;
+	for (int i = 0; i < per_writer; ++i)
+		expected += i % 3 != 0 ? writers : 0;
+	ASSERT_EQ(expected, all.size());
+	ASSERT_EQ(expected, map.size());
+	for (const auto& [key, value] : all) {
+		ASSERT_EQ(key, value);
+		ASSERT_NE(0, (key / writers) % 3);
+	}
+}
+
+TEST(ShardedFlatMapTests, SlidingWindowTests) {
+	// Ascending timestamps with the oldest ones erased rebalance over and over while
+	// readers keep routing through the boundaries being replaced
+	map_t map(4);
+	const int window = 2 * map_t::min_rebalance_size;
+	const int count = 32 * window;
+	std::atomic<bool> done{ false };
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 3; ++r) {
+		readers.emplace_back([&] {
+			std::mt19937 gen{ std::random_device{}() };
+			while (!done.load()) {
+				int key = gen() % count;
+				auto value = map.get(key);
+				if (value) {
+					ASSERT_EQ(key, *value);
+				}
+			}
+		});
+	}
+	for (int i = 0; i < count; ++i) {
+		ASSERT_TRUE(map.insert({ i, i }));
+		if (i >= window) {
+			ASSERT_EQ(1, map.erase(i - window));
+		}
+	}
+	done.store(true);
+	for (auto& reader : readers)
+		reader.join();
+
+	ASSERT_EQ(static_cast<std::size_t>(window), map.size());
+	auto all = elements(map);
+	for (int i = 0; i < window; ++i)
+		ASSERT_EQ(count - window + i, all[i].first);
+}
+
+TEST(ShardedFlatMapTests, ConcurrentScanTests) {
+	// Each scan waits inside its callback for the other one, which only returns in
+	// time if scans do not exclude each other
+	map_t map(4);
+	for (int i = 0; i < static_cast<int>(N); ++i)
+		map.insert({ i, i });
+	std::atomic<int> inside{ 0 };
+	std::atomic<int> overlapped{ 0 };
+	auto scan = [&] {
+		bool first = true;
+		map.for_each([&](const auto&) {
+			if (!first)
+				return;
+			first = false;
+			inside.fetch_add(1);
+			auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+			while (inside.load() < 2 && std::chrono::steady_clock::now() < deadline)
+				std::this_thread::yield();
+			overlapped.fetch_add(inside.load() == 2);
+		});
+	};
+	std::thread other(scan);
+	scan();
+	other.join();
+	ASSERT_EQ(2, overlapped.load());
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include "../include/constants.hpp"
+#include <ancillary/container/small_flat_set.hpp>
+#include <ancillary/container/small_flat_map.hpp>
+
+using set_t = ancillary::small_flat_set<int, 16>;
+using map_t = ancillary::small_flat_map<int, int, 16>;
+
+std::mt19937 gen{ std::random_device{}() };
+
+TEST(SmallFlatSetTests, InlineTests) {
+	std::vector<int> values(16);
+	std::iota(values.begin(), values.end(), 0);
+	std::shuffle(values.begin(), values.end(), gen);
+
+	set_t set;
+	for (int value : values)
+		ASSERT_TRUE(set.insert(value).second);
+	ASSERT_TRUE(std::is_sorted(set.begin(), set.end()));
+	ASSERT_EQ(16, set.capacity());
+	ASSERT_TRUE(std::move(set).extract().is_inline());
+
+	set_t ranged(values.begin(), values.end());
+	ASSERT_EQ(16, ranged.size());
+	ASSERT_TRUE(ranged.contains(7));
+	ASSERT_EQ(1, ranged.erase(7));
+	ASSERT_FALSE(ranged.contains(7));
+}
+
+TEST(SmallFlatSetTests, SpillTests) {
+	std::vector<int> values(4 * N);
+	std::iota(values.begin(), values.end(), 0);
+	std::shuffle(values.begin(), values.end(), gen);
+
+	set_t set(values.begin(), values.end());
+	ancillary::flat_set<int> reference(values.begin(), values.end());
+	ASSERT_TRUE(std::equal(set.begin(), set.end(), reference.begin(), reference.end()));
+	for (int key = -1; key <= 4 * N; ++key) {
+		ASSERT_EQ(reference.lower_bound(key) - reference.begin(), set.lower_bound(key) - set.begin());
+		ASSERT_EQ(reference.contains(key), set.contains(key));
+	}
+
+	set_t copy(set);
+	ASSERT_EQ(set, copy);
+	ASSERT_EQ(std::size_t(2 * N), ancillary::erase_if(copy, [](int i) { return i % 2 == 0; }));
+	set_t other{ 1, 3, 5 };
+	std::swap(copy, other);
+	ASSERT_EQ(3, copy.size());
+	ASSERT_EQ(std::size_t(2 * N), other.size());
+}
+
+TEST(SmallFlatMapTests, MapTests) {
+	map_t map;
+	for (int i = 0; i < 10; ++i)
+		map[i % 5] += i;
+	ASSERT_EQ(5, map.size());
+	ASSERT_EQ(0 + 5, map.at(0));
+	ASSERT_EQ(4 + 9, map.at(4));
+	ASSERT_FALSE(map.try_emplace(3, 100).second);
+	ASSERT_TRUE(map.insert_or_assign(30, 100).second);
+	ASSERT_EQ(100, map.at(30));
+	ASSERT_THROW(map.at(31), std::out_of_range);
+
+	for (int i = 0; i < 2 * N; ++i)
+		map.emplace(100 + i, i);
+	ASSERT_EQ(std::size_t(6 + 2 * N), map.size());
+	ASSERT_TRUE(std::is_sorted(map.begin(), map.end(), map.value_comp()));
+	ASSERT_EQ(N, map.at(100 + N));
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <memory>
+#include <numeric>
+#include <algorithm>
+#include "../include/constants.hpp"
+#include <ancillary/container/small_vector.hpp>
+
+// Counts the allocations made through it, to check that inline elements never allocate
+template <class T>
+struct counting_allocator {
+	using value_type = T;
+	static inline std::size_t allocations = 0;
+
+	counting_allocator() = default;
+	template <class U>
+	counting_allocator(const counting_allocator<U>&) {}
+
+	T* allocate(std::size_t n) {
+		++allocations;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T* p, std::size_t n) {
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	template <class U>
+	bool operator==(const counting_allocator<U>&) const { return true; }
+	template <class U>
+	bool operator!=(const counting_allocator<U>&) const { return false; }
+};
+
+using vector_t = ancillary::small_vector<std::string, 4, counting_allocator<std::string>>;
+
+std::mt19937 gen{ std::random_device{}() };
+
+std::vector<std::string> strings(int n) {
+	std::vector<std::string> values(n);
+	for (int i = 0; i < n; ++i)
+		values[i] = "a string long enough to need its own allocation " + std::to_string(i);
+	return values;
+}
+
+TEST(SmallVectorTests, InlineStorageTests) {
+	auto values = strings(4);
+	counting_allocator<std::string>::allocations = 0;
+	vector_t v;
+	for (const auto& value : values)
+		v.push_back(value);
+	ASSERT_TRUE(v.is_inline());
+	ASSERT_EQ(0, counting_allocator<std::string>::allocations);
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), values.begin(), values.end()));
+
+	// The fifth element spills to the heap, and shrinking brings the elements back
+	v.push_back("spilled");
+	ASSERT_FALSE(v.is_inline());
+	ASSERT_EQ(1, counting_allocator<std::string>::allocations);
+	ASSERT_EQ(5, v.size());
+	v.pop_back();
+	v.shrink_to_fit();
+	ASSERT_TRUE(v.is_inline());
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), values.begin(), values.end()));
+}
+
+TEST(SmallVectorTests, ConstructorTests) {
+	for (int size : { 0, 1, 4, 5, int(N) }) {
+		auto values = strings(size);
+		vector_t v(values.begin(), values.end());
+		ASSERT_TRUE(std::equal(v.begin(), v.end(), values.begin(), values.end()));
+
+		vector_t copy(v);
+		ASSERT_EQ(v, copy);
+		vector_t moved(std::move(copy));
+		ASSERT_EQ(v, moved);
+		ASSERT_TRUE(copy.empty());
+
+		vector_t assigned{ "x" };
+		assigned = v;
+		ASSERT_EQ(v, assigned);
+		assigned = std::move(moved);
+		ASSERT_EQ(v, assigned);
+		ASSERT_TRUE(moved.empty());
+
+		vector_t filled(size, "y");
+		ASSERT_EQ(std::size_t(size), filled.size());
+		ASSERT_TRUE(std::all_of(filled.begin(), filled.end(), [](const std::string& s) { return s == "y"; }));
+	}
+}
+
+TEST(SmallVectorTests, ModifierTests) {
+	// Mirror a std::vector through random insertions and erasures
+	std::vector<int> expected;
+	ancillary::small_vector<int, 8> v;
+	std::uniform_int_distribution<int> coin(0, 2);
+	for (int i = 0; i < 20 * N; ++i) {
+		std::uniform_int_distribution<std::size_t> position(0, expected.size());
+		std::size_t pos = position(gen);
+		if (coin(gen) || expected.empty()) {
+			expected.insert(expected.begin() + pos, i);
+			v.insert(v.begin() + pos, i);
+		}
+		else {
+			pos = std::min(pos, expected.size() - 1);
+			expected.erase(expected.begin() + pos);
+			v.erase(v.begin() + pos);
+		}
+		ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+	}
+
+	std::vector<int> range(N);
+	std::iota(range.begin(), range.end(), -N);
+	expected.insert(expected.begin() + 1, range.begin(), range.end());
+	v.insert(v.begin() + 1, range.begin(), range.end());
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+	// Inserting a copy of one of its own elements, with and without reallocation
+	v.shrink_to_fit();
+	v.insert(v.begin(), v.back());
+	expected.insert(expected.begin(), expected.back());
+	v.insert(v.begin(), v.back());
+	expected.insert(expected.begin(), expected.back());
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+	v.erase(v.begin() + 2, v.end() - 2);
+	expected.erase(expected.begin() + 2, expected.end() - 2);
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+	v.resize(6);
+	ASSERT_EQ(6, v.size());
+	ASSERT_EQ(0, v.back());
+	ASSERT_THROW(v.at(6), std::out_of_range);
+}
+
+TEST(SmallVectorTests, SelfReferenceTests) {
+	// Copies of its own elements inserted while the storage moves from inline to the heap
+	auto values = strings(3);
+	vector_t v(values.begin(), values.end());
+	std::vector<std::string> expected(values.begin(), values.end());
+	ASSERT_TRUE(v.is_inline());
+	v.insert(v.begin(), 3, v[0]);
+	expected.insert(expected.begin(), 3, std::string(expected[0]));
+	ASSERT_FALSE(v.is_inline());
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+	const std::size_t count = v.capacity();
+	v.insert(v.begin() + 1, count, v.back());
+	expected.insert(expected.begin() + 1, count, std::string(expected.back()));
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+	v.resize(v.capacity() + 1, v[1]);
+	expected.resize(v.size(), std::string(expected[1]));
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+	v.assign(2 * v.size(), v[2]);
+	expected.assign(v.size(), std::string(expected[2]));
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+}
+
+TEST(SmallVectorTests, SwapTests) {
+	for (int lhs_size : { 0, 3, 10 }) {
+		for (int rhs_size : { 0, 4, 12 }) {
+			auto lhs_values = strings(lhs_size);
+			auto rhs_values = strings(rhs_size);
+			std::reverse(rhs_values.begin(), rhs_values.end());
+			vector_t lhs(lhs_values.begin(), lhs_values.end());
+			vector_t rhs(rhs_values.begin(), rhs_values.end());
+			std::swap(lhs, rhs);
+			ASSERT_TRUE(std::equal(lhs.begin(), lhs.end(), rhs_values.begin(), rhs_values.end()));
+			ASSERT_TRUE(std::equal(rhs.begin(), rhs.end(), lhs_values.begin(), lhs_values.end()));
+		}
+	}
+}
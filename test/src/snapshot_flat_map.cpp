@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/constants.hpp"
+#include <ancillary/container/snapshot_flat_map.hpp>
+
+using map_t = ancillary::snapshot_flat_map<int, int>;
+
+TEST(SnapshotFlatMapTests, SnapshotTests) {
+	map_t map(map_t::map_type{ {1, 10}, {2, 20} });
+	auto before = map.read();
+	ASSERT_EQ(2, before->size());
+
+	map.insert_or_assign(3, 30);
+	ASSERT_EQ(1, map.erase(1));
+	ASSERT_EQ(0, map.erase(1));
+
+	// Older snapshots keep seeing the version they pinned
+	ASSERT_EQ(2, before->size());
+	ASSERT_TRUE(before->contains(1));
+	ASSERT_FALSE(before->contains(3));
+
+	auto after = map.read();
+	ASSERT_EQ((map_t::map_type{ {2, 20}, {3, 30} }), *after);
+
+	map.update([](map_t::map_type& m) {
+		for (int i = 0; i < static_cast<int>(N); ++i)
+			m.insert_or_assign(i, i);
+	});
+	ASSERT_EQ(N, map.read()->size());
+
+	map.assign({});
+	ASSERT_TRUE(map.read()->empty());
+
+	map_t::snapshot moved(std::move(after));
+	ASSERT_FALSE(after);
+	ASSERT_EQ(2, moved->size());
+}
+
+TEST(SnapshotFlatMapTests, ReclamationTests) {
+	map_t map;
+	auto pinned = map.read();
+	for (int i = 0; i < 5; ++i)
+		map.insert_or_assign(i, i);
+	// The pinned reader may still be looking at any of the replaced versions
+	ASSERT_EQ(5, map.retired());
+
+	pinned.release();
+	map.reclaim();
+	ASSERT_EQ(0, map.retired());
+
+	auto reader = map.read();
+	map.insert_or_assign(5, 5);
+	map.insert_or_assign(6, 6);
+	ASSERT_EQ(2, map.retired());
+	reader = map.read();
+	map.insert_or_assign(7, 7);
+	// The reader moved on, so only versions it could have seen are kept
+	ASSERT_EQ(1, map.retired());
+	reader.release();
+	map.reclaim();
+	ASSERT_EQ(0, map.retired());
+}
+
+TEST(SnapshotFlatMapTests, OverflowTests) {
+	// More snapshots than slots are held at once by a single thread, which would
+	// never get a slot back if read() waited for one
+	map_t map(map_t::map_type{ {0, 0} }, 1);
+	std::vector<map_t::snapshot> pinned;
+	for (int i = 1; i <= 4; ++i) {
+		pinned.push_back(map.read());
+		map.insert_or_assign(i, i);
+	}
+	ASSERT_EQ(4, map.retired());
+	for (int i = 0; i < 4; ++i)
+		ASSERT_EQ(static_cast<std::size_t>(i + 1), pinned[i]->size());
+
+	// Released overflow slots are reused and no longer hold back reclamation
+	pinned.erase(pinned.begin() + 1, pinned.end());
+	map.reclaim();
+	ASSERT_EQ(4, map.retired());
+	pinned.clear();
+	auto reader = map.read();
+	auto other = map.read();
+	ASSERT_EQ(5, other->size());
+	map.reclaim();
+	ASSERT_EQ(0, map.retired());
+}
+
+TEST(SnapshotFlatMapTests, ConcurrencyTests) {
+	// Each published version holds the keys [0, n) mapped to twice themselves
+	map_t map(map_t::map_type(), 4);
+	const int batches = 200;
+	std::atomic<bool> done{ false };
+	std::atomic<bool> consistent{ true };
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 6; ++r) {
+		readers.emplace_back([&] {
+			while (!done.load()) {
+				auto snapshot = map.read();
+				int n = static_cast<int>(snapshot->size());
+				if (n != 0 && (!snapshot->contains(n - 1) || snapshot->at(n - 1) != 2 * (n - 1) || snapshot->contains(n)))
+					consistent = false;
+			}
+		});
+	}
+
+	for (int b = 0; b < batches; ++b) {
+		map.update([b](map_t::map_type& m) {
+			for (int i = 0; i < 10; ++i)
+				m.insert_or_assign(10 * b + i, 2 * (10 * b + i));
+		});
+	}
+	done = true;
+	for (auto& reader : readers)
+		reader.join();
+
+	ASSERT_TRUE(consistent);
+	ASSERT_EQ(10 * batches, map.read()->size());
+	map.reclaim();
+	ASSERT_EQ(0, map.retired());
+}
@@ -0,0 +1,258 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include "../include/constants.hpp"
+#include <ancillary/container/flat_map.hpp>
+#include <ancillary/container/split_flat_map.hpp>
+
+using map_t = ancillary::split_flat_map<int, std::string>;
+using flat_map_t = ancillary::flat_map<int, std::string>;
+using pair_t = std::pair<int, std::string>;
+
+// Allocators that compare equal only when they share a tag
+template <class T>
+struct tagged_allocator {
+	using value_type = T;
+	int tag = 0;
+
+	tagged_allocator() = default;
+	explicit tagged_allocator(int tag)
+		: tag(tag) {}
+	template <class U>
+	tagged_allocator(const tagged_allocator<U>& other)
+		: tag(other.tag) {}
+
+	T* allocate(std::size_t n) { return std::allocator<T>().allocate(n); }
+	void deallocate(T* p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+	template <class U>
+	bool operator==(const tagged_allocator<U>& other) const { return tag == other.tag; }
+	template <class U>
+	bool operator!=(const tagged_allocator<U>& other) const { return tag != other.tag; }
+};
+
+// A mapped type whose move may throw, so existing elements are copied during merges
+struct fragile {
+	static inline int copies_left = -1;
+	int value = 0;
+
+	fragile(int value)
+		: value(value) {}
+	fragile(const fragile& other)
+		: value(other.value)
+	{
+		if (copies_left == 0)
+			throw std::runtime_error("Copy failed!");
+		--copies_left;
+	}
+	fragile(fragile&& other) noexcept(false)
+		: value(other.value) {}
+	fragile& operator=(const fragile&) = default;
+	fragile& operator=(fragile&&) noexcept(false) = default;
+
+	bool operator==(const fragile& other) const { return value == other.value; }
+};
+
+std::mt19937 gen{ std::random_device{}() };
+
+std::vector<pair_t> make_pairs(int size) {
+	std::vector<pair_t> pairs(size);
+	std::generate(pairs.begin(), pairs.end(), [n = 0]() mutable {
+		auto key = 2 * n++;
+		return std::make_pair(key, std::to_string(key));
+	});
+	std::shuffle(pairs.begin(), pairs.end(), gen);
+	return pairs;
+}
+
+template <class Map, class Other>
+bool same_elements(const Map& map, const Other& other) {
+	return std::equal(map.begin(), map.end(), other.begin(), other.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.first == rhs.first && lhs.second == rhs.second;
+	});
+}
+
+TEST(SplitFlatMapTests, ConstructorTests) {
+	map_t m1;
+	ASSERT_TRUE(m1.empty());
+	ASSERT_EQ(m1.begin(), m1.end());
+
+	auto pairs = make_pairs(N);
+	map_t m2(pairs.begin(), pairs.end());
+	flat_map_t reference(pairs.begin(), pairs.end());
+	ASSERT_EQ(reference.size(), m2.size());
+	ASSERT_TRUE(same_elements(m2, reference));
+	ASSERT_TRUE(std::is_sorted(m2.keys().begin(), m2.keys().end()));
+
+	map_t m3{ {3, "c"}, {1, "a"}, {2, "b"}, {1, "z"} };
+	ASSERT_EQ(3, m3.size());
+	ASSERT_EQ("a", m3.at(1));
+
+	map_t m4(std::vector<int>{ 2, 1, 2 }, std::vector<std::string>{ "b", "a", "x" });
+	ASSERT_EQ(2, m4.size());
+	ASSERT_EQ("b", m4.at(2));
+
+	map_t m5(ancillary::sorted_unique, { {1, "a"}, {2, "b"}, {3, "c"} });
+	ASSERT_EQ(m3, m5);
+
+	map_t copier(m5);
+	ASSERT_EQ(m5, copier);
+	map_t thief(std::move(copier));
+	ASSERT_EQ(m5, thief);
+}
+
+TEST(SplitFlatMapTests, IteratorTests) {
+	auto pairs = make_pairs(N);
+	map_t map(pairs.begin(), pairs.end());
+	flat_map_t reference(pairs.begin(), pairs.end());
+	ASSERT_EQ(map.size(), static_cast<std::size_t>(map.end() - map.begin()));
+	ASSERT_TRUE(same_elements(map, reference));
+	ASSERT_TRUE(std::equal(map.rbegin(), map.rend(), reference.rbegin(), reference.rend(), [](const auto& lhs, const auto& rhs) {
+		return lhs.first == rhs.first && lhs.second == rhs.second;
+	}));
+
+	for (auto it = map.begin(); it != map.end(); ++it)
+		it->second += "!";
+	for (auto [key, value] : map)
+		ASSERT_EQ(std::to_string(key) + "!", value);
+
+	map_t::const_iterator cit = map.begin();
+	ASSERT_EQ(cit, map.cbegin());
+	ASSERT_EQ(map.begin() + 1, ++cit);
+}
+
+TEST(SplitFlatMapTests, InsertionTests) {
+	map_t map;
+	auto [it, inserted] = map.insert({ 5, "five" });
+	ASSERT_TRUE(inserted);
+	ASSERT_EQ(5, it->first);
+	ASSERT_FALSE(map.insert({ 5, "cinq" }).second);
+	ASSERT_EQ("five", map.at(5));
+
+	ASSERT_TRUE(map.try_emplace(3, 3, 't').second);
+	ASSERT_EQ("ttt", map[3]);
+	ASSERT_FALSE(map.try_emplace(3, "three").second);
+
+	ASSERT_FALSE(map.insert_or_assign(3, "three").second);
+	ASSERT_EQ("three", map.at(3));
+	ASSERT_TRUE(map.insert_or_assign(4, "four").second);
+
+	map[1] = "one";
+	ASSERT_EQ(4, map.size());
+	ASSERT_EQ(map.end(), map.insert(map.end(), { 6, "six" }) + 1);
+	ASSERT_EQ(map.begin(), map.emplace_hint(map.end(), 0, "zero"));
+	ASSERT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+
+	auto pairs = make_pairs(N);
+	map.insert(pairs.begin(), pairs.end());
+	flat_map_t reference{ {5, "five"}, {3, "three"}, {4, "four"}, {1, "one"}, {6, "six"}, {0, "zero"} };
+	reference.insert(pairs.begin(), pairs.end());
+	ASSERT_TRUE(same_elements(map, reference));
+	ASSERT_EQ(map.keys().size(), map.values().size());
+
+	ASSERT_THROW(map.at(-1), std::out_of_range);
+}
+
+TEST(SplitFlatMapTests, ErasureTests) {
+	auto pairs = make_pairs(N);
+	map_t map(pairs.begin(), pairs.end());
+	flat_map_t reference(pairs.begin(), pairs.end());
+	ASSERT_EQ(0, map.erase(1));
+	ASSERT_EQ(1, map.erase(2));
+	reference.erase(2);
+	ASSERT_TRUE(same_elements(map, reference));
+
+	auto it = map.erase(map.begin());
+	ASSERT_EQ(map.begin(), it);
+	reference.erase(reference.begin());
+	it = map.erase(map.begin() + 1, map.begin() + 3);
+	ASSERT_EQ(map.begin() + 1, it);
+	reference.erase(reference.begin() + 1, reference.begin() + 3);
+	ASSERT_TRUE(same_elements(map, reference));
+
+	map.clear();
+	ASSERT_TRUE(map.empty());
+}
+
+TEST(SplitFlatMapTests, LookupTests) {
+	auto pairs = make_pairs(N);
+	map_t map(pairs.begin(), pairs.end());
+	for (int key = -1; key <= 2 * N; ++key) {
+		ASSERT_EQ(key >= 0 && key % 2 == 0 && key < 2 * N, map.contains(key));
+		ASSERT_EQ(map.contains(key), map.count(key));
+		ASSERT_EQ(map.contains(key), map.find(key) != map.end());
+		auto lower = std::lower_bound(map.keys().begin(), map.keys().end(), key) - map.keys().begin();
+		auto upper = std::upper_bound(map.keys().begin(), map.keys().end(), key) - map.keys().begin();
+		ASSERT_EQ(lower, map.lower_bound(key) - map.begin());
+		ASSERT_EQ(upper, map.upper_bound(key) - map.begin());
+		auto [first, last] = map.equal_range(key);
+		ASSERT_EQ(lower, first - map.begin());
+		ASSERT_EQ(upper, last - map.begin());
+	}
+
+	ancillary::split_flat_map<std::string, int, std::less<>> transparent{ {"a", 1}, {"b", 2} };
+	ASSERT_TRUE(transparent.contains("a"));
+	ASSERT_EQ(2, transparent.find("b")->second);
+	ASSERT_FALSE(transparent.contains("c"));
+}
+
+TEST(SplitFlatMapTests, ExtractReplaceTests) {
+	auto pairs = make_pairs(N);
+	map_t map(pairs.begin(), pairs.end());
+	map_t copy(map);
+	auto data = std::move(map).extract();
+	ASSERT_TRUE(map.empty());
+	ASSERT_EQ(copy.keys(), data.keys);
+	ASSERT_EQ(copy.values(), data.values);
+
+	map.replace(std::move(data.keys), std::move(data.values));
+	ASSERT_EQ(copy, map);
+}
+
+TEST(SplitFlatMapTests, MergeAllocatorTests) {
+	using alloc_map_t = ancillary::split_flat_map<int, int, std::less<int>,
+		std::vector<int, tagged_allocator<int>>, std::vector<int, tagged_allocator<int>>>;
+	std::vector<int, tagged_allocator<int>> keys({ 3, 1, 2 }, tagged_allocator<int>(7));
+	std::vector<int, tagged_allocator<int>> values({ 30, 10, 20 }, tagged_allocator<int>(9));
+	alloc_map_t map(std::move(keys), std::move(values));
+	std::vector<std::pair<int, int>> pairs{ {5, 50}, {0, 0}, {2, -1}, {4, 40} };
+	map.insert(pairs.begin(), pairs.end());
+	ASSERT_EQ(7, map.keys().get_allocator().tag);
+	ASSERT_EQ(9, map.values().get_allocator().tag);
+	ASSERT_EQ(std::vector<int>({ 0, 1, 2, 3, 4, 5 }), std::vector<int>(map.keys().begin(), map.keys().end()));
+	ASSERT_EQ(20, map.at(2));
+}
+
+TEST(SplitFlatMapTests, MergeExceptionTests) {
+	ancillary::split_flat_map<int, fragile> map;
+	for (int i = 0; i < static_cast<int>(N); ++i)
+		map.try_emplace(2 * i, i);
+	auto copy = map;
+	std::vector<std::pair<int, fragile>> pairs;
+	for (int i = 0; i < static_cast<int>(N); ++i)
+		pairs.emplace_back(2 * i + 1, -i);
+	// The range is copied into the merge buffer first, then the map's own values fail halfway
+	fragile::copies_left = static_cast<int>(N + N / 2);
+	ASSERT_THROW(map.insert(pairs.begin(), pairs.end()), std::runtime_error);
+	fragile::copies_left = -1;
+	ASSERT_EQ(copy, map);
+	map.insert(pairs.begin(), pairs.end());
+	ASSERT_EQ(2 * N, map.size());
+	ASSERT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+}
+
+TEST(SplitFlatMapTests, SimdSearchTests) {
+	ancillary::split_flat_map<std::uint64_t, std::string> map;
+	for (std::uint64_t i = 0; i < 1000; ++i)
+		map.try_emplace(3 * i, std::to_string(i));
+	for (std::uint64_t key = 0; key < 3000; ++key) {
+		auto lower = std::lower_bound(map.keys().begin(), map.keys().end(), key) - map.keys().begin();
+		ASSERT_EQ(lower, map.lower_bound(key) - map.begin());
+		ASSERT_EQ(key % 3 == 0, map.contains(key));
+	}
+}